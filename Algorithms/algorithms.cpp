@@ -1,3 +1,32 @@
 #include "algorithms.h"
-#include "stack.h"
+#include "mapped_file.h"
 
+bool check_brackets(const std::string& expression) {
+    return check_brackets(expression.data(), expression.size());
+}
+
+bool check_brackets(const char* data, size_t length, BracketScanner scanner) {
+    BracketValidator validator(scanner);
+    validator.feed(data, length);
+    return validator.finish();
+}
+
+BracketCheckResult check_brackets_file(const std::string& path, size_t window) {
+    MappedFile file(path, MappedFile::Access::SEQUENTIAL);
+    size_t granularity = MappedFile::granularity();
+    window = window < granularity ? granularity : window - window % granularity;
+
+    BracketValidator validator;
+    for (uint64_t offset = 0; offset < file.size(); offset += window) {
+        const char* view = file.map(offset, window);
+        size_t length = static_cast<size_t>(
+            file.size() - offset < window ? file.size() - offset : window);
+        if (!validator.feed(view, length)) {
+            break;
+        }
+    }
+    file.unmap();
+
+    validator.finish();
+    return validator.result();
+}
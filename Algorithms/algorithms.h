@@ -1,35 +1,83 @@
 #ifndef ALGORITHMS_H
 #define ALGORITHMS_H
 
+#include <cstddef>
+#include <stdexcept>
 #include <string>
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#include <string_view>
+#define ASD_HAS_STRING_VIEW
+#endif
+#include "bracket_batch.h"
+#include "bracket_index.h"
+#include "bracket_scan.h"
+#include "bracket_validator.h"
+#include "expression.h"
+#include "graph_search.h"
+#include "parallel_bfs.h"
+#include "parallel_brackets.h"
+#include "sliding_window.h"
+#include "sort.h"
+#include "error_policy.h"
 #include "stack.h"
 
 
 bool check_brackets(const std::string& expression);
-bool check_brackets(const std::string& expression) {
-    ArrayStack<char> stack;
 
-    for (char c : expression) {
+// Only bracket positions found by the (vectorized) scanner reach the stack.
+// Throws std::invalid_argument if the requested scanner is not supported.
+bool check_brackets(const char* data, size_t length,
+                    BracketScanner scanner = BracketScanner::AUTO);
+
+// Validates a file through memory-mapped windows of `window` bytes, so memory
+// use does not depend on the file size. Throws std::runtime_error if the
+// file cannot be opened or mapped.
+BracketCheckResult check_brackets_file(const std::string& path,
+                                       size_t window = size_t(16) << 20);
+
+// Constant-expression bracket check for text known at build time:
+//     static_assert(check_brackets_constexpr("{a: [1, (2 + 3)]}"), "unbalanced");
+// Nesting deeper than MAX_DEPTH throws std::length_error, which in a
+// constant expression is a compile error. Needs ASD_CONSTEXPR_ARRAY_STACK
+// for compile-time use; at run time call the scanner overloads above.
+template<size_t MAX_DEPTH>
+constexpr bool check_brackets_constexpr(const char* data, size_t length) {
+    static_assert(MAX_DEPTH > 0, "MAX_DEPTH must be positive");
+    ArrayStack<char, MAX_DEPTH> openers(ZeroFilled{});
+    for (size_t i = 0; i < length; ++i) {
+        char c = data[i];
         if (c == '(' || c == '[' || c == '{') {
-            stack.push(c);
+            if (openers.isFull()) {
+                ASD_THROW(std::length_error("Bracket nesting exceeds MAX_DEPTH"));
+            }
+            openers.push(c);
         }
         else if (c == ')' || c == ']' || c == '}') {
-
-            if (stack.isEmpty()) {
-                return false;
-            }
-
-            char top = stack.pop();
-
-            if ((c == ')' && top != '(') ||
-                (c == ']' && top != '[') ||
-                (c == '}' && top != '{')) {
+            char opener = c == ')' ? '(' : (c == ']' ? '[' : '{');
+            if (openers.isEmpty() || openers.pop() != opener) {
                 return false;
             }
         }
     }
+    return openers.isEmpty();
+}
+
+// A literal or char array, up to its first '\0'; it cannot nest deeper
+// than it is long.
+template<size_t N>
+constexpr bool check_brackets_constexpr(const char (&expression)[N]) {
+    size_t length = 0;
+    while (length < N && expression[length] != '\0') {
+        ++length;
+    }
+    return check_brackets_constexpr<N>(expression, length);
+}
 
-    return stack.isEmpty();
+#if defined(ASD_HAS_STRING_VIEW)
+template<size_t MAX_DEPTH>
+constexpr bool check_brackets_constexpr(std::string_view expression) {
+    return check_brackets_constexpr<MAX_DEPTH>(expression.data(), expression.size());
 }
+#endif
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,32 @@
+#ifndef BITS_H
+#define BITS_H
+
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Word-level bit helpers shared by the bracket scanner, BracketIndex and
+// the bitmap frontier of the parallel BFS.
+
+// bits must not be zero.
+inline unsigned lowest_bit_index(uint64_t bits) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return index;
+#else
+    return static_cast<unsigned>(__builtin_ctzll(bits));
+#endif
+}
+
+inline unsigned bit_count(uint64_t bits) {
+#if defined(_MSC_VER)
+    return static_cast<unsigned>(__popcnt64(bits));
+#else
+    return static_cast<unsigned>(__builtin_popcountll(bits));
+#endif
+}
+
+#endif
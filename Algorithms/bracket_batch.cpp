@@ -0,0 +1,86 @@
+#include "bracket_batch.h"
+#include "packed_stack.h"
+#include "parallel_for.h"
+
+namespace {
+
+const size_t INPUTS_PER_TASK = 4096;
+
+// Walks the bracket positions of a run of inputs, moving to the next input
+// whenever a position passes the current input's end.
+struct BatchStep {
+    const size_t* offsets;
+    BracketCheckResult* results;
+    PackedStack<2>& stack;
+    size_t index;
+    size_t base;
+    bool failed;
+
+    void closeInput() {
+        if (!failed) {
+            results[index].balanced = stack.isEmpty();
+            results[index].error_offset =
+                stack.isEmpty() ? 0 : offsets[index + 1] - offsets[index];
+        }
+        stack.clear();
+        failed = false;
+        ++index;
+    }
+
+    void fail(size_t position) {
+        failed = true;
+        results[index].balanced = false;
+        results[index].error_offset = position - offsets[index];
+    }
+
+    bool operator()(char c, size_t offset) {
+        size_t position = base + offset;
+        while (position >= offsets[index + 1]) {
+            closeInput();
+        }
+        if (failed) {
+            return true;
+        }
+        if (!match_bracket(stack, c)) {
+            fail(position);
+        }
+        return true;
+    }
+};
+
+void check_range(const char* buffer, const size_t* offsets, size_t first, size_t last,
+                 BracketCheckResult* results, PackedStack<2>& stack,
+                 BracketMaskFunction mask) {
+    BatchStep step = { offsets, results, stack, first, offsets[first], false };
+    stack.clear();
+    scan_brackets(buffer + offsets[first], offsets[last] - offsets[first], mask, step);
+    while (step.index < last) {
+        step.closeInput();
+    }
+}
+
+}  // namespace
+
+void check_brackets_batch(const char* buffer, const size_t* offsets, size_t count,
+                          BracketCheckResult* results, unsigned threads) {
+    if (count == 0) {
+        return;
+    }
+    BracketMaskFunction mask = bracket_mask_function(BracketScanner::AUTO);
+    threads = resolve_thread_count(threads);
+
+    if (threads == 1 || count <= INPUTS_PER_TASK) {
+        PackedStack<2> stack;
+        check_range(buffer, offsets, 0, count, results, stack, mask);
+        return;
+    }
+
+    size_t tasks = (count + INPUTS_PER_TASK - 1) / INPUTS_PER_TASK;
+    parallel_for(tasks, threads, [&](size_t task) {
+        // One stack per worker thread, reused by every task it picks up.
+        thread_local PackedStack<2> stack;
+        size_t first = task * INPUTS_PER_TASK;
+        size_t last = first + INPUTS_PER_TASK < count ? first + INPUTS_PER_TASK : count;
+        check_range(buffer, offsets, first, last, results, stack, mask);
+    });
+}
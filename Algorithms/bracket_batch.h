@@ -0,0 +1,17 @@
+#ifndef BRACKET_BATCH_H
+#define BRACKET_BATCH_H
+
+#include <cstddef>
+#include "bracket_validator.h"
+
+// Validates count inputs stored back to back: input i is
+// buffer[offsets[i], offsets[i + 1]), so offsets holds count + 1 entries.
+// results[i].error_offset is relative to the start of input i.
+//
+// The buffer is scanned block by block as one stream and every worker
+// keeps a single bracket stack for all of its inputs. threads = 0 uses
+// all hardware threads.
+void check_brackets_batch(const char* buffer, const size_t* offsets, size_t count,
+                          BracketCheckResult* results, unsigned threads = 1);
+
+#endif
@@ -0,0 +1,216 @@
+#include <stdexcept>
+#include "bracket_index.h"
+#include "bits.h"
+#include "bracket_scan.h"
+#include "error_policy.h"
+
+const size_t BracketIndex::NPOS;
+const uint32_t BracketIndex::NONE;
+
+struct BracketIndex::Builder {
+    const char* text;
+    size_t base;
+    std::vector<size_t>& positions;
+    std::vector<uint32_t>& partner;
+    std::vector<uint32_t>& scope;
+    std::vector<uint32_t>& level;
+    uint32_t top;
+    uint32_t depth;
+    // Opener just outside the scanned range: a closer that would pair with
+    // it means the range does not nest on its own.
+    char guard;
+
+    bool operator()(char c, size_t offset) {
+        if (positions.size() >= NONE) {
+            ASD_THROW(std::length_error("Too many brackets to index"));
+        }
+        uint32_t k = static_cast<uint32_t>(positions.size());
+        positions.push_back(base + offset);
+        partner.push_back(NONE);
+
+        if (is_open_bracket(c)) {
+            top = k;
+            ++depth;
+        }
+        else if (top != NONE && brackets_pair(text[positions[top]], c)) {
+            partner[top] = k;
+            partner[k] = top;
+            top = top == 0 ? NONE : scope[top - 1];
+            --depth;
+        }
+        else if (top == NONE && guard != 0 && brackets_pair(guard, c)) {
+            return false;
+        }
+        scope.push_back(top);
+        level.push_back(depth);
+        return true;
+    }
+};
+
+BracketIndex::BracketIndex() : textLength(0), unmatched(0) {}
+
+BracketIndex::BracketIndex(const char* text, size_t length) : textLength(0), unmatched(0) {
+    build(text, length);
+}
+
+void BracketIndex::build(const char* text, size_t length) {
+    positions.clear();
+    partner.clear();
+    scope.clear();
+    level.clear();
+    textLength = length;
+
+    Builder builder = { text, 0, positions, partner, scope, level, NONE, 0, 0 };
+    scan_brackets(text, length, bracket_mask_function(BracketScanner::AUTO), builder);
+    unmatched = countUnmatched(0, positions.size());
+    rebuildBitmap();
+}
+
+void BracketIndex::rebuildBitmap() {
+    bits.assign((textLength + 63) / 64, 0);
+    for (size_t position : positions) {
+        bits[position / 64] |= uint64_t(1) << (position % 64);
+    }
+    rankBefore.resize(bits.size());
+    uint32_t count = 0;
+    for (size_t i = 0; i < bits.size(); ++i) {
+        rankBefore[i] = count;
+        count += bit_count(bits[i]);
+    }
+}
+
+bool BracketIndex::update(const char* text, size_t length,
+                          size_t editBegin, size_t removed, size_t inserted) {
+    if (editBegin + removed > textLength || length != textLength - removed + inserted) {
+        ASD_THROW(std::invalid_argument("Edit does not match the indexed document"));
+    }
+
+    // Innermost matched pair with its opener before the edit and its closer after it.
+    size_t first = ordinal(editBegin);
+    uint32_t open = first == 0 ? NONE : scope[first - 1];
+    while (open != NONE && (partner[open] == NONE || positions[partner[open]] < editBegin + removed)) {
+        open = scopeBefore(open);
+    }
+    if (open == NONE) {
+        build(text, length);
+        return false;
+    }
+    uint32_t close = partner[open];
+    size_t openPosition = positions[open];
+    size_t closePosition = positions[close] - removed + inserted;
+
+    std::vector<size_t> newPositions;
+    std::vector<uint32_t> newPartner, newScope, newLevel;
+    Builder builder = { text, openPosition + 1, newPositions, newPartner, newScope, newLevel,
+                        NONE, 0, text[openPosition] };
+    BracketMaskFunction mask = bracket_mask_function(BracketScanner::AUTO);
+    if (!scan_brackets(text + openPosition + 1, closePosition - openPosition - 1, mask, builder)
+        || builder.depth != 0) {
+        build(text, length);
+        return false;
+    }
+
+    unmatched -= countUnmatched(open + 1, close);
+    for (uint32_t other : newPartner) {
+        unmatched += other == NONE;
+    }
+
+    int64_t shift = static_cast<int64_t>(newPositions.size()) - (close - open - 1);
+    auto moved = [close, shift](uint32_t k) {
+        return k == NONE || k < close ? k : static_cast<uint32_t>(k + shift);
+    };
+    for (uint32_t k = 0; k <= open; ++k) {
+        partner[k] = moved(partner[k]);
+    }
+    for (size_t k = close; k < positions.size(); ++k) {
+        positions[k] = positions[k] - removed + inserted;
+        partner[k] = moved(partner[k]);
+        scope[k] = moved(scope[k]);
+    }
+
+    uint32_t offset = open + 1;
+    for (size_t j = 0; j < newPositions.size(); ++j) {
+        newPartner[j] = newPartner[j] == NONE ? NONE : newPartner[j] + offset;
+        newScope[j] = newScope[j] == NONE ? open : newScope[j] + offset;
+        newLevel[j] += level[open];
+    }
+
+    positions.erase(positions.begin() + offset, positions.begin() + close);
+    positions.insert(positions.begin() + offset, newPositions.begin(), newPositions.end());
+    partner.erase(partner.begin() + offset, partner.begin() + close);
+    partner.insert(partner.begin() + offset, newPartner.begin(), newPartner.end());
+    scope.erase(scope.begin() + offset, scope.begin() + close);
+    scope.insert(scope.begin() + offset, newScope.begin(), newScope.end());
+    level.erase(level.begin() + offset, level.begin() + close);
+    level.insert(level.begin() + offset, newLevel.begin(), newLevel.end());
+
+    textLength = length;
+    rebuildBitmap();
+    return true;
+}
+
+size_t BracketIndex::ordinal(size_t position) const {
+    if (position >= textLength) {
+        return positions.size();
+    }
+    size_t word = position / 64;
+    uint64_t below = (uint64_t(1) << (position % 64)) - 1;
+    return rankBefore[word] + bit_count(bits[word] & below);
+}
+
+uint32_t BracketIndex::pairStart(uint32_t k) const {
+    return partner[k] != NONE && partner[k] < k ? partner[k] : k;
+}
+
+uint32_t BracketIndex::scopeBefore(uint32_t k) const {
+    return k == 0 ? NONE : scope[k - 1];
+}
+
+size_t BracketIndex::countUnmatched(size_t first, size_t last) const {
+    size_t count = 0;
+    for (size_t k = first; k < last; ++k) {
+        count += partner[k] == NONE;
+    }
+    return count;
+}
+
+bool BracketIndex::balanced() const {
+    return unmatched == 0;
+}
+
+bool BracketIndex::isBracket(size_t position) const {
+    if (position >= textLength) {
+        ASD_THROW(std::out_of_range("Position out of range"));
+    }
+    return (bits[position / 64] >> (position % 64)) & 1;
+}
+
+size_t BracketIndex::match(size_t position) const {
+    if (!isBracket(position)) {
+        return NPOS;
+    }
+    uint32_t other = partner[ordinal(position)];
+    return other == NONE ? NPOS : positions[other];
+}
+
+size_t BracketIndex::depth(size_t position) const {
+    size_t k = ordinal(position);
+    if (isBracket(position)) {
+        k = pairStart(static_cast<uint32_t>(k));
+    }
+    return k == 0 ? 0 : level[k - 1];
+}
+
+BracketIndex::Pair BracketIndex::enclosing(size_t position) const {
+    size_t k = ordinal(position);
+    if (isBracket(position)) {
+        k = pairStart(static_cast<uint32_t>(k));
+    }
+    Pair pair = { NPOS, NPOS };
+    uint32_t open = k == 0 ? NONE : scope[k - 1];
+    if (open != NONE) {
+        pair.open = positions[open];
+        pair.close = partner[open] == NONE ? NPOS : positions[partner[open]];
+    }
+    return pair;
+}
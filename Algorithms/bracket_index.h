@@ -0,0 +1,79 @@
+#ifndef BRACKET_INDEX_H
+#define BRACKET_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Pairs up every bracket of a document in one pass and answers "matching
+// bracket of position i", "nesting depth at i" and "innermost pair around
+// i" in O(1).
+//
+// Arrays are indexed by bracket ordinal (the k-th bracket of the document),
+// not by byte; a bitmap of bracket positions with per-word rank counts maps
+// a byte position to its ordinal. A closer whose kind differs from the
+// innermost open bracket stays unmatched and leaves the nesting unchanged.
+class BracketIndex {
+public:
+    static const size_t NPOS = static_cast<size_t>(-1);
+
+    struct Pair {
+        size_t open;
+        size_t close;   // NPOS if the opener is never closed
+    };
+
+private:
+    static const uint32_t NONE = UINT32_MAX;
+
+    size_t textLength;
+    size_t unmatched;
+    std::vector<uint64_t> bits;
+    std::vector<uint32_t> rankBefore;   // brackets before each bitmap word
+    std::vector<size_t> positions;
+    std::vector<uint32_t> partner;
+    // Innermost open bracket and nesting level right after each bracket.
+    // scope also serves as the build stack: the bracket below opener k
+    // is scope[k - 1].
+    std::vector<uint32_t> scope;
+    std::vector<uint32_t> level;
+
+    struct Builder;
+
+    size_t ordinal(size_t position) const;
+    uint32_t pairStart(uint32_t k) const;
+    uint32_t scopeBefore(uint32_t k) const;
+    size_t countUnmatched(size_t first, size_t last) const;
+    void rebuildBitmap();
+
+public:
+    BracketIndex();
+    BracketIndex(const char* text, size_t length);
+
+    void build(const char* text, size_t length);
+
+    // Re-indexes after text[editBegin, editBegin + removed) of the old
+    // document was replaced by `inserted` bytes; text is the new document.
+    // Only the innermost matched pair that encloses the edit is rescanned.
+    // When no such pair exists, or the edit changes how brackets outside
+    // it pair up, the whole document is rebuilt and false is returned.
+    bool update(const char* text, size_t length,
+                size_t editBegin, size_t removed, size_t inserted);
+
+    size_t length() const { return textLength; }
+    size_t bracketCount() const { return positions.size(); }
+    // True when every bracket has a partner.
+    bool balanced() const;
+
+    // All position queries throw std::out_of_range for position >= length().
+    bool isBracket(size_t position) const;
+    // Position of the partner bracket, NPOS for non-brackets and unmatched ones.
+    size_t match(size_t position) const;
+    // Number of open brackets around position; a bracket counts the brackets
+    // around its own pair.
+    size_t depth(size_t position) const;
+    // Innermost pair strictly enclosing position (for a bracket: enclosing
+    // its pair). {NPOS, NPOS} at top level.
+    Pair enclosing(size_t position) const;
+};
+
+#endif
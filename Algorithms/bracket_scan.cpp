@@ -0,0 +1,120 @@
+#include "bracket_scan.h"
+#include "cpu_features.h"
+
+#if defined(CPU_X86)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+uint64_t mask_scalar(const char* block) {
+    uint64_t bits = 0;
+    for (unsigned i = 0; i < 64; ++i) {
+        bits |= static_cast<uint64_t>(is_bracket(block[i])) << i;
+    }
+    return bits;
+}
+
+#if defined(CPU_X86)
+
+// '(' and ')' differ only in bit 0; '[' and '{' (and ']' and '}') only in
+// bit 5, so three comparisons cover all six brackets.
+uint64_t mask_sse2(const char* block) {
+    const __m128i one = _mm_set1_epi8(0x01);
+    const __m128i notCase = _mm_set1_epi8(static_cast<char>(0xDF));
+    const __m128i round = _mm_set1_epi8(')');
+    const __m128i squareOpen = _mm_set1_epi8('[');
+    const __m128i squareClose = _mm_set1_epi8(']');
+
+    uint64_t bits = 0;
+    for (unsigned i = 0; i < 4; ++i) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16 * i));
+        __m128i folded = _mm_and_si128(v, notCase);
+        __m128i hit = _mm_or_si128(
+            _mm_cmpeq_epi8(_mm_or_si128(v, one), round),
+            _mm_or_si128(_mm_cmpeq_epi8(folded, squareOpen),
+                         _mm_cmpeq_epi8(folded, squareClose)));
+        bits |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(hit))) << (16 * i);
+    }
+    return bits;
+}
+
+CPU_TARGET_AVX2 uint64_t mask_avx2(const char* block) {
+    const __m256i one = _mm256_set1_epi8(0x01);
+    const __m256i notCase = _mm256_set1_epi8(static_cast<char>(0xDF));
+    const __m256i round = _mm256_set1_epi8(')');
+    const __m256i squareOpen = _mm256_set1_epi8('[');
+    const __m256i squareClose = _mm256_set1_epi8(']');
+
+    uint64_t bits = 0;
+    for (unsigned i = 0; i < 2; ++i) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32 * i));
+        __m256i folded = _mm256_and_si256(v, notCase);
+        __m256i hit = _mm256_or_si256(
+            _mm256_cmpeq_epi8(_mm256_or_si256(v, one), round),
+            _mm256_or_si256(_mm256_cmpeq_epi8(folded, squareOpen),
+                            _mm256_cmpeq_epi8(folded, squareClose)));
+        bits |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(hit))) << (32 * i);
+    }
+    return bits;
+}
+
+CPU_TARGET_AVX512BW uint64_t mask_avx512(const char* block) {
+    __m512i v = _mm512_loadu_si512(block);
+    __m512i folded = _mm512_and_si512(v, _mm512_set1_epi8(static_cast<char>(0xDF)));
+    __mmask64 hit =
+        _mm512_cmpeq_epi8_mask(_mm512_or_si512(v, _mm512_set1_epi8(0x01)), _mm512_set1_epi8(')'))
+        | _mm512_cmpeq_epi8_mask(folded, _mm512_set1_epi8('['))
+        | _mm512_cmpeq_epi8_mask(folded, _mm512_set1_epi8(']'));
+    return static_cast<uint64_t>(hit);
+}
+
+#endif
+
+}  // namespace
+
+bool bracket_scanner_supported(BracketScanner scanner) {
+    const CpuFeatures& cpu = cpu_features();
+    switch (scanner) {
+    case BracketScanner::AUTO:
+    case BracketScanner::SCALAR:
+        return true;
+#if defined(CPU_X86)
+    case BracketScanner::SSE2:
+        return cpu.sse2;
+    case BracketScanner::AVX2:
+        return cpu.avx2;
+    case BracketScanner::AVX512:
+        return cpu.avx512bw;
+#endif
+    default:
+        (void)cpu;
+        return false;
+    }
+}
+
+BracketMaskFunction bracket_mask_function(BracketScanner scanner) {
+    if (!bracket_scanner_supported(scanner)) {
+        return nullptr;
+    }
+    switch (scanner) {
+#if defined(CPU_X86)
+    case BracketScanner::SSE2:
+        return mask_sse2;
+    case BracketScanner::AVX2:
+        return mask_avx2;
+    case BracketScanner::AVX512:
+        return mask_avx512;
+    case BracketScanner::AUTO: {
+        static const BracketMaskFunction best =
+            cpu_features().avx512bw ? mask_avx512
+            : cpu_features().avx2 ? mask_avx2
+            : cpu_features().sse2 ? mask_sse2
+            : mask_scalar;
+        return best;
+    }
+#endif
+    default:
+        return mask_scalar;
+    }
+}
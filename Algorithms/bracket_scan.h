@@ -0,0 +1,98 @@
+#ifndef BRACKET_SCAN_H
+#define BRACKET_SCAN_H
+
+#include <cstddef>
+#include <cstdint>
+#include "bits.h"
+
+enum class BracketScanner {
+    AUTO,
+    SCALAR,
+    SSE2,
+    AVX2,
+    AVX512
+};
+
+// Bit i of the result is set when block[i] is one of ()[]{}; block is 64 bytes.
+typedef uint64_t (*BracketMaskFunction)(const char* block);
+
+bool bracket_scanner_supported(BracketScanner scanner);
+
+// AUTO picks the widest kernel the CPU supports. Returns nullptr for an
+// unsupported scanner.
+BracketMaskFunction bracket_mask_function(BracketScanner scanner);
+
+inline bool is_bracket(char c) {
+    return c == '(' || c == ')' || c == '[' || c == ']' || c == '{' || c == '}';
+}
+
+inline bool is_open_bracket(char c) {
+    return c == '(' || c == '[' || c == '{';
+}
+
+// '(' pairs with ')', '[' with ']' and '{' with '}'.
+inline bool brackets_pair(char open, char close) {
+    return (open == '(' && close == ')') || (open == '[' && close == ']')
+        || (open == '{' && close == '}');
+}
+
+// Two-bit kind of a bracket, as the packed bracket stacks store it.
+enum BracketCode : unsigned {
+    ROUND = 0,
+    SQUARE = 1,
+    CURLY = 2
+};
+
+// c must be one of ()[]{}; an opener and its closer share a code.
+inline BracketCode bracket_code(char c) {
+    switch (c) {
+    case '(': case ')': return ROUND;
+    case '[': case ']': return SQUARE;
+    default: return CURLY;
+    }
+}
+
+// One step of the bracket check: pushes an opener's code, pops a closer's
+// opener and compares. False for a closer with no matching opener; other
+// characters are ignored.
+template<typename Stack>
+bool match_bracket(Stack& openers, char c) {
+    switch (c) {
+    case '(': openers.push(ROUND); return true;
+    case '[': openers.push(SQUARE); return true;
+    case '{': openers.push(CURLY); return true;
+    case ')': return !openers.isEmpty() && openers.pop() == ROUND;
+    case ']': return !openers.isEmpty() && openers.pop() == SQUARE;
+    case '}': return !openers.isEmpty() && openers.pop() == CURLY;
+    default: return true;
+    }
+}
+
+// Calls handler(c, offset) for every bracket in data, in order, until the
+// handler returns false. Returns false if the scan was stopped.
+template<typename Handler>
+bool scan_brackets(const char* data, size_t length, BracketMaskFunction mask,
+                   Handler& handler) {
+    size_t offset = 0;
+
+    for (; offset + 64 <= length; offset += 64) {
+        uint64_t bits = mask(data + offset);
+        while (bits != 0) {
+            size_t position = offset + lowest_bit_index(bits);
+            bits &= bits - 1;
+            if (!handler(data[position], position)) {
+                return false;
+            }
+        }
+    }
+
+    for (; offset < length; ++offset) {
+        if (is_bracket(data[offset]) && !handler(data[offset], offset)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+#endif
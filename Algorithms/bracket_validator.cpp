@@ -0,0 +1,62 @@
+#include <stdexcept>
+#include "bracket_validator.h"
+#include "error_policy.h"
+
+struct BracketValidator::Step {
+    PackedStack<2>& stack;
+    size_t failedAt;
+
+    bool operator()(char c, size_t offset) {
+        if (match(c)) {
+            return true;
+        }
+        failedAt = offset;
+        return false;
+    }
+
+    bool match(char c) {
+        return match_bracket(stack, c);
+    }
+};
+
+BracketValidator::BracketValidator(BracketScanner scanner)
+    : mask(bracket_mask_function(scanner)), consumed(0), errorOffset(0), failed(false) {
+    if (mask == nullptr) {
+        ASD_THROW(std::invalid_argument("Bracket scanner is not supported by this CPU"));
+    }
+}
+
+bool BracketValidator::feed(const char* data, size_t length) {
+    if (failed) {
+        return false;
+    }
+
+    Step step = { stack, 0 };
+    if (!scan_brackets(data, length, mask, step)) {
+        failed = true;
+        errorOffset = consumed + step.failedAt;
+        return false;
+    }
+    consumed += length;
+    return true;
+}
+
+bool BracketValidator::finish() {
+    if (!failed && !stack.isEmpty()) {
+        failed = true;
+        errorOffset = consumed;
+    }
+    return !failed;
+}
+
+BracketCheckResult BracketValidator::result() const {
+    BracketCheckResult result = { !failed, errorOffset };
+    return result;
+}
+
+void BracketValidator::reset() {
+    stack.clear();
+    consumed = 0;
+    errorOffset = 0;
+    failed = false;
+}
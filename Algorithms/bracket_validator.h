@@ -0,0 +1,47 @@
+#ifndef BRACKET_VALIDATOR_H
+#define BRACKET_VALIDATOR_H
+
+#include <cstddef>
+#include "bracket_scan.h"
+#include "packed_stack.h"
+
+struct BracketCheckResult {
+    bool balanced;
+    // Byte offset of the first closer that does not match, or the input
+    // length when openers are left unclosed. Zero when balanced.
+    size_t error_offset;
+};
+
+// Incremental check_brackets: the bracket stack survives between feed()
+// calls, so input can arrive in chunks of any size.
+class BracketValidator {
+private:
+    PackedStack<2> stack;
+    BracketMaskFunction mask;
+    size_t consumed;
+    size_t errorOffset;
+    bool failed;
+
+    struct Step;
+
+public:
+    // Throws std::invalid_argument if the scanner is not supported.
+    explicit BracketValidator(BracketScanner scanner = BracketScanner::AUTO);
+
+    // Returns false once an error has been found; later input is ignored.
+    bool feed(const char* data, size_t length);
+
+    // Ends the input: unclosed openers become an error at the current offset.
+    bool finish();
+
+    BracketCheckResult result() const;
+
+    bool hasError() const { return failed; }
+    size_t errorPosition() const { return errorOffset; }
+    size_t bytesConsumed() const { return consumed; }
+    size_t depth() const { return stack.size(); }
+
+    void reset();
+};
+
+#endif
@@ -0,0 +1,243 @@
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include "expression.h"
+#include "algorithms.h"
+#include "queue.h"
+#include "stack.h"
+#include "error_policy.h"
+
+const size_t Expression::BLOCK_SIZE;
+
+namespace {
+
+const size_t MAX_OPERATORS = 256;
+
+// Operator stack entries: binary operators as written, 'n' for unary
+// minus and '(' for any open bracket.
+int precedence(char op) {
+    switch (op) {
+    case '+': case '-': return 1;
+    case '*': case '/': return 2;
+    case 'n': return 3;
+    case '^': return 4;
+    default: return 0;
+    }
+}
+
+Expression::Instruction instruction(Expression::OpCode op, uint32_t variable = 0, double constant = 0) {
+    Expression::Instruction result = { op, variable, constant };
+    return result;
+}
+
+Expression::Instruction operator_instruction(char op) {
+    switch (op) {
+    case '+': return instruction(Expression::OpCode::ADD);
+    case '-': return instruction(Expression::OpCode::SUBTRACT);
+    case '*': return instruction(Expression::OpCode::MULTIPLY);
+    case '/': return instruction(Expression::OpCode::DIVIDE);
+    case '^': return instruction(Expression::OpCode::POWER);
+    default: return instruction(Expression::OpCode::NEGATE);
+    }
+}
+
+void push_operator(ArrayStack<char, MAX_OPERATORS>& operators, char op) {
+    if (operators.isFull()) {
+        ASD_THROW(std::invalid_argument("Expression is nested too deeply"));
+    }
+    operators.push(op);
+}
+
+}  // namespace
+
+Expression::Expression(const std::string& text, const std::vector<std::string>& names)
+    : variables(names.size()), maxDepth(0) {
+    if (!check_brackets(text)) {
+        ASD_THROW(std::invalid_argument("Unbalanced brackets in expression"));
+    }
+
+    ArrayStack<char, MAX_OPERATORS> operators;
+    Queue<Instruction> output;
+    bool expectOperand = true;
+    size_t i = 0;
+
+    while (i < text.size()) {
+        char c = text[i];
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            ++i;
+        }
+        else if (std::isdigit(static_cast<unsigned char>(c)) || c == '.') {
+            if (!expectOperand) {
+                ASD_THROW(std::invalid_argument("Missing operator before number"));
+            }
+            char* end = nullptr;
+            double value = std::strtod(text.c_str() + i, &end);
+            if (end == text.c_str() + i) {
+                ASD_THROW(std::invalid_argument("Malformed number in expression"));
+            }
+            output.push(instruction(OpCode::CONSTANT, 0, value));
+            i = end - text.c_str();
+            expectOperand = false;
+        }
+        else if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+            if (!expectOperand) {
+                ASD_THROW(std::invalid_argument("Missing operator before variable"));
+            }
+            size_t start = i;
+            while (i < text.size() && (std::isalnum(static_cast<unsigned char>(text[i])) || text[i] == '_')) {
+                ++i;
+            }
+            std::string name = text.substr(start, i - start);
+            size_t index = 0;
+            while (index < names.size() && names[index] != name) {
+                ++index;
+            }
+            if (index == names.size()) {
+                ASD_THROW(std::invalid_argument("Unknown variable: " + name));
+            }
+            output.push(instruction(OpCode::VARIABLE, static_cast<uint32_t>(index)));
+            expectOperand = false;
+        }
+        else if (is_open_bracket(c)) {
+            if (!expectOperand) {
+                ASD_THROW(std::invalid_argument("Missing operator before bracket"));
+            }
+            push_operator(operators, '(');
+            ++i;
+        }
+        else if (is_bracket(c)) {
+            if (expectOperand) {
+                ASD_THROW(std::invalid_argument("Empty brackets or missing operand"));
+            }
+            while (operators.top() != '(') {
+                output.push(operator_instruction(operators.pop()));
+            }
+            operators.pop();
+            ++i;
+        }
+        else if (c == '-' && expectOperand) {
+            push_operator(operators, 'n');
+            ++i;
+        }
+        else if (c == '+' || c == '-' || c == '*' || c == '/' || c == '^') {
+            if (expectOperand) {
+                ASD_THROW(std::invalid_argument(std::string("Missing operand before '") + c + "'"));
+            }
+            while (!operators.isEmpty() && operators.top() != '('
+                   && (precedence(operators.top()) > precedence(c)
+                       || (precedence(operators.top()) == precedence(c) && c != '^'))) {
+                output.push(operator_instruction(operators.pop()));
+            }
+            push_operator(operators, c);
+            expectOperand = true;
+            ++i;
+        }
+        else {
+            ASD_THROW(std::invalid_argument(std::string("Unexpected character in expression: ") + c));
+        }
+    }
+
+    if (expectOperand) {
+        ASD_THROW(std::invalid_argument("Expression ends without an operand"));
+    }
+    while (!operators.isEmpty()) {
+        output.push(operator_instruction(operators.pop()));
+    }
+
+    program.reserve(output.size());
+    size_t depth = 0;
+    while (!output.empty()) {
+        const Instruction& next = output.front();
+        if (next.op == OpCode::CONSTANT || next.op == OpCode::VARIABLE) {
+            ++depth;
+        }
+        else if (next.op != OpCode::NEGATE) {
+            --depth;
+        }
+        maxDepth = depth > maxDepth ? depth : maxDepth;
+        program.push_back(next);
+        output.pop();
+    }
+}
+
+double Expression::evaluate(const double* values) const {
+    const size_t LOCAL_DEPTH = 32;
+    double local[LOCAL_DEPTH] = {};
+    std::vector<double> heap;
+    double* stack = local;
+    if (maxDepth > LOCAL_DEPTH) {
+        heap.resize(maxDepth);
+        stack = heap.data();
+    }
+
+    size_t top = 0;
+    for (const Instruction& step : program) {
+        switch (step.op) {
+        case OpCode::CONSTANT: stack[top++] = step.constant; break;
+        case OpCode::VARIABLE: stack[top++] = values[step.variable]; break;
+        case OpCode::ADD: --top; stack[top - 1] += stack[top]; break;
+        case OpCode::SUBTRACT: --top; stack[top - 1] -= stack[top]; break;
+        case OpCode::MULTIPLY: --top; stack[top - 1] *= stack[top]; break;
+        case OpCode::DIVIDE: --top; stack[top - 1] /= stack[top]; break;
+        case OpCode::POWER: --top; stack[top - 1] = std::pow(stack[top - 1], stack[top]); break;
+        case OpCode::NEGATE: stack[top - 1] = -stack[top - 1]; break;
+        }
+    }
+    return stack[0];
+}
+
+void Expression::evaluate(const double* const* columns, size_t rows, double* out) const {
+    std::vector<double> registers(maxDepth * BLOCK_SIZE);
+    auto slot = [&registers](size_t k) { return registers.data() + k * BLOCK_SIZE; };
+
+    for (size_t first = 0; first < rows; first += BLOCK_SIZE) {
+        size_t count = rows - first < BLOCK_SIZE ? rows - first : BLOCK_SIZE;
+        size_t top = 0;
+
+        for (const Instruction& step : program) {
+            if (step.op == OpCode::CONSTANT) {
+                double* r = slot(top++);
+                for (size_t j = 0; j < count; ++j) r[j] = step.constant;
+                continue;
+            }
+            if (step.op == OpCode::VARIABLE) {
+                double* r = slot(top++);
+                const double* column = columns[step.variable] + first;
+                for (size_t j = 0; j < count; ++j) r[j] = column[j];
+                continue;
+            }
+            if (step.op == OpCode::NEGATE) {
+                double* a = slot(top - 1);
+                for (size_t j = 0; j < count; ++j) a[j] = -a[j];
+                continue;
+            }
+
+            --top;
+            double* a = slot(top - 1);
+            const double* b = slot(top);
+            switch (step.op) {
+            case OpCode::ADD:
+                for (size_t j = 0; j < count; ++j) a[j] += b[j];
+                break;
+            case OpCode::SUBTRACT:
+                for (size_t j = 0; j < count; ++j) a[j] -= b[j];
+                break;
+            case OpCode::MULTIPLY:
+                for (size_t j = 0; j < count; ++j) a[j] *= b[j];
+                break;
+            case OpCode::DIVIDE:
+                for (size_t j = 0; j < count; ++j) a[j] /= b[j];
+                break;
+            default:
+                for (size_t j = 0; j < count; ++j) a[j] = std::pow(a[j], b[j]);
+                break;
+            }
+        }
+
+        for (size_t j = 0; j < count; ++j) {
+            out[first + j] = registers[j];
+        }
+    }
+}
@@ -0,0 +1,56 @@
+#ifndef EXPRESSION_H
+#define EXPRESSION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Arithmetic formula compiled once into flat RPN bytecode and evaluated
+// many times. Supports numbers, variables, + - * / ^ (right-associative),
+// unary minus and any of ()[]{} for grouping.
+class Expression {
+public:
+    enum class OpCode : uint8_t {
+        CONSTANT,
+        VARIABLE,
+        ADD,
+        SUBTRACT,
+        MULTIPLY,
+        DIVIDE,
+        POWER,
+        NEGATE
+    };
+
+    struct Instruction {
+        OpCode op;
+        uint32_t variable;
+        double constant;
+    };
+
+    // Rows evaluated together by the batch evaluator.
+    static const size_t BLOCK_SIZE = 256;
+
+private:
+    std::vector<Instruction> program;
+    size_t variables;
+    size_t maxDepth;
+
+public:
+    // variables[i] is bound to values[i] / columns[i] at evaluation time.
+    // Throws std::invalid_argument for malformed input or unknown names.
+    Expression(const std::string& text, const std::vector<std::string>& variables);
+
+    double evaluate(const double* values) const;
+
+    // out[row] = value of the expression with variable i taken from
+    // columns[i][row]. Instructions run over blocks of BLOCK_SIZE rows,
+    // so every step is a simple loop the compiler can vectorize.
+    void evaluate(const double* const* columns, size_t rows, double* out) const;
+
+    const std::vector<Instruction>& code() const { return program; }
+    size_t variableCount() const { return variables; }
+    size_t stackDepth() const { return maxDepth; }
+};
+
+#endif
@@ -0,0 +1,146 @@
+#ifndef GRAPH_SEARCH_H
+#define GRAPH_SEARCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "graph.h"
+#include "queue.h"
+#include "LStack.h"
+#include "error_policy.h"
+
+const uint32_t UNREACHED = UINT32_MAX;
+
+// One bit per vertex.
+class VisitedSet {
+private:
+    std::vector<uint64_t> words;
+
+public:
+    explicit VisitedSet(size_t vertexCount = 0) : words((vertexCount + 63) / 64, 0) {}
+
+    bool contains(uint32_t vertex) const {
+        return (words[vertex / 64] >> (vertex % 64)) & 1;
+    }
+
+    // Marks vertex; returns false if it was already marked.
+    bool insert(uint32_t vertex) {
+        uint64_t bit = uint64_t(1) << (vertex % 64);
+        uint64_t& word = words[vertex / 64];
+        if (word & bit) {
+            return false;
+        }
+        word |= bit;
+        return true;
+    }
+
+    void clear() {
+        words.assign(words.size(), 0);
+    }
+};
+
+// Breadth-first search from source over vertices not yet in `visited`;
+// visit(vertex, distance) is called once per newly reached vertex, in
+// visiting order. Returns the number of vertices visited.
+template<typename Visit>
+size_t breadth_first_search(const Graph& graph, uint32_t source, VisitedSet& visited, Visit visit) {
+    if (source >= graph.vertexCount()) {
+        ASD_THROW(std::out_of_range("Vertex out of range"));
+    }
+    if (!visited.insert(source)) {
+        return 0;
+    }
+
+    Queue<uint32_t> frontier;
+    frontier.push(source);
+    size_t reached = 0;
+    uint32_t distance = 0;
+    // Vertices of the current level still in the queue.
+    size_t levelLeft = 1;
+    while (!frontier.empty()) {
+        uint32_t vertex = frontier.front();
+        frontier.pop();
+        visit(vertex, distance);
+        ++reached;
+        for (uint32_t next : graph.neighbors(vertex)) {
+            if (visited.insert(next)) {
+                frontier.push(next);
+            }
+        }
+        if (--levelLeft == 0) {
+            levelLeft = frontier.size();
+            ++distance;
+        }
+    }
+    return reached;
+}
+
+// Iterative depth-first search in the order a recursive one would take:
+// visit(vertex) is called when a vertex is first entered. Each stack frame
+// remembers how far through its adjacency list the vertex has got.
+template<typename Visit>
+size_t depth_first_search(const Graph& graph, uint32_t source, VisitedSet& visited, Visit visit) {
+    if (source >= graph.vertexCount()) {
+        ASD_THROW(std::out_of_range("Vertex out of range"));
+    }
+    if (!visited.insert(source)) {
+        return 0;
+    }
+
+    struct Frame {
+        const uint32_t* next;
+        const uint32_t* end;
+    };
+
+    Stack<Frame> path;
+    Graph::Neighbors first = graph.neighbors(source);
+    path.push(Frame{ first.begin(), first.end() });
+    visit(source);
+    size_t reached = 1;
+    while (!path.empty()) {
+        Frame& frame = path.top();
+        while (frame.next != frame.end && visited.contains(*frame.next)) {
+            ++frame.next;
+        }
+        if (frame.next == frame.end) {
+            path.pop();
+            continue;
+        }
+        uint32_t vertex = *frame.next++;
+        visited.insert(vertex);
+        visit(vertex);
+        ++reached;
+        Graph::Neighbors around = graph.neighbors(vertex);
+        path.push(Frame{ around.begin(), around.end() });
+    }
+    return reached;
+}
+
+// Vertices reachable from source, in visiting order.
+inline std::vector<uint32_t> bfs_order(const Graph& graph, uint32_t source) {
+    VisitedSet visited(graph.vertexCount());
+    std::vector<uint32_t> order;
+    breadth_first_search(graph, source, visited,
+                         [&order](uint32_t vertex, uint32_t) { order.push_back(vertex); });
+    return order;
+}
+
+// Number of edges on the shortest path from source, UNREACHED if none.
+inline std::vector<uint32_t> bfs_distances(const Graph& graph, uint32_t source) {
+    VisitedSet visited(graph.vertexCount());
+    std::vector<uint32_t> distances(graph.vertexCount(), UNREACHED);
+    breadth_first_search(graph, source, visited,
+                         [&distances](uint32_t vertex, uint32_t distance) { distances[vertex] = distance; });
+    return distances;
+}
+
+inline std::vector<uint32_t> dfs_order(const Graph& graph, uint32_t source) {
+    VisitedSet visited(graph.vertexCount());
+    std::vector<uint32_t> order;
+    depth_first_search(graph, source, visited, [&order](uint32_t vertex) { order.push_back(vertex); });
+    return order;
+}
+
+#endif
@@ -0,0 +1,217 @@
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include "parallel_bfs.h"
+#include "bits.h"
+#include "graph_search.h"
+#include "parallel_for.h"
+#include "error_policy.h"
+
+namespace {
+
+const size_t TOP_DOWN_CHUNK = 1024;    // frontier vertices per task
+const size_t BOTTOM_UP_CHUNK = 64;     // bitmap words per task
+
+// Switching thresholds from Beamer et al., "Direction-Optimizing
+// Breadth-First Search": go bottom-up once the frontier has more than
+// 1/ALPHA of the unexplored edges, back top-down once it holds fewer than
+// 1/BETA of the vertices.
+const uint64_t ALPHA = 14;
+const uint64_t BETA = 24;
+
+struct Level {
+    size_t vertices;
+    uint64_t edges;   // out-edges of the vertices reached
+};
+
+class Search {
+private:
+    const Graph& graph;
+    const Graph& reverse;
+    unsigned threads;
+    size_t words;
+    std::vector<uint32_t>& distances;
+    std::vector<std::atomic<uint64_t>> visited;
+    std::vector<uint64_t> frontierBits;
+    std::vector<uint64_t> nextBits;
+    std::vector<uint32_t> frontier;
+    // One output queue and edge count per top-down task.
+    std::vector<std::vector<uint32_t>> queues;
+    std::vector<Level> levels;
+
+    Level topDown(uint32_t distance);
+    Level bottomUp(uint32_t distance);
+    void listToBitmap();
+    void bitmapToList();
+
+public:
+    Search(const Graph& graph, const Graph& reverse, unsigned threads, std::vector<uint32_t>& distances);
+    void run(uint32_t source);
+};
+
+Search::Search(const Graph& graph, const Graph& reverse, unsigned threads, std::vector<uint32_t>& distances)
+    : graph(graph), reverse(reverse), threads(threads), words((graph.vertexCount() + 63) / 64),
+      distances(distances), visited(words), frontierBits(words), nextBits(words) {
+    for (std::atomic<uint64_t>& word : visited) {
+        word.store(0, std::memory_order_relaxed);
+    }
+    // Bits past the last vertex count as visited so bottom-up never tries them.
+    if (graph.vertexCount() % 64 != 0) {
+        visited[words - 1].store(~uint64_t(0) << (graph.vertexCount() % 64), std::memory_order_relaxed);
+    }
+}
+
+void Search::run(uint32_t source) {
+    size_t n = graph.vertexCount();
+    distances[source] = 0;
+    visited[source / 64].fetch_or(uint64_t(1) << (source % 64), std::memory_order_relaxed);
+    frontier.assign(1, source);
+
+    Level current = { 1, graph.degree(source) };
+    uint64_t unexplored = graph.edgeCount() - current.edges;
+    bool bottom = false;
+    for (uint32_t distance = 1; current.vertices != 0; ++distance) {
+        Level next;
+        if (bottom) {
+            next = bottomUp(distance);
+        }
+        else {
+            next = topDown(distance);
+        }
+        unexplored -= next.edges;
+
+        bool growing = next.vertices > current.vertices;
+        if (!bottom && growing && next.edges > unexplored / ALPHA) {
+            listToBitmap();
+            bottom = true;
+        }
+        else if (bottom && !growing && next.vertices < n / BETA) {
+            bitmapToList();
+            bottom = false;
+        }
+        current = next;
+    }
+}
+
+Level Search::topDown(uint32_t distance) {
+    size_t tasks = (frontier.size() + TOP_DOWN_CHUNK - 1) / TOP_DOWN_CHUNK;
+    if (queues.size() < tasks) {
+        queues.resize(tasks);
+    }
+    levels.assign(tasks, Level{ 0, 0 });
+
+    parallel_for(tasks, threads, [&](size_t task) {
+        std::vector<uint32_t>& out = queues[task];
+        out.clear();
+        uint64_t edges = 0;
+        size_t last = std::min(frontier.size(), (task + 1) * TOP_DOWN_CHUNK);
+        for (size_t i = task * TOP_DOWN_CHUNK; i < last; ++i) {
+            for (uint32_t vertex : graph.neighbors(frontier[i])) {
+                std::atomic<uint64_t>& word = visited[vertex / 64];
+                uint64_t bit = uint64_t(1) << (vertex % 64);
+                // The plain load filters most visited vertices without a locked RMW.
+                if ((word.load(std::memory_order_relaxed) & bit)
+                    || (word.fetch_or(bit, std::memory_order_relaxed) & bit)) {
+                    continue;
+                }
+                distances[vertex] = distance;
+                edges += graph.degree(vertex);
+                out.push_back(vertex);
+            }
+        }
+        levels[task] = Level{ out.size(), edges };
+    });
+
+    Level total = { 0, 0 };
+    for (const Level& level : levels) {
+        total.vertices += level.vertices;
+        total.edges += level.edges;
+    }
+    frontier.clear();
+    frontier.reserve(total.vertices);
+    for (size_t task = 0; task < tasks; ++task) {
+        frontier.insert(frontier.end(), queues[task].begin(), queues[task].end());
+    }
+    return total;
+}
+
+Level Search::bottomUp(uint32_t distance) {
+    size_t tasks = (words + BOTTOM_UP_CHUNK - 1) / BOTTOM_UP_CHUNK;
+    levels.assign(tasks, Level{ 0, 0 });
+
+    // Each task owns whole bitmap words, so visited only needs plain
+    // loads and stores here.
+    parallel_for(tasks, threads, [&](size_t task) {
+        Level found = { 0, 0 };
+        size_t last = std::min(words, (task + 1) * BOTTOM_UP_CHUNK);
+        for (size_t w = task * BOTTOM_UP_CHUNK; w < last; ++w) {
+            uint64_t seen = visited[w].load(std::memory_order_relaxed);
+            uint64_t todo = ~seen;
+            uint64_t reached = 0;
+            while (todo != 0) {
+                unsigned b = lowest_bit_index(todo);
+                todo &= todo - 1;
+                uint32_t vertex = static_cast<uint32_t>(w * 64 + b);
+                for (uint32_t parent : reverse.neighbors(vertex)) {
+                    if ((frontierBits[parent / 64] >> (parent % 64)) & 1) {
+                        distances[vertex] = distance;
+                        reached |= uint64_t(1) << b;
+                        found.edges += graph.degree(vertex);
+                        break;
+                    }
+                }
+            }
+            nextBits[w] = reached;
+            visited[w].store(seen | reached, std::memory_order_relaxed);
+            found.vertices += bit_count(reached);
+        }
+        levels[task] = found;
+    });
+
+    frontierBits.swap(nextBits);
+    Level total = { 0, 0 };
+    for (const Level& level : levels) {
+        total.vertices += level.vertices;
+        total.edges += level.edges;
+    }
+    return total;
+}
+
+void Search::listToBitmap() {
+    frontierBits.assign(words, 0);
+    for (uint32_t vertex : frontier) {
+        frontierBits[vertex / 64] |= uint64_t(1) << (vertex % 64);
+    }
+}
+
+void Search::bitmapToList() {
+    frontier.clear();
+    for (size_t w = 0; w < words; ++w) {
+        for (uint64_t bits = frontierBits[w]; bits != 0; bits &= bits - 1) {
+            frontier.push_back(static_cast<uint32_t>(w * 64 + lowest_bit_index(bits)));
+        }
+    }
+}
+
+}  // namespace
+
+std::vector<uint32_t> bfs_distances_parallel(const Graph& graph, const Graph& reverse,
+                                             uint32_t source, unsigned threads) {
+    if (reverse.vertexCount() != graph.vertexCount() || reverse.edgeCount() != graph.edgeCount()) {
+        ASD_THROW(std::invalid_argument("Reverse graph does not match the graph"));
+    }
+    if (source >= graph.vertexCount()) {
+        ASD_THROW(std::out_of_range("Vertex out of range"));
+    }
+    std::vector<uint32_t> distances(graph.vertexCount(), UNREACHED);
+    Search search(graph, reverse, resolve_thread_count(threads), distances);
+    search.run(source);
+    return distances;
+}
+
+std::vector<uint32_t> bfs_distances_parallel(const Graph& graph, uint32_t source, unsigned threads) {
+    if (source >= graph.vertexCount()) {
+        ASD_THROW(std::out_of_range("Vertex out of range"));
+    }
+    return bfs_distances_parallel(graph, graph.transpose(), source, threads);
+}
@@ -0,0 +1,25 @@
+#ifndef PARALLEL_BFS_H
+#define PARALLEL_BFS_H
+
+#include <cstdint>
+#include <vector>
+#include "graph.h"
+
+// Direction-optimizing breadth-first search. Levels start top-down: the
+// frontier is a list split across threads, and each thread claims newly
+// reached vertices with an atomic OR on the visited bitmap. Once the
+// frontier's edges outweigh those left to explore it turns bottom-up:
+// every unvisited vertex looks for a parent in the frontier bitmap through
+// `reverse`, stopping at the first one found. It goes back top-down when
+// the frontier shrinks again.
+//
+// reverse must be graph.transpose() (or graph itself when every edge has
+// its reverse). Returns the same distances as bfs_distances.
+std::vector<uint32_t> bfs_distances_parallel(const Graph& graph, const Graph& reverse,
+                                             uint32_t source, unsigned threads = 0);
+
+// Builds the transpose first; pass it in when searching repeatedly.
+std::vector<uint32_t> bfs_distances_parallel(const Graph& graph, uint32_t source,
+                                             unsigned threads = 0);
+
+#endif
@@ -0,0 +1,125 @@
+#include "parallel_brackets.h"
+#include "parallel_for.h"
+#include "error_policy.h"
+
+#include <stdexcept>
+
+namespace {
+
+const size_t MIN_CHUNK = size_t(1) << 20;
+
+struct Summarizer {
+    BracketSummary& summary;
+    size_t base;
+
+    bool operator()(char c, size_t offset) {
+        if (is_open_bracket(c)) {
+            summary.openers.push(bracket_code(c));
+            return true;
+        }
+        return !is_bracket(c) || close(bracket_code(c), offset);
+    }
+
+    bool close(unsigned kind, size_t offset) {
+        if (summary.openers.isEmpty()) {
+            summary.closers.push_back((static_cast<uint64_t>(base + offset) << 2) | kind);
+            return true;
+        }
+        if (summary.openers.pop() != kind) {
+            summary.failed = true;
+            summary.errorOffset = base + offset;
+            return false;
+        }
+        return true;
+    }
+};
+
+}  // namespace
+
+BracketSummary summarize_brackets(const char* data, size_t length, size_t base,
+                                  BracketScanner scanner) {
+    BracketMaskFunction mask = bracket_mask_function(scanner);
+    if (mask == nullptr) {
+        ASD_THROW(std::invalid_argument("Bracket scanner is not supported by this CPU"));
+    }
+
+    BracketSummary summary;
+    Summarizer summarizer = { summary, base };
+    scan_brackets(data, length, mask, summarizer);
+    return summary;
+}
+
+void combine_brackets(BracketSummary& left, const BracketSummary& right) {
+    if (left.failed) {
+        return;
+    }
+
+    size_t i = 0;
+    for (; i < right.closers.size() && !left.openers.isEmpty(); ++i) {
+        if (left.openers.pop() != (right.closers[i] & 3)) {
+            left.failed = true;
+            left.errorOffset = static_cast<size_t>(right.closers[i] >> 2);
+            return;
+        }
+    }
+    left.closers.insert(left.closers.end(), right.closers.begin() + i, right.closers.end());
+
+    if (right.failed) {
+        left.failed = true;
+        left.errorOffset = right.errorOffset;
+        return;
+    }
+    left.openers.append(right.openers);
+}
+
+BracketCheckResult finish_brackets(const BracketSummary& summary, size_t length) {
+    BracketCheckResult result = { true, 0 };
+    if (!summary.closers.empty()) {
+        result.balanced = false;
+        result.error_offset = static_cast<size_t>(summary.closers.front() >> 2);
+    }
+    else if (summary.failed) {
+        result.balanced = false;
+        result.error_offset = summary.errorOffset;
+    }
+    else if (!summary.openers.isEmpty()) {
+        result.balanced = false;
+        result.error_offset = length;
+    }
+    return result;
+}
+
+BracketCheckResult check_brackets_parallel(const char* data, size_t length, unsigned threads) {
+    threads = resolve_thread_count(threads);
+    size_t chunkSize = length / (size_t(threads) * 4) + 1;
+    if (chunkSize < MIN_CHUNK) {
+        chunkSize = MIN_CHUNK;
+    }
+    size_t chunks = (length + chunkSize - 1) / chunkSize;
+
+    if (threads == 1 || chunks <= 1) {
+        BracketValidator validator;
+        validator.feed(data, length);
+        validator.finish();
+        return validator.result();
+    }
+
+    std::vector<BracketSummary> summaries(chunks);
+    parallel_for(chunks, threads, [&](size_t i) {
+        size_t begin = i * chunkSize;
+        size_t end = begin + chunkSize < length ? begin + chunkSize : length;
+        summaries[i] = summarize_brackets(data + begin, end - begin, begin);
+    });
+
+    for (size_t stride = 1; stride < chunks; stride *= 2) {
+        size_t pairs = (chunks + 2 * stride - 1) / (2 * stride);
+        parallel_for(pairs, threads, [&](size_t pair) {
+            size_t left = pair * 2 * stride;
+            if (left + stride < chunks) {
+                combine_brackets(summaries[left], summaries[left + stride]);
+            }
+        });
+    }
+
+    return finish_brackets(summaries[0], length);
+}
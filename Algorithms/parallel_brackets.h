@@ -0,0 +1,39 @@
+#ifndef PARALLEL_BRACKETS_H
+#define PARALLEL_BRACKETS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "bracket_validator.h"
+#include "packed_stack.h"
+
+// What a chunk of input leaves behind once its own pairs are matched:
+// closers that found no opener inside the chunk, then the still-open
+// brackets. Summaries of adjacent chunks combine associatively.
+struct BracketSummary {
+    // (offset << 2) | kind of every unmatched closer, in input order.
+    std::vector<uint64_t> closers;
+    PackedStack<2> openers;
+    // A closer that met an opener of another kind inside the chunk.
+    bool failed;
+    size_t errorOffset;
+
+    BracketSummary() : failed(false), errorOffset(0) {}
+};
+
+// base is the offset of data[0] within the whole input.
+BracketSummary summarize_brackets(const char* data, size_t length, size_t base,
+                                  BracketScanner scanner = BracketScanner::AUTO);
+
+// left becomes the summary of left followed by right.
+void combine_brackets(BracketSummary& left, const BracketSummary& right);
+
+BracketCheckResult finish_brackets(const BracketSummary& summary, size_t length);
+
+// Summarizes chunks on `threads` threads (0 = all hardware threads) and
+// combines the summaries pairwise in a tree. The error offset matches the
+// one BracketValidator reports for the same input.
+BracketCheckResult check_brackets_parallel(const char* data, size_t length,
+                                           unsigned threads = 0);
+
+#endif
@@ -0,0 +1,109 @@
+#ifndef SLIDING_WINDOW_H
+#define SLIDING_WINDOW_H
+
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include "queue.h"
+#include "error_policy.h"
+
+// Streaming extreme of the last `window` samples. The deque keeps samples
+// whose value is still "better" than everything pushed after them, so its
+// front is the answer; every sample enters and leaves it once, which
+// makes push() amortized O(1).
+template<typename T, typename Better = std::less<T>>
+class MonotonicWindow {
+private:
+    struct Entry {
+        T value;
+        size_t index;
+    };
+
+    Queue<Entry> deque;
+    size_t window;
+    size_t pushed;
+    Better better;
+
+public:
+    explicit MonotonicWindow(size_t window, Better better = Better())
+        : window(window), pushed(0), better(better) {
+        if (window == 0) {
+            ASD_THROW(std::invalid_argument("Window size must be positive"));
+        }
+    }
+
+    void push(const T& value) {
+        while (!deque.empty() && !better(deque.back().value, value)) {
+            deque.pop_back();
+        }
+        Entry entry = { value, pushed++ };
+        deque.push(entry);
+        if (deque.front().index + window < pushed) {
+            deque.pop();
+        }
+    }
+
+    // Extreme of the samples currently in the window.
+    const T& value() const {
+        if (deque.empty()) {
+            ASD_THROW(std::runtime_error("Window is empty"));
+        }
+        return deque.front().value;
+    }
+
+    bool full() const { return pushed >= window; }
+    size_t size() const { return pushed < window ? pushed : window; }
+    size_t windowSize() const { return window; }
+    size_t samples() const { return pushed; }
+
+    void clear() {
+        deque.clear();
+        pushed = 0;
+    }
+};
+
+template<typename T>
+using SlidingWindowMin = MonotonicWindow<T, std::less<T>>;
+
+template<typename T>
+using SlidingWindowMax = MonotonicWindow<T, std::greater<T>>;
+
+// out[i] = extreme of data[i, i + k) for every full window; returns the
+// number of values written, n - k + 1 (or 0 when k > n). O(n) overall.
+template<typename T, typename Better>
+size_t sliding_window_extreme(const T* data, size_t n, size_t k, T* out, Better better) {
+    if (k == 0) {
+        ASD_THROW(std::invalid_argument("Window size must be positive"));
+    }
+    if (k > n) {
+        return 0;
+    }
+
+    Queue<size_t> deque;
+    for (size_t i = 0; i < n; ++i) {
+        while (!deque.empty() && !better(data[deque.back()], data[i])) {
+            deque.pop_back();
+        }
+        deque.push(i);
+        if (deque.front() + k <= i) {
+            deque.pop();
+        }
+        if (i + 1 >= k) {
+            out[i + 1 - k] = data[deque.front()];
+        }
+    }
+    return n - k + 1;
+}
+
+template<typename T>
+size_t sliding_window_min(const T* data, size_t n, size_t k, T* out) {
+    return sliding_window_extreme(data, n, k, out, std::less<T>());
+}
+
+template<typename T>
+size_t sliding_window_max(const T* data, size_t n, size_t k, T* out) {
+    return sliding_window_extreme(data, n, k, out, std::greater<T>());
+}
+
+#endif
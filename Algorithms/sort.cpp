@@ -0,0 +1,141 @@
+#include <cstring>
+#include <type_traits>
+#include "sort.h"
+
+namespace {
+
+// Signed keys sort as unsigned ones once the sign bit is flipped.
+template<typename T>
+void lsd_radix_sort(T* data, size_t n) {
+    typedef typename std::make_unsigned<T>::type Key;
+    const size_t BYTES = sizeof(T);
+    const Key FLIP = std::is_signed<T>::value ? Key(1) << (8 * BYTES - 1) : 0;
+    if (n <= INSERTION_SORT_CUTOFF) {
+        insertion_sort(data, data + n, std::less<T>());
+        return;
+    }
+
+    // All histograms in one read pass.
+    std::vector<size_t> counts(BYTES * 256, 0);
+    for (size_t i = 0; i < n; ++i) {
+        Key key = static_cast<Key>(data[i]) ^ FLIP;
+        for (size_t b = 0; b < BYTES; ++b) {
+            ++counts[b * 256 + ((key >> (8 * b)) & 0xFF)];
+        }
+    }
+
+    std::vector<T> buffer(n);
+    T* from = data;
+    T* to = buffer.data();
+    for (size_t b = 0; b < BYTES; ++b) {
+        size_t* count = counts.data() + b * 256;
+        Key firstDigit = ((static_cast<Key>(data[0]) ^ FLIP) >> (8 * b)) & 0xFF;
+        if (count[firstDigit] == n) {
+            continue;
+        }
+        size_t offset = 0;
+        for (size_t d = 0; d < 256; ++d) {
+            size_t c = count[d];
+            count[d] = offset;
+            offset += c;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            Key key = static_cast<Key>(from[i]) ^ FLIP;
+            to[count[(key >> (8 * b)) & 0xFF]++] = from[i];
+        }
+        std::swap(from, to);
+    }
+    if (from != data) {
+        std::memcpy(data, from, n * sizeof(T));
+    }
+}
+
+const size_t STRING_BUCKET_CUTOFF = 32;
+
+// Byte at depth, shifted up by one so that "string ended" sorts first.
+inline size_t string_digit(const std::string& s, size_t depth) {
+    return depth < s.size() ? static_cast<unsigned char>(s[depth]) + 1 : 0;
+}
+
+struct SuffixLess {
+    size_t depth;
+    bool operator()(const std::string& a, const std::string& b) const {
+        return a.compare(depth, std::string::npos, b, depth, std::string::npos) < 0;
+    }
+};
+
+struct StringRange {
+    std::string* first;
+    size_t n;
+    size_t depth;
+};
+
+}  // namespace
+
+void radix_sort(uint32_t* data, size_t n) {
+    lsd_radix_sort(data, n);
+}
+
+void radix_sort(uint64_t* data, size_t n) {
+    lsd_radix_sort(data, n);
+}
+
+void radix_sort(int32_t* data, size_t n) {
+    lsd_radix_sort(data, n);
+}
+
+void radix_sort(int64_t* data, size_t n) {
+    lsd_radix_sort(data, n);
+}
+
+void radix_sort(std::string* data, size_t n) {
+    // Explicit work list: keys with long common prefixes would otherwise
+    // recurse once per shared byte.
+    std::vector<StringRange> work;
+    work.push_back(StringRange{ data, n, 0 });
+    size_t count[257];
+    size_t next[257];
+
+    while (!work.empty()) {
+        StringRange range = work.back();
+        work.pop_back();
+        if (range.n <= STRING_BUCKET_CUTOFF) {
+            insertion_sort(range.first, range.first + range.n, SuffixLess{ range.depth });
+            continue;
+        }
+
+        std::fill(count, count + 257, 0);
+        for (size_t i = 0; i < range.n; ++i) {
+            ++count[string_digit(range.first[i], range.depth)];
+        }
+        size_t offset = 0;
+        for (size_t d = 0; d < 257; ++d) {
+            next[d] = offset;
+            offset += count[d];
+        }
+
+        // American flag sort: swap every element into its bucket in place.
+        size_t end = 0;
+        for (size_t d = 0; d < 257; ++d) {
+            end += count[d];
+            while (next[d] < end) {
+                size_t digit = string_digit(range.first[next[d]], range.depth);
+                if (digit == d) {
+                    ++next[d];
+                }
+                else {
+                    range.first[next[d]].swap(range.first[next[digit]++]);
+                }
+            }
+        }
+
+        // Bucket 0 holds strings that ended here: already in place.
+        size_t begin = count[0];
+        for (size_t d = 1; d < 257; ++d) {
+            if (count[d] > 1) {
+                work.push_back(StringRange{ range.first + begin, count[d], range.depth + 1 });
+            }
+            begin += count[d];
+        }
+    }
+}
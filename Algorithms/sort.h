@@ -0,0 +1,207 @@
+#ifndef SORT_H
+#define SORT_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+#include "parallel_for.h"
+
+// Ranges shorter than this are finished with insertion sort.
+const size_t INSERTION_SORT_CUTOFF = 16;
+
+template<typename T, typename Compare>
+void insertion_sort(T* first, T* last, Compare less) {
+    for (T* i = first + (first != last); i < last; ++i) {
+        T value = std::move(*i);
+        T* j = i;
+        for (; j != first && less(value, *(j - 1)); --j) {
+            *j = std::move(*(j - 1));
+        }
+        *j = std::move(value);
+    }
+}
+
+namespace sort_detail {
+
+template<typename T, typename Compare>
+void sort3(T& a, T& b, T& c, Compare less) {
+    using std::swap;
+    if (less(b, a)) swap(a, b);
+    if (less(c, b)) swap(b, c);
+    if (less(b, a)) swap(a, b);
+}
+
+// Median of first, middle and last ends up in *first; the other two
+// bound the scan so neither loop needs an index check.
+template<typename T, typename Compare>
+T* partition(T* first, T* last, Compare less) {
+    using std::swap;
+    T* middle = first + (last - first) / 2;
+    sort3(*(first + 1), *middle, *(last - 1), less);
+    swap(*first, *middle);
+    T* i = first + 1;
+    T* j = last - 1;
+    while (true) {
+        do ++i; while (less(*i, *first));
+        do --j; while (less(*first, *j));
+        if (i >= j) break;
+        swap(*i, *j);
+    }
+    swap(*first, *j);
+    return j;
+}
+
+template<typename T, typename Compare>
+void intro_sort_loop(T* first, T* last, size_t depthLimit, Compare less) {
+    while (static_cast<size_t>(last - first) > INSERTION_SORT_CUTOFF) {
+        if (depthLimit == 0) {
+            std::make_heap(first, last, less);
+            std::sort_heap(first, last, less);
+            return;
+        }
+        --depthLimit;
+        T* pivot = partition(first, last, less);
+        // Recurse into the smaller side so the stack stays O(log n).
+        if (pivot - first < last - pivot) {
+            intro_sort_loop(first, pivot, depthLimit, less);
+            first = pivot + 1;
+        }
+        else {
+            intro_sort_loop(pivot + 1, last, depthLimit, less);
+            last = pivot;
+        }
+    }
+}
+
+}  // namespace sort_detail
+
+// Quicksort with median-of-three pivots that falls back to heapsort after
+// 2 * log2(n) levels, so the worst case stays O(n log n). Not stable.
+template<typename T, typename Compare = std::less<T>>
+void intro_sort(T* first, T* last, Compare less = Compare()) {
+    size_t depthLimit = 0;
+    for (size_t n = static_cast<size_t>(last - first); n > 1; n >>= 1) {
+        depthLimit += 2;
+    }
+    sort_detail::intro_sort_loop(first, last, depthLimit, less);
+    insertion_sort(first, last, less);
+}
+
+// LSD radix sort, one byte per pass; passes where every key has the same
+// byte are skipped. Needs a buffer of n keys.
+void radix_sort(uint32_t* data, size_t n);
+void radix_sort(uint64_t* data, size_t n);
+void radix_sort(int32_t* data, size_t n);
+void radix_sort(int64_t* data, size_t n);
+
+// MSD radix sort on bytes (as unsigned char), in place. Buckets are
+// split by American flag sort; small ones are insertion-sorted on the
+// remaining suffix.
+void radix_sort(std::string* data, size_t n);
+
+namespace sort_detail {
+
+// Number of elements of a that go before b[j] when merging a and b
+// stably, given that k elements of the output come before the split.
+template<typename T, typename Compare>
+size_t merge_split(const T* a, size_t m, const T* b, size_t n, size_t k, Compare less) {
+    size_t low = k > n ? k - n : 0;
+    size_t high = k < m ? k : m;
+    while (low < high) {
+        size_t i = low + (high - low) / 2;
+        // Taking i + 1 from a is right if a[i] does not go after b[k - i - 1].
+        if (!less(b[k - i - 1], a[i])) {
+            low = i + 1;
+        }
+        else {
+            high = i;
+        }
+    }
+    return low;
+}
+
+}  // namespace sort_detail
+
+// Sorts one chunk per thread with intro_sort, then merges runs pairwise.
+// Every merge round is split into equal parts of the output, so all
+// threads stay busy even when only one pair is left. Not stable; needs a
+// buffer of n elements.
+template<typename T, typename Compare = std::less<T>>
+void parallel_merge_sort(T* first, T* last, unsigned threads = 0, Compare less = Compare()) {
+    const size_t MIN_CHUNK = 1 << 14;
+    size_t n = static_cast<size_t>(last - first);
+    threads = resolve_thread_count(threads);
+    size_t runs = std::max<size_t>(1, std::min<size_t>(threads, n / MIN_CHUNK));
+    if (runs == 1) {
+        intro_sort(first, last, less);
+        return;
+    }
+
+    std::vector<size_t> bounds(runs + 1);
+    for (size_t r = 0; r <= runs; ++r) {
+        bounds[r] = n * r / runs;
+    }
+    parallel_for(runs, threads, [&](size_t r) {
+        intro_sort(first + bounds[r], first + bounds[r + 1], less);
+    });
+
+    std::vector<T> buffer(n);
+    T* from = first;
+    T* to = buffer.data();
+    while (runs > 1) {
+        size_t pairs = runs / 2;
+        size_t parts = std::max<size_t>(1, threads / pairs);
+        // Split points are found before anything moves: a merge task must
+        // not compare elements a neighbouring task has already moved out.
+        std::vector<size_t> splits(pairs * (parts + 1));
+        for (size_t pair = 0; pair < pairs; ++pair) {
+            size_t begin = bounds[2 * pair];
+            size_t middle = bounds[2 * pair + 1];
+            size_t total = bounds[2 * pair + 2] - begin;
+            for (size_t part = 0; part <= parts; ++part) {
+                splits[pair * (parts + 1) + part] = sort_detail::merge_split(
+                    from + begin, middle - begin, from + middle, total - (middle - begin),
+                    total * part / parts, less);
+            }
+        }
+
+        parallel_for(pairs * parts + (runs % 2), threads, [&](size_t task) {
+            if (task == pairs * parts) {
+                // Odd run out: carried over unchanged.
+                std::move(from + bounds[runs - 1], from + n, to + bounds[runs - 1]);
+                return;
+            }
+            size_t pair = task / parts;
+            size_t part = task % parts;
+            size_t begin = bounds[2 * pair];
+            size_t middle = bounds[2 * pair + 1];
+            size_t total = bounds[2 * pair + 2] - begin;
+            size_t lo = total * part / parts;
+            size_t hi = total * (part + 1) / parts;
+            size_t i0 = splits[pair * (parts + 1) + part];
+            size_t i1 = splits[pair * (parts + 1) + part + 1];
+            std::merge(std::make_move_iterator(from + begin + i0), std::make_move_iterator(from + begin + i1),
+                       std::make_move_iterator(from + middle + (lo - i0)),
+                       std::make_move_iterator(from + middle + (hi - i1)),
+                       to + begin + lo, less);
+        });
+
+        std::vector<size_t> merged;
+        for (size_t r = 0; r < runs; r += 2) {
+            merged.push_back(bounds[r]);
+        }
+        merged.push_back(n);
+        bounds.swap(merged);
+        runs = bounds.size() - 1;
+        std::swap(from, to);
+    }
+    if (from != first) {
+        std::move(from, from + n, first);
+    }
+}
+
+#endif
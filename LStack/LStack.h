@@ -1,17 +1,26 @@
 #pragma once
 
 #include "list.h"
+#include "error_policy.h"
+#include <cassert>
+#include <memory>
 #include <stdexcept>
 #include <initializer_list>
+#include <ostream>
+#include <type_traits>
 
-template<typename T>
+template<typename T, typename Allocator = std::allocator<T>>
 class Stack {
 private:
-    List<T> list;
+    List<T, Allocator> list;
 
 public:
+    typedef Allocator allocator_type;
+
     Stack() = default;
 
+    explicit Stack(const Allocator& allocator) : list(allocator) {}
+
     Stack(std::initializer_list<T> initList) {
         for (const auto& item : initList) {
             push(item);
@@ -29,7 +38,7 @@ public:
         return *this;
     }
 
-    Stack& operator=(Stack&& other) noexcept {
+    Stack& operator=(Stack&& other) noexcept(std::is_nothrow_move_assignable<List<T, Allocator>>::value) {
         if (this != &other) {
             list = std::move(other.list);
         }
@@ -46,21 +55,42 @@ public:
 
     void pop() {
         if (empty()) {
-            throw std::underflow_error("Stack underflow");
+            ASD_THROW(std::underflow_error("Stack underflow"));
         }
-        list.pop_back();
+        list.pop_back_unchecked();
+    }
+
+    // Non-throwing variants, as on ArrayStack. try_push always succeeds;
+    // try_pop moves the top into out.
+    bool try_push(const T& value) {
+        list.push_back(value);
+        return true;
+    }
+
+    bool try_push(T&& value) {
+        list.push_back(std::move(value));
+        return true;
+    }
+
+    bool try_pop(T& out) {
+        return list.try_pop_back(out);
+    }
+
+    void pop_unchecked() {
+        assert(!empty() && "pop_unchecked on an empty stack");
+        list.pop_back_unchecked();
     }
 
     T& top() {
         if (empty()) {
-            throw std::underflow_error("Stack is empty");
+            ASD_THROW(std::underflow_error("Stack is empty"));
         }
         return list.back();
     }
 
     const T& top() const {
         if (empty()) {
-            throw std::underflow_error("Stack is empty");
+            ASD_THROW(std::underflow_error("Stack is empty"));
         }
         return list.back();
     }
@@ -86,8 +116,8 @@ public:
             return false;
         }
 
-        Stack<T> temp1 = *this;
-        Stack<T> temp2 = other;
+        Stack temp1 = *this;
+        Stack temp2 = other;
 
         while (!temp1.empty()) {
             if (temp1.top() != temp2.top()) {
@@ -108,18 +138,20 @@ public:
         list.push_back(T(std::forward<Args>(args)...));
     }
 
-    const List<T>& get_list() const { return list; }
+    Allocator get_allocator() const { return list.get_allocator(); }
+
+    const List<T, Allocator>& get_list() const { return list; }
 };
 
-template<typename T>
-std::ostream& operator<<(std::ostream& os, const Stack<T>& stack) {
+template<typename T, typename Allocator>
+std::ostream& operator<<(std::ostream& os, const Stack<T, Allocator>& stack) {
     os << "Stack (top to bottom): ";
     if (stack.empty()) {
         os << "empty";
     }
     else {
         auto temp = stack;
-        Stack<T> reverse;
+        Stack<T, Allocator> reverse(stack.get_allocator());
         while (!temp.empty()) {
             reverse.push(temp.top());
             temp.pop();
@@ -136,3 +168,9 @@ std::ostream& operator<<(std::ostream& os, const Stack<T>& stack) {
     return os;
 }
 
+#if defined(ASD_HAS_PMR)
+namespace pmr {
+template<typename T>
+using Stack = ::Stack<T, std::pmr::polymorphic_allocator<T>>;
+}
+#endif
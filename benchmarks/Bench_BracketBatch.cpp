@@ -0,0 +1,70 @@
+#include <benchmark/benchmark.h>
+#include <random>
+#include <string>
+#include <vector>
+#include "algorithms.h"
+
+namespace {
+
+const size_t INPUT_COUNT = 1000000;
+
+struct Batch {
+    std::string buffer;
+    std::vector<size_t> offsets;
+};
+
+// Short expressions of 8 to 64 bytes, most of them balanced.
+const Batch& short_expressions() {
+    static Batch batch;
+    if (batch.offsets.empty()) {
+        static const char* const PARTS[] = {
+            "a", "+", "(b * c)", "[i]", "f(x, y)", "{k: v}", " - 2", "(", ")"
+        };
+        std::mt19937 random(7);
+        batch.offsets.push_back(0);
+        for (size_t i = 0; i < INPUT_COUNT; ++i) {
+            size_t length = 8 + random() % 57;
+            size_t start = batch.buffer.size();
+            while (batch.buffer.size() - start < length) {
+                batch.buffer += PARTS[random() % 7];
+            }
+            if (random() % 16 == 0) {
+                batch.buffer += PARTS[7 + random() % 2];
+            }
+            batch.offsets.push_back(batch.buffer.size());
+        }
+    }
+    return batch;
+}
+
+void BM_CheckBracketsPerCall(benchmark::State& state) {
+    const Batch& batch = short_expressions();
+    for (auto _ : state) {
+        size_t balanced = 0;
+        for (size_t i = 0; i < INPUT_COUNT; ++i) {
+            std::string input(batch.buffer, batch.offsets[i], batch.offsets[i + 1] - batch.offsets[i]);
+            balanced += check_brackets(input);
+        }
+        benchmark::DoNotOptimize(balanced);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * INPUT_COUNT));
+}
+
+void BM_CheckBracketsBatch(benchmark::State& state) {
+    const Batch& batch = short_expressions();
+    std::vector<BracketCheckResult> results(INPUT_COUNT);
+    unsigned threads = static_cast<unsigned>(state.range(0));
+    for (auto _ : state) {
+        check_brackets_batch(batch.buffer.data(), batch.offsets.data(), INPUT_COUNT,
+                             results.data(), threads);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * INPUT_COUNT));
+    state.counters["threads"] = threads;
+}
+
+}  // namespace
+
+BENCHMARK(BM_CheckBracketsPerCall)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_CheckBracketsBatch)->RangeMultiplier(2)->Range(1, 16)
+    ->Unit(benchmark::kMillisecond)->UseRealTime();
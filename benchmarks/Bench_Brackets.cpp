@@ -0,0 +1,66 @@
+#include <benchmark/benchmark.h>
+#include <string>
+#include "algorithms.h"
+#include "stack.h"
+#include "bracket_inputs.h"
+
+namespace {
+
+// check_brackets as it was before the vectorized scanner: a byte loop over ArrayStack<char>.
+bool reference_check_brackets(const std::string& expression) {
+    ArrayStack<char> stack;
+
+    for (char c : expression) {
+        if (c == '(' || c == '[' || c == '{') {
+            stack.push(c);
+        }
+        else if (c == ')' || c == ']' || c == '}') {
+            if (stack.isEmpty()) {
+                return false;
+            }
+            char top = stack.pop();
+            if ((c == ')' && top != '(') ||
+                (c == ']' && top != '[') ||
+                (c == '}' && top != '{')) {
+                return false;
+            }
+        }
+    }
+    return stack.isEmpty();
+}
+
+const std::string& bracket_text(size_t bytes) {
+    static std::string text;
+    if (text.size() != bytes) {
+        text = make_bracket_text(bytes);
+    }
+    return text;
+}
+
+void BM_CheckBracketsReference(benchmark::State& state) {
+    const std::string& text = bracket_text(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(reference_check_brackets(text));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+
+void BM_CheckBracketsScanner(benchmark::State& state, BracketScanner scanner) {
+    if (!bracket_scanner_supported(scanner)) {
+        state.SkipWithError("scanner is not supported by this CPU");
+        return;
+    }
+    const std::string& text = bracket_text(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(check_brackets(text.data(), text.size(), scanner));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+
+}  // namespace
+
+BENCHMARK(BM_CheckBracketsReference)->Arg(4 << 20)->Arg(64 << 20);
+BENCHMARK_CAPTURE(BM_CheckBracketsScanner, scalar, BracketScanner::SCALAR)->Arg(4 << 20)->Arg(64 << 20);
+BENCHMARK_CAPTURE(BM_CheckBracketsScanner, sse2, BracketScanner::SSE2)->Arg(4 << 20)->Arg(64 << 20);
+BENCHMARK_CAPTURE(BM_CheckBracketsScanner, avx2, BracketScanner::AVX2)->Arg(4 << 20)->Arg(64 << 20);
+BENCHMARK_CAPTURE(BM_CheckBracketsScanner, avx512, BracketScanner::AVX512)->Arg(4 << 20)->Arg(64 << 20);
@@ -0,0 +1,321 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <list>
+#include <memory>
+#include <stack>
+#include <string>
+#include <vector>
+#include "LStack.h"
+#include "list.h"
+#include "queue.h"
+#include "stack.h"
+
+// Every container against its std counterpart, for int, std::string
+// (24 characters, past the small-string buffer) and a 64-byte record, at
+// 10 to 10M elements:
+//   Fill       push n elements into an empty container
+//   FillDrain  push n, then pop all of them
+//   Iterate    visit every element of a filled container
+//   Copy       copy-construct a filled container
+//   Sort       sort a list of pseudo-random values (List and std::list only)
+
+namespace {
+
+struct Record64 {
+    uint64_t key;
+    char payload[56];
+
+    bool operator<(const Record64& other) const { return key < other.key; }
+    bool operator>(const Record64& other) const { return key > other.key; }
+    bool operator==(const Record64& other) const { return key == other.key; }
+    bool operator!=(const Record64& other) const { return key != other.key; }
+};
+
+static_assert(sizeof(Record64) == 64, "Record64 must stay 64 bytes");
+
+// Elements cycle through this many distinct values, so even the 10M runs
+// copy from a small, cache-resident pool.
+const size_t POOL = 4096;
+
+uint64_t mix(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDull;
+    x ^= x >> 33;
+    return x;
+}
+
+void make(uint64_t i, int& out) { out = static_cast<int>(mix(i)); }
+void make(uint64_t i, std::string& out) {
+    out = "value-" + std::to_string(mix(i) % 1000000000000000000ull);
+    out.resize(24, '.');
+}
+void make(uint64_t i, Record64& out) {
+    out.key = mix(i);
+    std::memset(out.payload, static_cast<int>(i & 0x7F), sizeof(out.payload));
+}
+
+uint64_t weight(int value) { return static_cast<uint64_t>(value); }
+uint64_t weight(const std::string& value) { return value.size(); }
+uint64_t weight(const Record64& value) { return value.key; }
+
+template<typename T>
+const std::vector<T>& pool() {
+    static std::vector<T> values;
+    if (values.empty()) {
+        values.resize(POOL);
+        for (size_t i = 0; i < POOL; ++i) {
+            make(i, values[i]);
+        }
+    }
+    return values;
+}
+
+// Adapters give every container the same push / pop / visit interface.
+
+template<typename T>
+struct QueueAdapter {
+    Queue<T> c;
+    void push(const T& value) { c.push(value); }
+    void pop() { c.pop(); }
+    bool empty() const { return c.empty(); }
+    template<typename Visit>
+    void visit(Visit visit) const {
+        typename Queue<T>::Span spans[2] = { c.firstSpan(), c.secondSpan() };
+        for (const auto& span : spans) {
+            for (size_t i = 0; i < span.size; ++i) {
+                visit(span.data[i]);
+            }
+        }
+    }
+};
+
+template<typename T>
+struct StdDequeAdapter {
+    std::deque<T> c;
+    void push(const T& value) { c.push_back(value); }
+    void pop() { c.pop_front(); }
+    bool empty() const { return c.empty(); }
+    template<typename Visit>
+    void visit(Visit visit) const {
+        for (const T& value : c) {
+            visit(value);
+        }
+    }
+};
+
+template<typename T>
+struct ListAdapter {
+    mutable List<T> c;
+    void push(const T& value) { c.push_back(value); }
+    void pop() { c.pop_front(); }
+    bool empty() const { return c.empty(); }
+    template<typename Visit>
+    void visit(Visit visit) const {
+        for (auto it = c.begin(); it != c.end(); ++it) {
+            visit(*it);
+        }
+    }
+    void sort() { c.sort(); }
+};
+
+template<typename T>
+struct StdListAdapter {
+    std::list<T> c;
+    void push(const T& value) { c.push_back(value); }
+    void pop() { c.pop_front(); }
+    bool empty() const { return c.empty(); }
+    template<typename Visit>
+    void visit(Visit visit) const {
+        for (const T& value : c) {
+            visit(value);
+        }
+    }
+    void sort() { c.sort(); }
+};
+
+// ArrayStack keeps its storage inline, so each size gets a stack whose
+// MAX_SIZE is exactly that size, allocated on the heap.
+template<size_t N>
+struct ArrayStackOf {
+    template<typename T>
+    struct Adapter {
+        typedef ArrayStack<T, N> Storage;
+        std::unique_ptr<Storage> c;
+
+        Adapter() : c(new Storage()) {}
+        Adapter(const Adapter& other) : c(new Storage(*other.c)) {}
+
+        void push(const T& value) { c->push(value); }
+        void pop() { c->pop(); }
+        bool empty() const { return c->isEmpty(); }
+        template<typename Visit>
+        void visit(Visit visit) const {
+            const T* values = c->elements();
+            for (size_t i = 0, n = c->size(); i < n; ++i) {
+                visit(values[i]);
+            }
+        }
+    };
+};
+
+template<typename T>
+struct StdVectorAdapter {
+    std::vector<T> c;
+    void push(const T& value) { c.push_back(value); }
+    void pop() { c.pop_back(); }
+    bool empty() const { return c.empty(); }
+    template<typename Visit>
+    void visit(Visit visit) const {
+        for (const T& value : c) {
+            visit(value);
+        }
+    }
+};
+
+template<typename T>
+struct StackAdapter {
+    Stack<T> c;
+    void push(const T& value) { c.push(value); }
+    void pop() { c.pop(); }
+    bool empty() const { return c.empty(); }
+};
+
+template<typename T>
+struct StdStackAdapter {
+    std::stack<T> c;
+    void push(const T& value) { c.push(value); }
+    void pop() { c.pop(); }
+    bool empty() const { return c.empty(); }
+};
+
+template<typename Container, typename T>
+void fill(Container& container, size_t n) {
+    const std::vector<T>& values = pool<T>();
+    for (size_t i = 0; i < n; ++i) {
+        container.push(values[i % POOL]);
+    }
+}
+
+template<template<typename> class Adapter, typename T>
+void BM_Fill(benchmark::State& state) {
+    size_t n = static_cast<size_t>(state.range(0));
+    pool<T>();
+    for (auto _ : state) {
+        Adapter<T> container;
+        fill<Adapter<T>, T>(container, n);
+        benchmark::DoNotOptimize(container.empty());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template<template<typename> class Adapter, typename T>
+void BM_FillDrain(benchmark::State& state) {
+    size_t n = static_cast<size_t>(state.range(0));
+    pool<T>();
+    for (auto _ : state) {
+        Adapter<T> container;
+        fill<Adapter<T>, T>(container, n);
+        while (!container.empty()) {
+            container.pop();
+        }
+        benchmark::DoNotOptimize(container.empty());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template<template<typename> class Adapter, typename T>
+void BM_Iterate(benchmark::State& state) {
+    Adapter<T> container;
+    fill<Adapter<T>, T>(container, static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        uint64_t sum = 0;
+        container.visit([&sum](const T& value) { sum += weight(value); });
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template<template<typename> class Adapter, typename T>
+void BM_Copy(benchmark::State& state) {
+    Adapter<T> container;
+    fill<Adapter<T>, T>(container, static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        Adapter<T> copy(container);
+        benchmark::DoNotOptimize(copy.empty());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Each iteration sorts a fresh copy of the same unsorted list; the copy is
+// not timed.
+template<template<typename> class Adapter, typename T>
+void BM_Sort(benchmark::State& state) {
+    Adapter<T> unsorted;
+    fill<Adapter<T>, T>(unsorted, static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        state.PauseTiming();
+        Adapter<T> container(unsorted);
+        state.ResumeTiming();
+        container.sort();
+        benchmark::DoNotOptimize(container.empty());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void all_sizes(benchmark::internal::Benchmark* bench) {
+    bench->ArgName("n")->Arg(10)->Arg(1000)->Arg(100000)->Arg(10000000);
+}
+
+// A 10M-element ArrayStack<Record64> would be 640 MB of default-constructed
+// storage; the array stacks and their std::vector baseline stop at 1M.
+void array_stack_sizes(benchmark::internal::Benchmark* bench) {
+    bench->ArgName("n")->Arg(10)->Arg(1000)->Arg(100000)->Arg(1 << 20);
+}
+
+template<size_t N>
+void exact_size(benchmark::internal::Benchmark* bench) {
+    bench->ArgName("n")->Arg(N);
+}
+
+// List::sort is a bubble sort, so it only gets the sizes it can finish.
+void quadratic_sort_sizes(benchmark::internal::Benchmark* bench) {
+    bench->ArgName("n")->Arg(10)->Arg(1000)->Arg(10000);
+}
+
+}  // namespace
+
+#define CONTAINER_BENCHMARKS(Adapter, T, sizes)                      \
+    BENCHMARK_TEMPLATE(BM_Fill, Adapter, T)->Apply(sizes);           \
+    BENCHMARK_TEMPLATE(BM_FillDrain, Adapter, T)->Apply(sizes);      \
+    BENCHMARK_TEMPLATE(BM_Copy, Adapter, T)->Apply(sizes)
+
+#define ITERABLE_BENCHMARKS(Adapter, T, sizes)                       \
+    CONTAINER_BENCHMARKS(Adapter, T, sizes);                         \
+    BENCHMARK_TEMPLATE(BM_Iterate, Adapter, T)->Apply(sizes)
+
+#define ALL_ELEMENT_TYPES(Kind, Adapter, sizes)                      \
+    Kind(Adapter, int, sizes);                                       \
+    Kind(Adapter, std::string, sizes);                               \
+    Kind(Adapter, Record64, sizes)
+
+ALL_ELEMENT_TYPES(ITERABLE_BENCHMARKS, QueueAdapter, all_sizes);
+ALL_ELEMENT_TYPES(ITERABLE_BENCHMARKS, StdDequeAdapter, all_sizes);
+ALL_ELEMENT_TYPES(ITERABLE_BENCHMARKS, ListAdapter, all_sizes);
+ALL_ELEMENT_TYPES(ITERABLE_BENCHMARKS, StdListAdapter, all_sizes);
+ALL_ELEMENT_TYPES(ITERABLE_BENCHMARKS, ArrayStackOf<10>::Adapter, exact_size<10>);
+ALL_ELEMENT_TYPES(ITERABLE_BENCHMARKS, ArrayStackOf<1000>::Adapter, exact_size<1000>);
+ALL_ELEMENT_TYPES(ITERABLE_BENCHMARKS, ArrayStackOf<100000>::Adapter, exact_size<100000>);
+ALL_ELEMENT_TYPES(ITERABLE_BENCHMARKS, ArrayStackOf<(1 << 20)>::Adapter, exact_size<(1 << 20)>);
+ALL_ELEMENT_TYPES(ITERABLE_BENCHMARKS, StdVectorAdapter, array_stack_sizes);
+ALL_ELEMENT_TYPES(CONTAINER_BENCHMARKS, StackAdapter, all_sizes);
+ALL_ELEMENT_TYPES(CONTAINER_BENCHMARKS, StdStackAdapter, all_sizes);
+
+BENCHMARK_TEMPLATE(BM_Sort, ListAdapter, int)->Apply(quadratic_sort_sizes);
+BENCHMARK_TEMPLATE(BM_Sort, StdListAdapter, int)->Apply(quadratic_sort_sizes);
+BENCHMARK_TEMPLATE(BM_Sort, ListAdapter, std::string)->Apply(quadratic_sort_sizes);
+BENCHMARK_TEMPLATE(BM_Sort, StdListAdapter, std::string)->Apply(quadratic_sort_sizes);
+BENCHMARK_TEMPLATE(BM_Sort, ListAdapter, Record64)->Apply(quadratic_sort_sizes);
+BENCHMARK_TEMPLATE(BM_Sort, StdListAdapter, Record64)->Apply(quadratic_sort_sizes);
+BENCHMARK_TEMPLATE(BM_Sort, StdListAdapter, int)->ArgName("n")->Arg(1000000);
@@ -0,0 +1,103 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#include "easy_example.h"
+#include "error_policy.h"
+
+namespace {
+
+const size_t PAIRS = size_t(1) << 24;
+
+// Metric-like ratios: divisors 1..1000 with one zero in every 10000 pairs.
+struct DivisionInput {
+    std::vector<int> a;
+    std::vector<int> b;
+
+    DivisionInput() : a(PAIRS), b(PAIRS) {
+        uint32_t state = 12345;
+        for (size_t i = 0; i < PAIRS; ++i) {
+            state = state * 1664525u + 1013904223u;
+            a[i] = static_cast<int>(state >> 8);
+            b[i] = i % 10000 == 0 ? 0 : static_cast<int>((state >> 4) % 1000) + 1;
+        }
+    }
+};
+
+const DivisionInput& division_input() {
+    static const DivisionInput input;
+    return input;
+}
+
+// What callers do today: one division() per pair, a zero divisor caught
+// as an exception (or checked first in a no-exceptions build).
+void BM_DivisionCallLoop(benchmark::State& state) {
+    const DivisionInput& input = division_input();
+    size_t pairs = static_cast<size_t>(state.range(0));
+    std::vector<float> out(pairs);
+    for (auto _ : state) {
+        for (size_t i = 0; i < pairs; ++i) {
+#if ASD_EXCEPTIONS
+            try {
+                out[i] = division(input.a[i], input.b[i]);
+            }
+            catch (const std::invalid_argument&) {
+                out[i] = std::numeric_limits<float>::quiet_NaN();
+            }
+#else
+            out[i] = input.b[i] == 0 ? std::numeric_limits<float>::quiet_NaN()
+                                     : division(input.a[i], input.b[i]);
+#endif
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * pairs));
+}
+
+template<DivisionKernel KERNEL>
+void BM_DivisionBatch(benchmark::State& state) {
+    if (!division_kernel_supported(KERNEL)) {
+        state.SkipWithError("kernel is not supported by this CPU");
+        return;
+    }
+    const DivisionInput& input = division_input();
+    size_t pairs = static_cast<size_t>(state.range(0));
+    std::vector<float> out(pairs);
+    std::vector<uint64_t> errors((pairs + 63) / 64);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(division_batch(input.a.data(), input.b.data(), out.data(), pairs,
+                                                errors.data(), KERNEL));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * pairs));
+}
+
+void BM_DivisionBatchParallel(benchmark::State& state) {
+    const DivisionInput& input = division_input();
+    std::vector<float> out(PAIRS);
+    std::vector<uint64_t> errors((PAIRS + 63) / 64);
+    unsigned threads = static_cast<unsigned>(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(division_batch_parallel(input.a.data(), input.b.data(), out.data(),
+                                                         PAIRS, errors.data(), threads));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * PAIRS));
+    state.counters["threads"] = threads;
+}
+
+}  // namespace
+
+// 16K pairs stay in cache and show the arithmetic; 16M pairs stream from
+// memory, which is what the threads are for.
+BENCHMARK(BM_DivisionCallLoop)->Arg(1 << 14)->Arg(PAIRS)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_DivisionBatch, DivisionKernel::SCALAR)->Arg(1 << 14)->Arg(PAIRS)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_DivisionBatch, DivisionKernel::SSE2)->Arg(1 << 14)->Arg(PAIRS)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_DivisionBatch, DivisionKernel::AVX2)->Arg(1 << 14)->Arg(PAIRS)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_DivisionBatchParallel)->RangeMultiplier(2)->Range(1, 8)
+    ->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,78 @@
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+#include "expression.h"
+
+namespace {
+
+const char* const FORMULA = "(price * quantity) * (1 + tax) - discount / (1 + quantity ^ 2)";
+const size_t ROWS = 1 << 20;
+
+struct Columns {
+    std::vector<std::string> names;
+    std::vector<std::vector<double>> data;
+    std::vector<const double*> pointers;
+};
+
+const Columns& columns() {
+    static Columns table;
+    if (table.names.empty()) {
+        table.names = { "price", "quantity", "tax", "discount" };
+        table.data.assign(4, std::vector<double>(ROWS));
+        for (size_t i = 0; i < ROWS; ++i) {
+            table.data[0][i] = 10 + i % 97;
+            table.data[1][i] = 1 + i % 13;
+            table.data[2][i] = 0.2;
+            table.data[3][i] = i % 5;
+        }
+        for (const std::vector<double>& column : table.data) {
+            table.pointers.push_back(column.data());
+        }
+    }
+    return table;
+}
+
+void BM_ExpressionReparsePerRow(benchmark::State& state) {
+    const Columns& table = columns();
+    const size_t rows = ROWS / 64;
+    for (auto _ : state) {
+        double sum = 0;
+        for (size_t i = 0; i < rows; ++i) {
+            double values[] = { table.data[0][i], table.data[1][i], table.data[2][i], table.data[3][i] };
+            sum += Expression(FORMULA, table.names).evaluate(values);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * rows));
+}
+
+void BM_ExpressionCompiledPerRow(benchmark::State& state) {
+    const Columns& table = columns();
+    Expression expression(FORMULA, table.names);
+    for (auto _ : state) {
+        double sum = 0;
+        for (size_t i = 0; i < ROWS; ++i) {
+            double values[] = { table.data[0][i], table.data[1][i], table.data[2][i], table.data[3][i] };
+            sum += expression.evaluate(values);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * ROWS));
+}
+
+void BM_ExpressionCompiledBatch(benchmark::State& state) {
+    const Columns& table = columns();
+    Expression expression(FORMULA, table.names);
+    std::vector<double> out(ROWS);
+    for (auto _ : state) {
+        expression.evaluate(table.pointers.data(), ROWS, out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * ROWS));
+}
+
+}  // namespace
+
+BENCHMARK(BM_ExpressionReparsePerRow)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ExpressionCompiledPerRow)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ExpressionCompiledBatch)->Unit(benchmark::kMillisecond);
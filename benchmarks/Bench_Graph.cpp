@@ -0,0 +1,73 @@
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "graph.h"
+#include "graph_search.h"
+#include "graph_inputs.h"
+
+namespace {
+
+const uint32_t VERTICES = 1 << 20;
+const size_t EDGES = 10000000;
+
+const std::vector<Graph::Edge>& edge_list() {
+    static const std::vector<Graph::Edge> edges = make_random_edges(VERTICES, EDGES, 1);
+    return edges;
+}
+
+const Graph& graph() {
+    static const Graph instance(VERTICES, edge_list());
+    return instance;
+}
+
+void BM_GraphBuild(benchmark::State& state) {
+    const std::vector<Graph::Edge>& edges = edge_list();
+    for (auto _ : state) {
+        Graph built(VERTICES, edges);
+        benchmark::DoNotOptimize(built.columns().data());
+    }
+    state.counters["edges/s"] = benchmark::Counter(static_cast<double>(EDGES),
+                                                   benchmark::Counter::kIsIterationInvariantRate);
+}
+
+void BM_GraphTranspose(benchmark::State& state) {
+    const Graph& forward = graph();
+    for (auto _ : state) {
+        Graph reverse = forward.transpose();
+        benchmark::DoNotOptimize(reverse.columns().data());
+    }
+    state.counters["edges/s"] = benchmark::Counter(static_cast<double>(EDGES),
+                                                   benchmark::Counter::kIsIterationInvariantRate);
+}
+
+// Traversals scan every edge leaving a reached vertex, so the rate is
+// edges examined per second.
+void BM_GraphBfs(benchmark::State& state) {
+    const Graph& forward = graph();
+    size_t reached = 0;
+    for (auto _ : state) {
+        VisitedSet visited(VERTICES);
+        reached = breadth_first_search(forward, 0, visited, [](uint32_t, uint32_t) {});
+    }
+    state.counters["reached"] = static_cast<double>(reached);
+    state.counters["edges/s"] = benchmark::Counter(static_cast<double>(EDGES),
+                                                   benchmark::Counter::kIsIterationInvariantRate);
+}
+
+void BM_GraphDfs(benchmark::State& state) {
+    const Graph& forward = graph();
+    size_t reached = 0;
+    for (auto _ : state) {
+        VisitedSet visited(VERTICES);
+        reached = depth_first_search(forward, 0, visited, [](uint32_t) {});
+    }
+    state.counters["reached"] = static_cast<double>(reached);
+    state.counters["edges/s"] = benchmark::Counter(static_cast<double>(EDGES),
+                                                   benchmark::Counter::kIsIterationInvariantRate);
+}
+
+}  // namespace
+
+BENCHMARK(BM_GraphBuild)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_GraphTranspose)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_GraphBfs)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_GraphDfs)->Unit(benchmark::kMillisecond);
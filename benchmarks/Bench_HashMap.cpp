@@ -0,0 +1,113 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <unordered_map>
+#include <vector>
+#include "hash_map.h"
+
+namespace {
+
+// Lookups and erases per iteration, independent of the table size.
+const size_t OPERATIONS = 1 << 20;
+
+std::vector<uint64_t> random_keys(size_t n, unsigned seed) {
+    std::mt19937_64 random(seed);
+    std::vector<uint64_t> keys(n);
+    for (uint64_t& key : keys) {
+        key = random();
+    }
+    return keys;
+}
+
+template<typename Map>
+void fill(Map& map, const std::vector<uint64_t>& keys) {
+    for (uint64_t key : keys) {
+        map[key] = key;
+    }
+}
+
+template<typename Map>
+void BM_Insert(benchmark::State& state) {
+    std::vector<uint64_t> keys = random_keys(static_cast<size_t>(state.range(0)), 1);
+    for (auto _ : state) {
+        Map map;
+        fill(map, keys);
+        benchmark::DoNotOptimize(map.size());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * keys.size()));
+}
+
+template<typename Map>
+void BM_FindHit(benchmark::State& state) {
+    std::vector<uint64_t> keys = random_keys(static_cast<size_t>(state.range(0)), 1);
+    Map map;
+    fill(map, keys);
+    std::vector<uint64_t> probes(OPERATIONS);
+    std::mt19937_64 random(2);
+    for (uint64_t& probe : probes) {
+        probe = keys[random() % keys.size()];
+    }
+    for (auto _ : state) {
+        uint64_t sum = 0;
+        for (uint64_t probe : probes) {
+            sum += map.find(probe)->second;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * OPERATIONS));
+}
+
+template<typename Map>
+void BM_FindMiss(benchmark::State& state) {
+    std::vector<uint64_t> keys = random_keys(static_cast<size_t>(state.range(0)), 1);
+    Map map;
+    fill(map, keys);
+    std::vector<uint64_t> probes = random_keys(OPERATIONS, 3);
+    for (auto _ : state) {
+        size_t found = 0;
+        for (uint64_t probe : probes) {
+            found += map.find(probe) != map.end();
+        }
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * OPERATIONS));
+}
+
+// Erases OPERATIONS present keys, then puts them back untimed.
+template<typename Map>
+void BM_Erase(benchmark::State& state) {
+    std::vector<uint64_t> keys = random_keys(static_cast<size_t>(state.range(0)), 1);
+    Map map;
+    fill(map, keys);
+    std::vector<uint64_t> victims(keys.begin(), keys.begin() + std::min(keys.size(), OPERATIONS));
+    for (auto _ : state) {
+        for (uint64_t key : victims) {
+            map.erase(key);
+        }
+        state.PauseTiming();
+        fill(map, victims);
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * victims.size()));
+}
+
+typedef FlatHashMap<uint64_t, uint64_t> Flat;
+typedef std::unordered_map<uint64_t, uint64_t> Std;
+
+// 100M entries need several GB for std::unordered_map; filter them out on
+// small machines with --benchmark_filter.
+void sizes(benchmark::internal::Benchmark* bench) {
+    bench->Arg(1000000)->Arg(10000000)->Arg(100000000)->Unit(benchmark::kMillisecond);
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_Insert, Flat)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_Insert, Std)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_FindHit, Flat)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_FindHit, Std)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_FindMiss, Flat)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_FindMiss, Std)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_Erase, Flat)->Apply(sizes);
+BENCHMARK_TEMPLATE(BM_Erase, Std)->Apply(sizes);
@@ -0,0 +1,110 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <vector>
+#include "lru_cache.h"
+
+namespace {
+
+const size_t CAPACITY = 1 << 16;
+const size_t KEY_SPACE = 1 << 20;
+const size_t TRACE = 1 << 20;
+
+// Zipf(0.9)-distributed keys, the usual shape of hot-object traffic.
+const std::vector<uint64_t>& trace() {
+    static std::vector<uint64_t> keys;
+    if (keys.empty()) {
+        std::vector<double> cumulative(KEY_SPACE);
+        double total = 0;
+        for (size_t k = 0; k < KEY_SPACE; ++k) {
+            total += 1.0 / std::pow(static_cast<double>(k + 1), 0.9);
+            cumulative[k] = total;
+        }
+        std::mt19937_64 random(7);
+        std::uniform_real_distribution<double> uniform(0, total);
+        keys.resize(TRACE);
+        for (uint64_t& key : keys) {
+            key = std::lower_bound(cumulative.begin(), cumulative.end(), uniform(random)) - cumulative.begin();
+            // Scatter popular keys over the key space.
+            key = key * 0x9E3779B97F4A7C15ull;
+        }
+    }
+    return keys;
+}
+
+// Read-through: a miss loads the value and puts it. The cache is passed
+// by pointer reference because, in the threaded runs, thread 0 only
+// creates it right before the loop starts.
+template<typename Cache>
+void replay(benchmark::State& state, Cache* const& cache, size_t offset) {
+    const std::vector<uint64_t>& keys = trace();
+    size_t i = offset % TRACE;
+    for (auto _ : state) {
+        uint64_t key = keys[i];
+        uint64_t value;
+        if (!cache->get(key, value)) {
+            cache->put(key, key + 1);
+        }
+        i = i + 1 == TRACE ? 0 : i + 1;
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+void BM_LRUCache(benchmark::State& state) {
+    LRUCache<uint64_t, uint64_t>* cache = new LRUCache<uint64_t, uint64_t>(CAPACITY);
+    replay(state, cache, 0);
+    state.counters["hit_rate"] = static_cast<double>(cache->hits()) / (cache->hits() + cache->misses());
+    delete cache;
+}
+
+// The single cache behind one mutex, the baseline for the sharded one.
+struct LockedCache {
+    std::mutex lock;
+    LRUCache<uint64_t, uint64_t> cache;
+
+    LockedCache() : cache(CAPACITY) {}
+
+    bool get(uint64_t key, uint64_t& value) {
+        std::lock_guard<std::mutex> guard(lock);
+        return cache.get(key, value);
+    }
+
+    void put(uint64_t key, uint64_t value) {
+        std::lock_guard<std::mutex> guard(lock);
+        cache.put(key, value);
+    }
+};
+
+LockedCache* lockedCache;
+ShardedLRUCache<uint64_t, uint64_t>* shardedCache;
+
+void BM_LockedLRUCache(benchmark::State& state) {
+    if (state.thread_index() == 0) {
+        lockedCache = new LockedCache();
+    }
+    replay(state, lockedCache, state.thread_index() * (TRACE / state.threads()));
+    if (state.thread_index() == 0) {
+        delete lockedCache;
+    }
+}
+
+void BM_ShardedLRUCache(benchmark::State& state) {
+    if (state.thread_index() == 0) {
+        shardedCache = new ShardedLRUCache<uint64_t, uint64_t>(CAPACITY, 64);
+    }
+    replay(state, shardedCache, state.thread_index() * (TRACE / state.threads()));
+    if (state.thread_index() == 0) {
+        state.counters["hit_rate"] = static_cast<double>(shardedCache->hits())
+            / (shardedCache->hits() + shardedCache->misses());
+        delete shardedCache;
+    }
+}
+
+}  // namespace
+
+BENCHMARK(BM_LRUCache);
+BENCHMARK(BM_LockedLRUCache)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK(BM_ShardedLRUCache)->ThreadRange(1, 16)->UseRealTime();
@@ -0,0 +1,80 @@
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <vector>
+#include "graph.h"
+#include "graph_search.h"
+#include "parallel_bfs.h"
+#include "graph_inputs.h"
+
+namespace {
+
+const unsigned SCALE = 20;
+const size_t EDGE_FACTOR = 16;
+
+const Graph& rmat() {
+    static const Graph graph = make_rmat_graph(SCALE, EDGE_FACTOR, 5);
+    return graph;
+}
+
+// Highest-degree vertex: guaranteed to sit in the giant component.
+uint32_t source() {
+    static uint32_t best = 0;
+    static bool found = false;
+    if (!found) {
+        for (uint32_t v = 0; v < rmat().vertexCount(); ++v) {
+            best = rmat().degree(v) > rmat().degree(best) ? v : best;
+        }
+        found = true;
+    }
+    return best;
+}
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// One timed run of the serial Queue-based search, the speedup baseline.
+double serial_seconds() {
+    static double seconds = 0;
+    if (seconds == 0) {
+        const Graph& graph = rmat();
+        uint32_t from = source();
+        auto start = std::chrono::steady_clock::now();
+        benchmark::DoNotOptimize(bfs_distances(graph, from).data());
+        seconds = seconds_since(start);
+    }
+    return seconds;
+}
+
+void BM_BfsSerialQueue(benchmark::State& state) {
+    const Graph& graph = rmat();
+    uint32_t from = source();
+    for (auto _ : state) {
+        std::vector<uint32_t> distances = bfs_distances(graph, from);
+        benchmark::DoNotOptimize(distances.data());
+    }
+    state.counters["edges/s"] = benchmark::Counter(static_cast<double>(graph.edgeCount()),
+                                                   benchmark::Counter::kIsIterationInvariantRate);
+}
+
+void BM_BfsDirectionOptimizing(benchmark::State& state) {
+    unsigned threads = static_cast<unsigned>(state.range(0));
+    const Graph& graph = rmat();
+    uint32_t from = source();
+    double baseline = serial_seconds();
+    auto start = std::chrono::steady_clock::now();
+    for (auto _ : state) {
+        std::vector<uint32_t> distances = bfs_distances_parallel(graph, graph, from, threads);
+        benchmark::DoNotOptimize(distances.data());
+    }
+    double perSearch = seconds_since(start) / static_cast<double>(state.iterations());
+    state.counters["edges/s"] = benchmark::Counter(static_cast<double>(graph.edgeCount()),
+                                                   benchmark::Counter::kIsIterationInvariantRate);
+    state.counters["speedup"] = baseline / perSearch;
+}
+
+}  // namespace
+
+BENCHMARK(BM_BfsSerialQueue)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_BfsDirectionOptimizing)->RangeMultiplier(2)->Range(1, 32)
+    ->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,37 @@
+#include <benchmark/benchmark.h>
+#include <string>
+#include "algorithms.h"
+#include "bracket_inputs.h"
+
+namespace {
+
+const size_t INPUT_BYTES = size_t(1) << 30;
+
+const std::string& gigabyte_text() {
+    static const std::string text = make_bracket_text(INPUT_BYTES);
+    return text;
+}
+
+void BM_CheckBracketsSequential(benchmark::State& state) {
+    const std::string& text = gigabyte_text();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(check_brackets(text.data(), text.size()));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+}
+
+void BM_CheckBracketsParallel(benchmark::State& state) {
+    const std::string& text = gigabyte_text();
+    unsigned threads = static_cast<unsigned>(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(check_brackets_parallel(text.data(), text.size(), threads));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+    state.counters["threads"] = threads;
+}
+
+}  // namespace
+
+BENCHMARK(BM_CheckBracketsSequential)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_CheckBracketsParallel)->RangeMultiplier(2)->Range(1, 32)
+    ->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,122 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <shared_mutex>
+#include "list.h"
+#include "rcu_list.h"
+
+namespace {
+
+// Thread 0 rewrites one entry after this many of its own lookups; every
+// other operation is a read.
+const int64_t UPDATE_EVERY = 4096;
+
+struct Entry {
+    uint64_t key;
+    uint64_t value;
+};
+
+// std::shared_mutex is C++17; shared_timed_mutex is the C++14 equivalent.
+class LockedRegistry {
+private:
+    mutable std::shared_timed_mutex lock;
+    mutable List<Entry> entries;
+
+public:
+    void add(const Entry& entry) {
+        std::lock_guard<std::shared_timed_mutex> guard(lock);
+        entries.push_back(entry);
+    }
+
+    bool lookup(uint64_t key, uint64_t& value) const {
+        std::shared_lock<std::shared_timed_mutex> guard(lock);
+        for (auto it = entries.begin(); it != entries.end(); ++it) {
+            if ((*it).key == key) {
+                value = (*it).value;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void update(const Entry& entry) {
+        std::lock_guard<std::shared_timed_mutex> guard(lock);
+        for (auto it = entries.begin(); it != entries.end(); ++it) {
+            if ((*it).key == entry.key) {
+                *it = entry;
+            }
+        }
+    }
+};
+
+class RcuRegistry {
+private:
+    RcuList<Entry> entries;
+
+public:
+    void add(const Entry& entry) { entries.push_back(entry); }
+
+    bool lookup(uint64_t key, uint64_t& value) const {
+        Entry found;
+        if (!entries.find_if([key](const Entry& entry) { return entry.key == key; }, found)) {
+            return false;
+        }
+        value = found.value;
+        return true;
+    }
+
+    void update(const Entry& entry) {
+        uint64_t key = entry.key;
+        entries.replace_if([key](const Entry& other) { return other.key == key; }, entry);
+    }
+};
+
+template<typename Registry>
+Registry*& shared_registry() {
+    static Registry* registry = nullptr;
+    return registry;
+}
+
+// range(0): number of entries. Every thread looks up random keys; thread 0
+// also applies an update every UPDATE_EVERY lookups.
+template<typename Registry>
+void BM_RegistryReads(benchmark::State& state) {
+    Registry*& registry = shared_registry<Registry>();
+    uint64_t size = static_cast<uint64_t>(state.range(0));
+    if (state.thread_index() == 0) {
+        registry = new Registry();
+        for (uint64_t i = 0; i < size; ++i) {
+            registry->add({ i, i });
+        }
+    }
+    bool writer = state.thread_index() == 0;
+    std::mt19937_64 random(state.thread_index() + 1);
+    uint64_t checksum = 0;
+    int64_t sinceUpdate = 0;
+    for (auto _ : state) {
+        uint64_t key = random() % size;
+        uint64_t value = 0;
+        checksum += registry->lookup(key, value) ? value : 0;
+        if (writer && ++sinceUpdate == UPDATE_EVERY) {
+            registry->update({ key, random() });
+            sinceUpdate = 0;
+        }
+    }
+    benchmark::DoNotOptimize(checksum);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    if (state.thread_index() == 0) {
+        delete registry;
+        registry = nullptr;
+        EpochManager::synchronize();
+    }
+}
+
+void registry_sizes(benchmark::internal::Benchmark* bench) {
+    bench->ArgName("entries")->Arg(16)->Arg(256)->ThreadRange(1, 16)->UseRealTime();
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_RegistryReads, LockedRegistry)->Apply(registry_sizes);
+BENCHMARK_TEMPLATE(BM_RegistryReads, RcuRegistry)->Apply(registry_sizes);
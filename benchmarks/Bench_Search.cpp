@@ -0,0 +1,146 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "queue.h"
+#include "simd_search.h"
+#include "stack.h"
+
+namespace {
+
+const size_t ELEMENTS = 1 << 20;
+
+enum class SearchOp { FIND, COUNT, MIN, MAX, EQUAL };
+
+// Values 0..99; FIND looks for 100, so every search scans all of them.
+template<typename T>
+const std::vector<T>& search_input() {
+    static std::vector<T> values;
+    if (values.empty()) {
+        uint32_t state = 12345;
+        values.resize(ELEMENTS);
+        for (T& value : values) {
+            state = state * 1664525u + 1013904223u;
+            value = static_cast<T>((state >> 16) % 100);
+        }
+    }
+    return values;
+}
+
+template<typename T>
+size_t run_kernel(const SearchKernels<T>& kernels, SearchOp op, const T* data, const T* copy, size_t count) {
+    switch (op) {
+    case SearchOp::FIND:
+        return kernels.find(data, count, static_cast<T>(100));
+    case SearchOp::COUNT:
+        return kernels.count(data, count, static_cast<T>(7));
+    case SearchOp::MIN:
+        return kernels.minIndex(data, count);
+    case SearchOp::MAX:
+        return kernels.maxIndex(data, count);
+    default:
+        return kernels.mismatch(data, copy, count);
+    }
+}
+
+template<typename T, SearchKernel KERNEL, SearchOp OP>
+void BM_SearchKernel(benchmark::State& state) {
+    if (!search_kernel_supported(KERNEL)) {
+        state.SkipWithError("kernel is not supported by this CPU");
+        return;
+    }
+    const std::vector<T>& data = search_input<T>();
+    std::vector<T> copy = data;
+    const SearchKernels<T>& kernels = *search_kernels<T>(KERNEL);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(run_kernel(kernels, OP, data.data(), copy.data(), data.size()));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * data.size() * sizeof(T)));
+}
+
+// The containers call the kernels through simd_search.h, so these show the
+// AUTO kernel plus whatever the container adds: a Queue that wraps
+// searches two spans.
+template<typename T, SearchOp OP>
+void BM_ArrayStackSearch(benchmark::State& state) {
+    const std::vector<T>& data = search_input<T>();
+    std::unique_ptr<ArrayStack<T, ELEMENTS>> stack(new ArrayStack<T, ELEMENTS>());
+    stack->assign(data.data(), data.size());
+    std::unique_ptr<ArrayStack<T, ELEMENTS>> copy(new ArrayStack<T, ELEMENTS>(*stack));
+    for (auto _ : state) {
+        switch (OP) {
+        case SearchOp::FIND:
+            benchmark::DoNotOptimize(stack->find(static_cast<T>(100)));
+            break;
+        case SearchOp::COUNT:
+            benchmark::DoNotOptimize(stack->count(static_cast<T>(7)));
+            break;
+        case SearchOp::MIN:
+            benchmark::DoNotOptimize(&stack->minElement());
+            break;
+        case SearchOp::MAX:
+            benchmark::DoNotOptimize(&stack->maxElement());
+            break;
+        default:
+            benchmark::DoNotOptimize(*stack == *copy);
+            break;
+        }
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * data.size() * sizeof(T)));
+}
+
+template<typename T, SearchOp OP>
+void BM_QueueSearch(benchmark::State& state) {
+    const std::vector<T>& data = search_input<T>();
+    Queue<T> queue;
+    for (size_t i = 0; i < data.size(); ++i) {
+        queue.push(data[i]);
+    }
+    // Rotate a third of the way round so the contents wrap.
+    for (size_t i = 0; i < data.size() / 3; ++i) {
+        T front = queue.front();
+        queue.pop();
+        queue.push(front);
+    }
+    Queue<T> copy(queue);   // same elements, unwrapped
+    for (auto _ : state) {
+        switch (OP) {
+        case SearchOp::FIND:
+            benchmark::DoNotOptimize(queue.find(static_cast<T>(100)));
+            break;
+        case SearchOp::COUNT:
+            benchmark::DoNotOptimize(queue.count(static_cast<T>(7)));
+            break;
+        case SearchOp::MIN:
+            benchmark::DoNotOptimize(&queue.minElement());
+            break;
+        case SearchOp::MAX:
+            benchmark::DoNotOptimize(&queue.maxElement());
+            break;
+        default:
+            benchmark::DoNotOptimize(queue == copy);
+            break;
+        }
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * data.size() * sizeof(T)));
+}
+
+}  // namespace
+
+#define SEARCH_BENCHMARKS(T, OP)                                             \
+    BENCHMARK_TEMPLATE(BM_SearchKernel, T, SearchKernel::SCALAR, SearchOp::OP);  \
+    BENCHMARK_TEMPLATE(BM_SearchKernel, T, SearchKernel::SSE2, SearchOp::OP);    \
+    BENCHMARK_TEMPLATE(BM_SearchKernel, T, SearchKernel::AVX2, SearchOp::OP);    \
+    BENCHMARK_TEMPLATE(BM_ArrayStackSearch, T, SearchOp::OP);                    \
+    BENCHMARK_TEMPLATE(BM_QueueSearch, T, SearchOp::OP)
+
+#define ALL_SEARCH_OPS(T)              \
+    SEARCH_BENCHMARKS(T, FIND);        \
+    SEARCH_BENCHMARKS(T, COUNT);       \
+    SEARCH_BENCHMARKS(T, MIN);         \
+    SEARCH_BENCHMARKS(T, MAX);         \
+    SEARCH_BENCHMARKS(T, EQUAL)
+
+ALL_SEARCH_OPS(int);
+ALL_SEARCH_OPS(float);
+ALL_SEARCH_OPS(char);
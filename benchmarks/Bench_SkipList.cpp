@@ -0,0 +1,133 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <random>
+#include <shared_mutex>
+#include "epoch.h"
+#include "skip_list.h"
+
+namespace {
+
+const uint64_t KEY_SPACE = 1 << 20;
+const int SCAN_LENGTH = 100;
+
+// std::shared_mutex is C++17; shared_timed_mutex is the C++14 equivalent.
+class LockedMap {
+private:
+    mutable std::shared_timed_mutex lock;
+    std::map<uint64_t, uint64_t> map;
+
+public:
+    bool insert(uint64_t key, uint64_t value) {
+        std::lock_guard<std::shared_timed_mutex> guard(lock);
+        return map.emplace(key, value).second;
+    }
+
+    bool erase(uint64_t key) {
+        std::lock_guard<std::shared_timed_mutex> guard(lock);
+        return map.erase(key) != 0;
+    }
+
+    bool find(uint64_t key, uint64_t& value) const {
+        std::shared_lock<std::shared_timed_mutex> guard(lock);
+        auto it = map.find(key);
+        if (it == map.end()) {
+            return false;
+        }
+        value = it->second;
+        return true;
+    }
+
+    uint64_t scan(uint64_t from) const {
+        std::shared_lock<std::shared_timed_mutex> guard(lock);
+        uint64_t sum = 0;
+        int n = 0;
+        for (auto it = map.lower_bound(from); it != map.end() && n < SCAN_LENGTH; ++it, ++n) {
+            sum += it->second;
+        }
+        return sum;
+    }
+};
+
+class SkipList {
+private:
+    ConcurrentSkipListMap<uint64_t, uint64_t> map;
+
+public:
+    bool insert(uint64_t key, uint64_t value) { return map.insert(key, value); }
+    bool erase(uint64_t key) { return map.erase(key); }
+    bool find(uint64_t key, uint64_t& value) const { return map.find(key, value); }
+
+    uint64_t scan(uint64_t from) const {
+        EpochManager::ReadGuard guard;
+        uint64_t sum = 0;
+        int n = 0;
+        for (auto it = map.lower_bound(from); it != map.end() && n < SCAN_LENGTH; ++it, ++n) {
+            sum += it->second;
+        }
+        return sum;
+    }
+};
+
+template<typename Map>
+Map*& shared_map() {
+    static Map* map = nullptr;
+    return map;
+}
+
+// range(0): percentage of operations that are point reads; the rest split
+// evenly into inserts and erases, so the map stays about half full.
+// range(1): 1 to make every read a 100-entry range scan instead.
+template<typename Map>
+void BM_MixedWorkload(benchmark::State& state) {
+    Map*& map = shared_map<Map>();
+    if (state.thread_index() == 0) {
+        map = new Map();
+        std::mt19937_64 random(1);
+        for (uint64_t i = 0; i < KEY_SPACE / 2; ++i) {
+            map->insert(random() % KEY_SPACE, i);
+        }
+    }
+    uint64_t readPercent = static_cast<uint64_t>(state.range(0));
+    bool scans = state.range(1) != 0;
+    std::mt19937_64 random(state.thread_index() + 100);
+    uint64_t checksum = 0;
+    for (auto _ : state) {
+        uint64_t r = random();
+        uint64_t key = (r >> 8) % KEY_SPACE;
+        uint64_t dice = r % 100;
+        if (dice < readPercent) {
+            if (scans) {
+                checksum += map->scan(key);
+            }
+            else {
+                uint64_t value;
+                checksum += map->find(key, value);
+            }
+        }
+        else if (dice % 2 == 0) {
+            map->insert(key, key);
+        }
+        else {
+            map->erase(key);
+        }
+    }
+    benchmark::DoNotOptimize(checksum);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    if (state.thread_index() == 0) {
+        delete map;
+        map = nullptr;
+    }
+}
+
+void workloads(benchmark::internal::Benchmark* bench) {
+    bench->ArgNames({ "read%", "scan" })
+        ->Args({ 50, 0 })->Args({ 90, 0 })->Args({ 99, 0 })->Args({ 90, 1 })
+        ->ThreadRange(1, 16)->UseRealTime();
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_MixedWorkload, LockedMap)->Apply(workloads);
+BENCHMARK_TEMPLATE(BM_MixedWorkload, SkipList)->Apply(workloads);
@@ -0,0 +1,66 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "sliding_window.h"
+
+namespace {
+
+// Every run produces this many window results, so time per result is comparable across k.
+const size_t OUTPUTS = 4096;
+
+std::vector<double> samples(size_t n) {
+    std::mt19937_64 random(11);
+    std::uniform_real_distribution<double> value(0, 1000);
+    std::vector<double> data(n);
+    for (double& x : data) {
+        x = value(random);
+    }
+    return data;
+}
+
+void BM_SlidingMinNaive(benchmark::State& state) {
+    size_t k = static_cast<size_t>(state.range(0));
+    std::vector<double> data = samples(k + OUTPUTS - 1);
+    std::vector<double> out(OUTPUTS);
+    for (auto _ : state) {
+        for (size_t i = 0; i < OUTPUTS; ++i) {
+            out[i] = *std::min_element(data.begin() + i, data.begin() + i + k);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * OUTPUTS));
+}
+
+void BM_SlidingMinMonotonic(benchmark::State& state) {
+    size_t k = static_cast<size_t>(state.range(0));
+    std::vector<double> data = samples(k + OUTPUTS - 1);
+    std::vector<double> out(OUTPUTS);
+    for (auto _ : state) {
+        sliding_window_min(data.data(), data.size(), k, out.data());
+        benchmark::ClobberMemory();
+    }
+    // The monotonic pass also has to warm up over the first k - 1 samples.
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * OUTPUTS));
+}
+
+void BM_SlidingMinStreaming(benchmark::State& state) {
+    size_t k = static_cast<size_t>(state.range(0));
+    std::vector<double> data = samples(k + OUTPUTS - 1);
+    for (auto _ : state) {
+        SlidingWindowMin<double> window(k);
+        double sum = 0;
+        for (double x : data) {
+            window.push(x);
+            sum += window.value();
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * data.size()));
+}
+
+}  // namespace
+
+BENCHMARK(BM_SlidingMinNaive)->RangeMultiplier(16)->Range(64, 1 << 20);
+BENCHMARK(BM_SlidingMinMonotonic)->RangeMultiplier(16)->Range(64, 1 << 20);
+BENCHMARK(BM_SlidingMinStreaming)->RangeMultiplier(16)->Range(64, 1 << 20);
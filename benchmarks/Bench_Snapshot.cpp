@@ -0,0 +1,103 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+#include "snapshot.h"
+
+namespace {
+
+std::string text_path(int64_t count) {
+    return "bench_snapshot_" + std::to_string(count) + ".txt";
+}
+
+std::string snapshot_path(int64_t count) {
+    return "bench_snapshot_" + std::to_string(count) + ".bin";
+}
+
+// Sizes whose input files exist; the files are removed at exit.
+struct PreparedFiles {
+    std::vector<int64_t> counts;
+
+    ~PreparedFiles() {
+        for (int64_t count : counts) {
+            std::remove(text_path(count).c_str());
+            std::remove(snapshot_path(count).c_str());
+        }
+    }
+};
+
+// Writes the same values as a text file (one per line) and as a snapshot,
+// once per size.
+void prepare_files(int64_t count) {
+    static PreparedFiles prepared;
+    for (int64_t done : prepared.counts) {
+        if (done == count) {
+            return;
+        }
+    }
+    std::mt19937_64 random(7);
+    std::vector<uint64_t> values(static_cast<size_t>(count));
+    for (uint64_t& value : values) {
+        value = random();
+    }
+    std::ofstream text(text_path(count));
+    for (uint64_t value : values) {
+        text << value << '\n';
+    }
+    save_snapshot(snapshot_path(count), values.data(), values.size());
+    prepared.counts.push_back(count);
+}
+
+// The old startup path: parse text and push element by element.
+void BM_ColdStartFromText(benchmark::State& state) {
+    prepare_files(state.range(0));
+    for (auto _ : state) {
+        Queue<uint64_t> queue;
+        std::ifstream in(text_path(state.range(0)));
+        std::string line;
+        while (std::getline(in, line)) {
+            queue.push(std::strtoull(line.c_str(), nullptr, 10));
+        }
+        benchmark::DoNotOptimize(queue.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Snapshot mapped, checksummed and copied into a Queue with one memcpy.
+void BM_ColdStartSnapshotQueue(benchmark::State& state) {
+    prepare_files(state.range(0));
+    for (auto _ : state) {
+        Queue<uint64_t> queue;
+        load_snapshot(snapshot_path(state.range(0)), queue);
+        benchmark::DoNotOptimize(queue.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Zero-copy view; range(1) selects whether the checksum is verified.
+void BM_ColdStartSnapshotView(benchmark::State& state) {
+    prepare_files(state.range(0));
+    bool verify = state.range(1) != 0;
+    for (auto _ : state) {
+        SnapshotView<uint64_t> view(snapshot_path(state.range(0)), verify);
+        benchmark::DoNotOptimize(view[view.size() / 2]);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void sizes(benchmark::internal::Benchmark* bench) {
+    bench->ArgName("n")->Arg(1 << 16)->Arg(1 << 20)->Arg(1 << 23)->Unit(benchmark::kMillisecond);
+}
+
+}  // namespace
+
+BENCHMARK(BM_ColdStartFromText)->Apply(sizes);
+BENCHMARK(BM_ColdStartSnapshotQueue)->Apply(sizes);
+BENCHMARK(BM_ColdStartSnapshotView)
+    ->ArgNames({ "n", "verify" })
+    ->Args({ 1 << 20, 1 })->Args({ 1 << 20, 0 })->Args({ 1 << 23, 1 })->Args({ 1 << 23, 0 })
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,143 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+#include "sort.h"
+
+namespace {
+
+const size_t KEYS = 1 << 22;
+const size_t STRINGS = 1 << 19;
+
+enum Distribution { UNIFORM, SORTED, REVERSED, DUPLICATES };
+
+template<typename T>
+const std::vector<T>& keys(int distribution) {
+    static std::vector<T> inputs[4];
+    std::vector<T>& keys = inputs[distribution];
+    if (keys.empty()) {
+        std::mt19937_64 random(distribution);
+        keys.resize(KEYS);
+        for (T& key : keys) {
+            key = static_cast<T>(random());
+            if (distribution == DUPLICATES) {
+                key = static_cast<T>(key % 100);
+            }
+        }
+        if (distribution == SORTED) {
+            std::sort(keys.begin(), keys.end());
+        }
+        else if (distribution == REVERSED) {
+            std::sort(keys.begin(), keys.end(), std::greater<T>());
+        }
+    }
+    return keys;
+}
+
+// Random words of 8-24 letters; duplicates draws them from 100 words.
+const std::vector<std::string>& strings(int distribution) {
+    static std::vector<std::string> inputs[4];
+    std::vector<std::string>& strings = inputs[distribution];
+    if (strings.empty()) {
+        std::mt19937 random(distribution);
+        std::vector<std::string> vocabulary;
+        size_t distinct = distribution == DUPLICATES ? 100 : STRINGS;
+        for (size_t i = 0; i < distinct; ++i) {
+            std::string word(8 + random() % 17, ' ');
+            for (char& c : word) {
+                c = static_cast<char>('a' + random() % 26);
+            }
+            vocabulary.push_back(word);
+        }
+        for (size_t i = 0; i < STRINGS; ++i) {
+            strings.push_back(vocabulary[distribution == DUPLICATES ? random() % distinct : i]);
+        }
+        if (distribution == SORTED) {
+            std::sort(strings.begin(), strings.end());
+        }
+        else if (distribution == REVERSED) {
+            std::sort(strings.begin(), strings.end(), std::greater<std::string>());
+        }
+    }
+    return strings;
+}
+
+// Copies the input outside the timed region, then runs sort on the copy.
+template<typename T, typename Sort>
+void run(benchmark::State& state, const std::vector<T>& input, Sort sort) {
+    std::vector<T> work;
+    for (auto _ : state) {
+        state.PauseTiming();
+        work = input;
+        state.ResumeTiming();
+        sort(work.data(), work.data() + work.size());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * input.size()));
+}
+
+template<typename T>
+void BM_StdSort(benchmark::State& state) {
+    run(state, keys<T>(static_cast<int>(state.range(0))), [](T* first, T* last) { std::sort(first, last); });
+}
+
+template<typename T>
+void BM_IntroSort(benchmark::State& state) {
+    run(state, keys<T>(static_cast<int>(state.range(0))), [](T* first, T* last) { intro_sort(first, last); });
+}
+
+template<typename T>
+void BM_RadixSort(benchmark::State& state) {
+    run(state, keys<T>(static_cast<int>(state.range(0))),
+        [](T* first, T* last) { radix_sort(first, static_cast<size_t>(last - first)); });
+}
+
+template<typename T>
+void BM_ParallelMergeSort(benchmark::State& state) {
+    unsigned threads = static_cast<unsigned>(state.range(1));
+    run(state, keys<T>(static_cast<int>(state.range(0))),
+        [threads](T* first, T* last) { parallel_merge_sort(first, last, threads); });
+}
+
+void BM_StdSortStrings(benchmark::State& state) {
+    run(state, strings(static_cast<int>(state.range(0))),
+        [](std::string* first, std::string* last) { std::sort(first, last); });
+}
+
+void BM_RadixSortStrings(benchmark::State& state) {
+    run(state, strings(static_cast<int>(state.range(0))),
+        [](std::string* first, std::string* last) { radix_sort(first, static_cast<size_t>(last - first)); });
+}
+
+void BM_ParallelMergeSortStrings(benchmark::State& state) {
+    unsigned threads = static_cast<unsigned>(state.range(1));
+    run(state, strings(static_cast<int>(state.range(0))),
+        [threads](std::string* first, std::string* last) { parallel_merge_sort(first, last, threads); });
+}
+
+void distributions(benchmark::internal::Benchmark* bench) {
+    bench->ArgName("distribution")->DenseRange(UNIFORM, DUPLICATES)->Unit(benchmark::kMillisecond);
+}
+
+void distributions_and_threads(benchmark::internal::Benchmark* bench) {
+    bench->ArgNames({ "distribution", "threads" })
+        ->ArgsProduct({ { UNIFORM, SORTED, REVERSED, DUPLICATES }, { 1, 4, 16 } })
+        ->Unit(benchmark::kMillisecond)->UseRealTime();
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_StdSort, uint32_t)->Apply(distributions);
+BENCHMARK_TEMPLATE(BM_IntroSort, uint32_t)->Apply(distributions);
+BENCHMARK_TEMPLATE(BM_RadixSort, uint32_t)->Apply(distributions);
+BENCHMARK_TEMPLATE(BM_ParallelMergeSort, uint32_t)->Apply(distributions_and_threads);
+BENCHMARK_TEMPLATE(BM_StdSort, uint64_t)->Apply(distributions);
+BENCHMARK_TEMPLATE(BM_IntroSort, uint64_t)->Apply(distributions);
+BENCHMARK_TEMPLATE(BM_RadixSort, uint64_t)->Apply(distributions);
+BENCHMARK_TEMPLATE(BM_ParallelMergeSort, uint64_t)->Apply(distributions_and_threads);
+BENCHMARK(BM_StdSortStrings)->Apply(distributions);
+BENCHMARK(BM_RadixSortStrings)->Apply(distributions);
+BENCHMARK(BM_ParallelMergeSortStrings)->Apply(distributions_and_threads);
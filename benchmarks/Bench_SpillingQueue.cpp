@@ -0,0 +1,78 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include "queue.h"
+#include "spilling_queue.h"
+
+namespace {
+
+const size_t SEGMENT = 1 << 16;                       // 512 KiB of uint64_t
+const size_t BUDGET = 8 * SEGMENT * sizeof(uint64_t);  // 4 MiB
+
+// A surge: range(0) elements arrive, then the backlog drains. The spilling
+// queue writes everything past its 4 MiB budget to disk and reads it back.
+void BM_SurgeInMemoryQueue(benchmark::State& state) {
+    uint64_t n = static_cast<uint64_t>(state.range(0));
+    for (auto _ : state) {
+        Queue<uint64_t> queue;
+        for (uint64_t i = 0; i < n; ++i) {
+            queue.push(i);
+        }
+        uint64_t sum = 0;
+        while (!queue.empty()) {
+            sum += queue.front();
+            queue.pop();
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(uint64_t));
+}
+
+void BM_SurgeSpillingQueue(benchmark::State& state) {
+    uint64_t n = static_cast<uint64_t>(state.range(0));
+    uint64_t spilled = 0;
+    size_t peak = 0;
+    for (auto _ : state) {
+        SpillingQueue<uint64_t> queue(".", SEGMENT, BUDGET);
+        for (uint64_t i = 0; i < n; ++i) {
+            queue.push(i);
+        }
+        uint64_t sum = 0;
+        while (!queue.empty()) {
+            sum += queue.front();
+            queue.pop();
+        }
+        benchmark::DoNotOptimize(sum);
+        spilled = queue.stats().bytesSpilled;
+        peak = queue.stats().peakResidentBytes;
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(uint64_t));
+    state.counters["spilled_MiB"] = static_cast<double>(spilled) / (1 << 20);
+    state.counters["peak_resident_MiB"] = static_cast<double>(peak) / (1 << 20);
+}
+
+// Steady state with a standing backlog of range(0) elements: one push and
+// one pop per iteration, so every element passes through a file.
+void BM_SteadyBacklogSpillingQueue(benchmark::State& state) {
+    SpillingQueue<uint64_t> queue(".", SEGMENT, BUDGET);
+    uint64_t next = 0;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        queue.push(next++);
+    }
+    uint64_t sum = 0;
+    for (auto _ : state) {
+        queue.push(next++);
+        sum += queue.front();
+        queue.pop();
+    }
+    benchmark::DoNotOptimize(sum);
+    state.SetItemsProcessed(state.iterations());
+    state.counters["segments_loaded"] = static_cast<double>(queue.stats().segmentsLoaded);
+}
+
+}  // namespace
+
+BENCHMARK(BM_SurgeInMemoryQueue)->ArgName("n")->Arg(1 << 20)->Arg(1 << 24)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SurgeSpillingQueue)->ArgName("n")->Arg(1 << 20)->Arg(1 << 24)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SteadyBacklogSpillingQueue)->ArgName("backlog")->Arg(1 << 22);
@@ -0,0 +1,29 @@
+#ifndef BENCHMARKS_BRACKET_INPUTS_H
+#define BENCHMARKS_BRACKET_INPUTS_H
+
+#include <cstddef>
+#include <random>
+#include <string>
+
+// JSON-ish text: short records with a few shallow brackets per line,
+// balanced as a whole, padded with spaces to exactly `bytes`.
+inline std::string make_bracket_text(size_t bytes, unsigned seed = 42) {
+    static const char* const RECORDS[] = {
+        "{\"id\": 1024, \"name\": \"sensor-a\", \"tags\": [\"alpha\", \"beta\"]},\n",
+        "{\"id\": 2048, \"ratio\": (3.25 * (x + y)), \"ok\": true},\n",
+        "{\"matrix\": [[1, 2], [3, 4]], \"note\": \"plain text without brackets\"},\n",
+        "    value = compute(a[i], b[j]) + offset; // trailing comment text\n",
+    };
+    std::mt19937 random(seed);
+    std::string text;
+    text.reserve(bytes + 128);
+    text += "[\n";
+    while (text.size() + 128 < bytes) {
+        text += RECORDS[random() % 4];
+    }
+    text += "]\n";
+    text.resize(bytes, ' ');
+    return text;
+}
+
+#endif
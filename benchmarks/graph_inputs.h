@@ -0,0 +1,68 @@
+#ifndef GRAPH_INPUTS_H
+#define GRAPH_INPUTS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "graph.h"
+
+// Uniformly random directed edges; with edges >> vertices almost every
+// vertex is reachable from vertex 0.
+inline std::vector<Graph::Edge> make_random_edges(uint32_t vertices, size_t edges, unsigned seed) {
+    std::mt19937 random(seed);
+    std::uniform_int_distribution<uint32_t> vertex(0, vertices - 1);
+    std::vector<Graph::Edge> result(edges);
+    for (Graph::Edge& edge : result) {
+        edge.from = vertex(random);
+        edge.to = vertex(random);
+    }
+    return result;
+}
+
+// R-MAT generator with the Graph500 parameters: each edge picks one
+// quadrant of the adjacency matrix per bit of the vertex id with
+// probabilities a, b, c, d = 0.57, 0.19, 0.19, 0.05, giving a skewed,
+// low-diameter graph. Vertex ids are shuffled afterwards so high-degree
+// vertices are not clustered at the start. Every edge is added in both
+// directions, so the graph is its own transpose.
+inline Graph make_rmat_graph(unsigned scale, size_t edgeFactor, unsigned seed) {
+    uint32_t vertices = uint32_t(1) << scale;
+    std::mt19937_64 random(seed);
+    std::uniform_real_distribution<double> coin(0, 1);
+
+    std::vector<uint32_t> label(vertices);
+    for (uint32_t v = 0; v < vertices; ++v) {
+        label[v] = v;
+    }
+    std::shuffle(label.begin(), label.end(), random);
+
+    size_t count = edgeFactor * vertices;
+    std::vector<Graph::Edge> edges;
+    edges.reserve(2 * count);
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t from = 0;
+        uint32_t to = 0;
+        for (unsigned bit = 0; bit < scale; ++bit) {
+            double r = coin(random);
+            if (r >= 0.57) {
+                if (r < 0.76) {
+                    to |= uint32_t(1) << bit;
+                }
+                else if (r < 0.95) {
+                    from |= uint32_t(1) << bit;
+                }
+                else {
+                    from |= uint32_t(1) << bit;
+                    to |= uint32_t(1) << bit;
+                }
+            }
+        }
+        edges.push_back(Graph::Edge{ label[from], label[to] });
+        edges.push_back(Graph::Edge{ label[to], label[from] });
+    }
+    return Graph(vertices, edges);
+}
+
+#endif
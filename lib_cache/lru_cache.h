@@ -0,0 +1,222 @@
+#ifndef LRU_CACHE_H
+#define LRU_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "list.h"
+#include "hash_map.h"
+#include "error_policy.h"
+
+// Fixed-capacity cache that evicts the least recently used entry. Entries
+// sit in a List ordered from most to least recently used; a flat hash map
+// points from each key to its node, so a hit costs one lookup and one
+// relink. Not thread-safe; see ShardedLRUCache.
+template<typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+class LRUCache {
+public:
+    // Called with every entry pushed out by put(), after it has left the cache.
+    typedef std::function<void(const K&, const V&)> EvictionCallback;
+
+private:
+    struct Entry {
+        K key;
+        V value;
+    };
+
+    typedef typename List<Entry>::Iterator Node;
+
+    List<Entry> order;
+    FlatHashMap<K, Node, Hash, KeyEqual> index;
+    size_t limit;
+    EvictionCallback onEvict;
+    uint64_t hitCount;
+    uint64_t missCount;
+    uint64_t evictionCount;
+
+    void evictOldest() {
+        Entry victim = std::move(order.back());
+        index.erase(victim.key);
+        order.pop_back();
+        ++evictionCount;
+        if (onEvict) {
+            onEvict(victim.key, victim.value);
+        }
+    }
+
+public:
+    explicit LRUCache(size_t capacity, EvictionCallback onEvict = EvictionCallback())
+        : index(capacity), limit(capacity), onEvict(onEvict), hitCount(0), missCount(0), evictionCount(0) {
+        if (capacity == 0) {
+            ASD_THROW(std::invalid_argument("Cache capacity must be positive"));
+        }
+    }
+
+    // LRUCache holds iterators into its own list, so it is not copyable.
+    LRUCache(const LRUCache&) = delete;
+    LRUCache& operator=(const LRUCache&) = delete;
+
+    // Copies the value into `value` and marks the entry most recently used.
+    // Returns false, leaving `value` untouched, on a miss.
+    bool get(const K& key, V& value) {
+        auto found = index.find(key);
+        if (found == index.end()) {
+            ++missCount;
+            return false;
+        }
+        ++hitCount;
+        order.move_to_front(found->second);
+        value = (*found->second).value;
+        return true;
+    }
+
+    // Inserts or replaces the entry and marks it most recently used,
+    // evicting the least recently used one if the cache is full.
+    void put(const K& key, const V& value) {
+        auto found = index.find(key);
+        if (found != index.end()) {
+            (*found->second).value = value;
+            order.move_to_front(found->second);
+            return;
+        }
+        order.push_front(Entry{ key, value });
+        // A failed index insert (a rehash that cannot allocate, a throwing
+        // hash) must not leave a node no index entry points to.
+        ASD_TRY {
+            index.try_emplace(key, order.begin());
+        }
+        ASD_CATCH_ALL {
+            order.pop_front();
+            ASD_RETHROW;
+        }
+        if (order.size() > limit) {
+            evictOldest();
+        }
+    }
+
+    // Does not count as a use.
+    bool contains(const K& key) const { return index.contains(key); }
+
+    bool erase(const K& key) {
+        auto found = index.find(key);
+        if (found == index.end()) {
+            return false;
+        }
+        order.erase(found->second);
+        index.erase(key);
+        return true;
+    }
+
+    void clear() {
+        index.clear();
+        order.clear();
+    }
+
+    size_t size() const { return order.size(); }
+    size_t capacity() const { return limit; }
+
+    uint64_t hits() const { return hitCount; }
+    uint64_t misses() const { return missCount; }
+    uint64_t evictions() const { return evictionCount; }
+    void resetStats() {
+        hitCount = 0;
+        missCount = 0;
+        evictionCount = 0;
+    }
+};
+
+// LRUCache split into independently locked shards by key hash, so threads
+// working on different keys rarely contend. Recency is tracked per shard:
+// the entry evicted is the least recently used of its shard. The eviction
+// callback runs with that shard's lock held.
+template<typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+class ShardedLRUCache {
+public:
+    typedef typename LRUCache<K, V, Hash, KeyEqual>::EvictionCallback EvictionCallback;
+
+private:
+    struct Shard {
+        std::mutex lock;
+        LRUCache<K, V, Hash, KeyEqual> cache;
+
+        Shard(size_t capacity, const EvictionCallback& onEvict) : cache(capacity, onEvict) {}
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    Hash hasher;
+
+    Shard& shardFor(const K& key) const {
+        // The tables inside the shards index by the high bits of a
+        // Fibonacci product, so pick the shard from a different mix.
+        uint64_t h = static_cast<uint64_t>(hasher(key));
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDull;
+        h ^= h >> 33;
+        return *shards[h % shards.size()];
+    }
+
+public:
+    // capacity is split evenly across the shards, rounding up.
+    ShardedLRUCache(size_t capacity, size_t shardCount = 16, EvictionCallback onEvict = EvictionCallback()) {
+        if (capacity == 0 || shardCount == 0) {
+            ASD_THROW(std::invalid_argument("Cache capacity and shard count must be positive"));
+        }
+        size_t perShard = (capacity + shardCount - 1) / shardCount;
+        shards.reserve(shardCount);
+        for (size_t i = 0; i < shardCount; ++i) {
+            shards.push_back(std::unique_ptr<Shard>(new Shard(perShard, onEvict)));
+        }
+    }
+
+    bool get(const K& key, V& value) {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> guard(shard.lock);
+        return shard.cache.get(key, value);
+    }
+
+    void put(const K& key, const V& value) {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> guard(shard.lock);
+        shard.cache.put(key, value);
+    }
+
+    bool erase(const K& key) {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> guard(shard.lock);
+        return shard.cache.erase(key);
+    }
+
+    // Totals below lock one shard at a time, so they are not a snapshot
+    // while other threads keep using the cache.
+    size_t size() const {
+        size_t total = 0;
+        for (const std::unique_ptr<Shard>& shard : shards) {
+            std::lock_guard<std::mutex> guard(shard->lock);
+            total += shard->cache.size();
+        }
+        return total;
+    }
+
+    uint64_t hits() const { return sum(&LRUCache<K, V, Hash, KeyEqual>::hits); }
+    uint64_t misses() const { return sum(&LRUCache<K, V, Hash, KeyEqual>::misses); }
+    uint64_t evictions() const { return sum(&LRUCache<K, V, Hash, KeyEqual>::evictions); }
+
+    size_t shardCount() const { return shards.size(); }
+
+private:
+    uint64_t sum(uint64_t (LRUCache<K, V, Hash, KeyEqual>::*counter)() const) const {
+        uint64_t total = 0;
+        for (const std::unique_ptr<Shard>& shard : shards) {
+            std::lock_guard<std::mutex> guard(shard->lock);
+            total += (shard->cache.*counter)();
+        }
+        return total;
+    }
+};
+
+#endif
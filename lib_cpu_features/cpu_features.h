@@ -0,0 +1,28 @@
+#ifndef CPU_FEATURES_H
+#define CPU_FEATURES_H
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CPU_X86 1
+#endif
+
+// Kernels compiled for a specific instruction set are marked with these so
+// the rest of the translation unit keeps the baseline target; MSVC accepts
+// the intrinsics without any attribute.
+#if defined(CPU_X86) && (defined(__GNUC__) || defined(__clang__))
+#define CPU_TARGET_AVX2 __attribute__((target("avx2")))
+#define CPU_TARGET_AVX512BW __attribute__((target("avx512f,avx512bw")))
+#else
+#define CPU_TARGET_AVX2
+#define CPU_TARGET_AVX512BW
+#endif
+
+struct CpuFeatures {
+    bool sse2;
+    bool avx2;
+    bool avx512bw;
+};
+
+// Detected once; also checks that the OS saves the wide registers.
+const CpuFeatures& cpu_features();
+
+#endif
@@ -1,11 +1,216 @@
 // Copyright 2024 Marina Usova
 
+#include <limits>
 #include <stdexcept>
+#include <thread>
+#include <vector>
 #include "../lib_easy_example/easy_example.h"
+#include "cpu_features.h"
+#include "error_policy.h"
+
+#if defined(CPU_X86)
+#include <immintrin.h>
+#endif
 
 float division(int a, int b) {
     if (b == 0) {
-        throw std::invalid_argument("Input Error: can't divide by zero!");
+        ASD_THROW(std::invalid_argument("Input Error: can't divide by zero!"));
     }
     return static_cast<float>(a) / b;
 }
+
+namespace {
+
+// The kernels work on blocks of 64 pairs, one word of the error mask each;
+// they return the number of zero divisors.
+const size_t BLOCK = 64;
+
+typedef size_t (*DivisionBlocks)(const int* a, const int* b, float* out,
+                                 size_t blocks, uint64_t* errors);
+
+inline size_t record_zeros(uint64_t bits, uint64_t* errors, size_t word) {
+    if (errors != nullptr) {
+        errors[word] = bits;
+    }
+    size_t zeros = 0;
+    for (; bits != 0; bits &= bits - 1) {
+        ++zeros;
+    }
+    return zeros;
+}
+
+// Up to BLOCK pairs; returns their zero-divisor bits.
+uint64_t divide_scalar(const int* a, const int* b, float* out, size_t count) {
+    uint64_t bits = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (b[i] == 0) {
+            out[i] = std::numeric_limits<float>::quiet_NaN();
+            bits |= uint64_t(1) << i;
+        }
+        else {
+            out[i] = static_cast<float>(a[i]) / b[i];
+        }
+    }
+    return bits;
+}
+
+size_t divide_blocks_scalar(const int* a, const int* b, float* out,
+                            size_t blocks, uint64_t* errors) {
+    size_t zeros = 0;
+    for (size_t block = 0; block < blocks; ++block) {
+        size_t at = block * BLOCK;
+        zeros += record_zeros(divide_scalar(a + at, b + at, out + at, BLOCK), errors, block);
+    }
+    return zeros;
+}
+
+#if defined(CPU_X86)
+
+// Both convert the pair to float and divide, as division() does, then
+// overwrite the lanes with a zero divisor by NaN.
+size_t divide_blocks_sse2(const int* a, const int* b, float* out,
+                          size_t blocks, uint64_t* errors) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128 nan = _mm_set1_ps(std::numeric_limits<float>::quiet_NaN());
+    size_t zeros = 0;
+    for (size_t block = 0; block < blocks; ++block) {
+        uint64_t bits = 0;
+        for (size_t j = 0; j < BLOCK; j += 4) {
+            size_t at = block * BLOCK + j;
+            __m128i divisor = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + at));
+            __m128i dividend = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + at));
+            __m128 isZero = _mm_castsi128_ps(_mm_cmpeq_epi32(divisor, zero));
+            __m128 quotient = _mm_div_ps(_mm_cvtepi32_ps(dividend), _mm_cvtepi32_ps(divisor));
+            _mm_storeu_ps(out + at, _mm_or_ps(_mm_andnot_ps(isZero, quotient), _mm_and_ps(isZero, nan)));
+            bits |= static_cast<uint64_t>(_mm_movemask_ps(isZero)) << j;
+        }
+        zeros += record_zeros(bits, errors, block);
+    }
+    return zeros;
+}
+
+CPU_TARGET_AVX2 size_t divide_blocks_avx2(const int* a, const int* b, float* out,
+                                          size_t blocks, uint64_t* errors) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256 nan = _mm256_set1_ps(std::numeric_limits<float>::quiet_NaN());
+    size_t zeros = 0;
+    for (size_t block = 0; block < blocks; ++block) {
+        uint64_t bits = 0;
+        for (size_t j = 0; j < BLOCK; j += 8) {
+            size_t at = block * BLOCK + j;
+            __m256i divisor = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + at));
+            __m256i dividend = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + at));
+            __m256 isZero = _mm256_castsi256_ps(_mm256_cmpeq_epi32(divisor, zero));
+            __m256 quotient = _mm256_div_ps(_mm256_cvtepi32_ps(dividend), _mm256_cvtepi32_ps(divisor));
+            _mm256_storeu_ps(out + at, _mm256_blendv_ps(quotient, nan, isZero));
+            bits |= static_cast<uint64_t>(_mm256_movemask_ps(isZero)) << j;
+        }
+        zeros += record_zeros(bits, errors, block);
+    }
+    return zeros;
+}
+
+#endif
+
+DivisionKernel best_division_kernel() {
+#if defined(CPU_X86)
+    return cpu_features().avx2 ? DivisionKernel::AVX2 : DivisionKernel::SSE2;
+#else
+    return DivisionKernel::SCALAR;
+#endif
+}
+
+DivisionBlocks division_blocks(DivisionKernel kernel) {
+    if (kernel == DivisionKernel::AUTO) {
+        static const DivisionKernel best = best_division_kernel();
+        kernel = best;
+    }
+    if (!division_kernel_supported(kernel)) {
+        return nullptr;
+    }
+    switch (kernel) {
+#if defined(CPU_X86)
+    case DivisionKernel::SSE2:
+        return divide_blocks_sse2;
+    case DivisionKernel::AVX2:
+        return divide_blocks_avx2;
+#endif
+    default:
+        return divide_blocks_scalar;
+    }
+}
+
+}  // namespace
+
+bool division_kernel_supported(DivisionKernel kernel) {
+    switch (kernel) {
+    case DivisionKernel::AUTO:
+    case DivisionKernel::SCALAR:
+        return true;
+#if defined(CPU_X86)
+    case DivisionKernel::SSE2:
+        return cpu_features().sse2;
+    case DivisionKernel::AVX2:
+        return cpu_features().avx2;
+#endif
+    default:
+        return false;
+    }
+}
+
+size_t division_batch(const int* a, const int* b, float* out, size_t n,
+                      uint64_t* errors, DivisionKernel kernel) {
+    DivisionBlocks divide = division_blocks(kernel);
+    if (divide == nullptr) {
+        ASD_THROW(std::invalid_argument("Division kernel is not supported by this CPU"));
+    }
+    size_t blocks = n / BLOCK;
+    size_t zeros = divide(a, b, out, blocks, errors);
+    size_t done = blocks * BLOCK;
+    if (done < n) {
+        zeros += record_zeros(divide_scalar(a + done, b + done, out + done, n - done), errors, blocks);
+    }
+    return zeros;
+}
+
+size_t division_batch_parallel(const int* a, const int* b, float* out, size_t n,
+                               uint64_t* errors, unsigned threads) {
+    if (threads == 0) {
+        threads = std::thread::hardware_concurrency();
+    }
+    size_t useful = n / DIVISION_MIN_PER_THREAD;
+    if (threads > useful) {
+        threads = static_cast<unsigned>(useful);
+    }
+    if (threads <= 1) {
+        return division_batch(a, b, out, n, errors);
+    }
+
+    // Whole blocks per thread, so no two threads write one error word.
+    size_t chunk = (n + threads - 1) / threads;
+    chunk = (chunk + BLOCK - 1) / BLOCK * BLOCK;
+    std::vector<size_t> zeros(threads, 0);
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (unsigned t = 1; t < threads; ++t) {
+        size_t begin = t * chunk;
+        if (begin >= n) {
+            break;
+        }
+        size_t count = n - begin < chunk ? n - begin : chunk;
+        uint64_t* words = errors == nullptr ? nullptr : errors + begin / BLOCK;
+        pool.emplace_back([=, &zeros]() {
+            zeros[t] = division_batch(a + begin, b + begin, out + begin, count, words);
+        });
+    }
+    zeros[0] = division_batch(a, b, out, chunk, errors);
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+
+    size_t total = 0;
+    for (size_t part : zeros) {
+        total += part;
+    }
+    return total;
+}
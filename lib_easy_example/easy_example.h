@@ -3,6 +3,37 @@
 #ifndef LIB_EASY_EXAMPLE_EASY_EXAMPLE_H_
 #define LIB_EASY_EXAMPLE_EASY_EXAMPLE_H_
 
+#include <cstddef>
+#include <cstdint>
+
 float division(int a, int b);
 
+// Instruction sets for division_batch; AUTO picks the widest one the CPU
+// supports.
+enum class DivisionKernel {
+    AUTO,
+    SCALAR,
+    SSE2,
+    AVX2
+};
+
+bool division_kernel_supported(DivisionKernel kernel);
+
+// out[i] = division(a[i], b[i]) for n pairs, without exceptions: a zero
+// divisor gives NaN. If errors is not null it receives (n + 63) / 64
+// words, bit i % 64 of errors[i / 64] set where b[i] is zero. Returns the
+// number of zero divisors. Throws std::invalid_argument only if the
+// requested kernel is not supported.
+size_t division_batch(const int* a, const int* b, float* out, size_t n,
+                      uint64_t* errors = nullptr,
+                      DivisionKernel kernel = DivisionKernel::AUTO);
+
+// The same split over up to `threads` threads (0 means one per hardware
+// thread). Pays off only for very large arrays, so every thread gets at
+// least DIVISION_MIN_PER_THREAD pairs.
+const size_t DIVISION_MIN_PER_THREAD = size_t(1) << 16;
+
+size_t division_batch_parallel(const int* a, const int* b, float* out, size_t n,
+                               uint64_t* errors = nullptr, unsigned threads = 0);
+
 #endif  // LIB_EASY_EXAMPLE_EASY_EXAMPLE_H_
@@ -0,0 +1,10 @@
+#include <cstdio>
+#include <cstdlib>
+#include "error_policy.h"
+
+void fail_fast(const char* what) {
+    std::fputs(what, stderr);
+    std::fputc('\n', stderr);
+    std::fflush(stderr);
+    std::abort();
+}
@@ -0,0 +1,31 @@
+#ifndef ERROR_POLICY_H
+#define ERROR_POLICY_H
+
+// How the libraries report a broken precondition.
+//
+// With exceptions enabled ASD_THROW throws as always. Built with
+// exceptions disabled (CMake option BNO_EXCEPTIONS) the same call sites
+// print the message and abort instead, so code that must never stop uses
+// the try_ members, which report failure through their return value.
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+#define ASD_EXCEPTIONS 1
+#else
+#define ASD_EXCEPTIONS 0
+#endif
+
+// Prints what to stderr and aborts.
+[[noreturn]] void fail_fast(const char* what);
+
+#if ASD_EXCEPTIONS
+#define ASD_THROW(exception) throw exception
+#define ASD_TRY try
+#define ASD_CATCH_ALL catch (...)
+#define ASD_RETHROW throw
+#else
+#define ASD_THROW(exception) fail_fast((exception).what())
+#define ASD_TRY if (true)
+#define ASD_CATCH_ALL else
+#define ASD_RETHROW ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,72 @@
+#include <stdexcept>
+#include "graph.h"
+#include "error_policy.h"
+
+Graph::Graph() : offsets(1, 0) {}
+
+Graph::Graph(size_t vertexCount, const std::vector<Edge>& edges)
+    : Graph(vertexCount, edges.data(), edges.size()) {}
+
+Graph::Graph(size_t vertexCount, const Edge* edges, size_t edgeCount)
+    : offsets(vertexCount + 1, 0), targets(edgeCount) {
+    if (vertexCount > UINT32_MAX) {
+        ASD_THROW(std::length_error("Too many vertices"));
+    }
+    for (size_t i = 0; i < edgeCount; ++i) {
+        if (edges[i].from >= vertexCount || edges[i].to >= vertexCount) {
+            ASD_THROW(std::out_of_range("Edge endpoint out of range"));
+        }
+        ++offsets[edges[i].from + 1];
+    }
+    for (size_t v = 0; v < vertexCount; ++v) {
+        offsets[v + 1] += offsets[v];
+    }
+
+    // offsets[v] is used as the fill cursor of row v, which leaves it at
+    // the start of row v + 1; shifting back restores the row starts.
+    for (size_t i = 0; i < edgeCount; ++i) {
+        targets[offsets[edges[i].from]++] = edges[i].to;
+    }
+    for (size_t v = vertexCount; v > 0; --v) {
+        offsets[v] = offsets[v - 1];
+    }
+    offsets[0] = 0;
+}
+
+size_t Graph::degree(uint32_t vertex) const {
+    if (vertex >= vertexCount()) {
+        ASD_THROW(std::out_of_range("Vertex out of range"));
+    }
+    return offsets[vertex + 1] - offsets[vertex];
+}
+
+Graph::Neighbors Graph::neighbors(uint32_t vertex) const {
+    if (vertex >= vertexCount()) {
+        ASD_THROW(std::out_of_range("Vertex out of range"));
+    }
+    const uint32_t* base = targets.data();
+    return Neighbors(base + offsets[vertex], base + offsets[vertex + 1]);
+}
+
+Graph Graph::transpose() const {
+    size_t n = vertexCount();
+    Graph result;
+    result.offsets.assign(n + 1, 0);
+    result.targets.resize(targets.size());
+    for (uint32_t to : targets) {
+        ++result.offsets[to + 1];
+    }
+    for (size_t v = 0; v < n; ++v) {
+        result.offsets[v + 1] += result.offsets[v];
+    }
+    for (size_t v = 0; v < n; ++v) {
+        for (size_t e = offsets[v]; e < offsets[v + 1]; ++e) {
+            result.targets[result.offsets[targets[e]]++] = static_cast<uint32_t>(v);
+        }
+    }
+    for (size_t v = n; v > 0; --v) {
+        result.offsets[v] = result.offsets[v - 1];
+    }
+    result.offsets[0] = 0;
+    return result;
+}
@@ -0,0 +1,56 @@
+#ifndef GRAPH_H
+#define GRAPH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Directed graph in compressed sparse row form: the neighbors of vertex v
+// are targets[offsets[v], offsets[v + 1]). Immutable once built; add the
+// reverse of every edge to model an undirected graph.
+class Graph {
+public:
+    struct Edge {
+        uint32_t from;
+        uint32_t to;
+    };
+
+    // Contiguous view of one adjacency list.
+    class Neighbors {
+    private:
+        const uint32_t* first;
+        const uint32_t* last;
+
+    public:
+        Neighbors(const uint32_t* first, const uint32_t* last) : first(first), last(last) {}
+        const uint32_t* begin() const { return first; }
+        const uint32_t* end() const { return last; }
+        size_t size() const { return static_cast<size_t>(last - first); }
+        bool empty() const { return first == last; }
+    };
+
+private:
+    std::vector<size_t> offsets;
+    std::vector<uint32_t> targets;
+
+public:
+    Graph();
+    // Counting sort by source, O(V + E). Neighbors keep their order in
+    // `edges`. Throws std::out_of_range for an endpoint >= vertexCount.
+    Graph(size_t vertexCount, const std::vector<Edge>& edges);
+    Graph(size_t vertexCount, const Edge* edges, size_t edgeCount);
+
+    size_t vertexCount() const { return offsets.size() - 1; }
+    size_t edgeCount() const { return targets.size(); }
+
+    size_t degree(uint32_t vertex) const;
+    Neighbors neighbors(uint32_t vertex) const;
+
+    // Same vertices with every edge reversed.
+    Graph transpose() const;
+
+    const std::vector<size_t>& rowOffsets() const { return offsets; }
+    const std::vector<uint32_t>& columns() const { return targets; }
+};
+
+#endif
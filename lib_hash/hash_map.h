@@ -0,0 +1,539 @@
+#ifndef HASH_MAP_H
+#define HASH_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "error_policy.h"
+
+// Transparent hash and equality for string keys: lookups with a const char*
+// or a (pointer, length) view do not build a temporary std::string.
+struct StringView {
+    const char* data;
+    size_t size;
+
+    StringView(const char* text) : data(text), size(std::strlen(text)) {}
+    StringView(const char* text, size_t length) : data(text), size(length) {}
+    StringView(const std::string& text) : data(text.data()), size(text.size()) {}
+};
+
+struct StringHash {
+    typedef void is_transparent;
+
+    size_t operator()(StringView text) const {
+        // 8 bytes per step, multiply-xorshift mixing.
+        const uint64_t K = 0x9E3779B97F4A7C15ull;
+        uint64_t h = text.size * K;
+        size_t i = 0;
+        for (; i + 8 <= text.size; i += 8) {
+            uint64_t word;
+            std::memcpy(&word, text.data + i, 8);
+            h = (h ^ word) * K;
+            h ^= h >> 29;
+        }
+        uint64_t tail = 0;
+        std::memcpy(&tail, text.data + i, text.size - i);
+        h = (h ^ tail) * K;
+        return static_cast<size_t>(h ^ (h >> 32));
+    }
+};
+
+struct StringEqual {
+    typedef void is_transparent;
+
+    bool operator()(StringView a, StringView b) const {
+        return a.size == b.size && std::memcmp(a.data, b.data, a.size) == 0;
+    }
+};
+
+namespace hash_detail {
+
+template<typename...>
+struct Void {
+    typedef void type;
+};
+
+template<typename Hash, typename KeyEqual, typename = void>
+struct IsTransparent : std::false_type {};
+
+template<typename Hash, typename KeyEqual>
+struct IsTransparent<Hash, KeyEqual,
+                     typename Void<typename Hash::is_transparent, typename KeyEqual::is_transparent>::type>
+    : std::true_type {};
+
+template<typename Key, typename Value>
+struct MapKey {
+    const Key& operator()(const std::pair<Key, Value>& entry) const { return entry.first; }
+};
+
+template<typename Key>
+struct SetKey {
+    const Key& operator()(const Key& entry) const { return entry; }
+};
+
+// Open addressing with linear probing and Robin Hood displacement: an
+// entry is stored with its distance from its home slot plus one (0 means
+// empty), and inserts shift poorer entries further along so probe lengths
+// stay short and even. Lookups stop as soon as they meet an entry closer
+// to home than the key would be. Erase shifts the following run back by
+// one slot instead of leaving tombstones.
+template<typename Key, typename Entry, typename KeyOf, typename Hash, typename KeyEqual>
+class RobinHoodTable {
+protected:
+    static const size_t NPOS = static_cast<size_t>(-1);
+    static const uint16_t MAX_DISTANCE = 0x7FFF;
+    static const size_t MIN_CAPACITY = 16;
+
+    Entry* slots;
+    uint16_t* distances;
+    size_t slotCount;
+    size_t used;
+    unsigned shift;
+    Hash hasher;
+    KeyEqual equal;
+
+    // Selects the constructor that leaves the table without slots.
+    struct NoSlots {};
+
+    RobinHoodTable(NoSlots, const Hash& hash, const KeyEqual& keyEqual)
+        : slots(nullptr), distances(nullptr), slotCount(0), used(0), shift(64),
+          hasher(hash), equal(keyEqual) {}
+
+    template<typename K>
+    size_t home(const K& key) const {
+        // Fibonacci hashing: the high bits of the product spread even
+        // identity hashes of sequential keys over the whole table.
+        return static_cast<size_t>((static_cast<uint64_t>(hasher(key)) * 0x9E3779B97F4A7C15ull) >> shift);
+    }
+
+    template<typename K>
+    size_t findIndex(const K& key) const {
+        if (used == 0) {
+            return NPOS;
+        }
+        size_t mask = slotCount - 1;
+        size_t i = home(key);
+        for (uint16_t d = 1; distances[i] >= d; ++d) {
+            if (distances[i] == d && equal(KeyOf()(slots[i]), key)) {
+                return i;
+            }
+            i = (i + 1) & mask;
+        }
+        return NPOS;
+    }
+
+    // Places an entry whose key is known to be absent; returns its slot.
+    // entry is moved from when it is an rvalue, copied otherwise.
+    template<typename E>
+    size_t insertNew(E&& entry) {
+        if (used + 1 > slotCount / 8 * 7) {
+            rehash(slotCount == 0 ? MIN_CAPACITY : slotCount * 2);
+        }
+        size_t mask = slotCount - 1;
+        size_t i = home(KeyOf()(entry));
+        uint16_t d = 1;
+        while (distances[i] >= d) {
+            i = (i + 1) & mask;
+            if (++d > MAX_DISTANCE) {
+                ASD_THROW(std::length_error("Too many keys with colliding hashes"));
+            }
+        }
+        // Entries from i up to the next empty slot move one slot along.
+        size_t last = i;
+        while (distances[last] != 0) {
+            if (distances[last] == MAX_DISTANCE) {
+                ASD_THROW(std::length_error("Too many keys with colliding hashes"));
+            }
+            last = (last + 1) & mask;
+        }
+        if (last != i) {
+            size_t previous = (last - 1) & mask;
+            new (slots + last) Entry(std::move(slots[previous]));
+            distances[last] = distances[previous] + 1;
+            for (size_t j = previous; j != i; j = previous) {
+                previous = (j - 1) & mask;
+                slots[j] = std::move(slots[previous]);
+                distances[j] = distances[previous] + 1;
+            }
+            slots[i] = std::forward<E>(entry);
+        }
+        else {
+            new (slots + i) Entry(std::forward<E>(entry));
+        }
+        distances[i] = d;
+        ++used;
+        return i;
+    }
+
+    void eraseAt(size_t i) {
+        size_t mask = slotCount - 1;
+        size_t next = (i + 1) & mask;
+        while (distances[next] > 1) {
+            slots[i] = std::move(slots[next]);
+            distances[i] = distances[next] - 1;
+            i = next;
+            next = (next + 1) & mask;
+        }
+        slots[i].~Entry();
+        distances[i] = 0;
+        --used;
+    }
+
+    // Builds the new table on the side and swaps it in only once every
+    // entry is placed. Entries are moved when their move cannot throw and
+    // copied otherwise, so a throwing copy leaves this table as it was (a
+    // throwing hash may leave moved-from entries behind). The old entries
+    // are destroyed with the side table after the swap.
+    void rehash(size_t newSlotCount) {
+        RobinHoodTable fresh(NoSlots(), hasher, equal);
+        std::unique_ptr<uint16_t[]> newDistances(new uint16_t[newSlotCount]());
+        fresh.slots = std::allocator<Entry>().allocate(newSlotCount);
+        fresh.distances = newDistances.release();
+        fresh.slotCount = newSlotCount;
+        for (size_t n = newSlotCount; n > 1; n >>= 1) {
+            --fresh.shift;
+        }
+
+        for (size_t i = 0; i < slotCount; ++i) {
+            if (distances[i] != 0) {
+                fresh.insertNew(std::move_if_noexcept(slots[i]));
+            }
+        }
+        swap(fresh);
+    }
+
+    void release() {
+        clear();
+        if (slots != nullptr) {
+            std::allocator<Entry>().deallocate(slots, slotCount);
+        }
+        delete[] distances;
+        slots = nullptr;
+        distances = nullptr;
+        slotCount = 0;
+    }
+
+    template<typename K>
+    using EnableTransparent = typename std::enable_if<IsTransparent<Hash, KeyEqual>::value, K>::type;
+
+public:
+    template<bool Const>
+    class IteratorBase {
+    private:
+        friend class RobinHoodTable;
+        typedef typename std::conditional<Const, const RobinHoodTable*, RobinHoodTable*>::type Table;
+        Table table;
+        size_t index;
+
+        void skipEmpty() {
+            while (index < table->slotCount && table->distances[index] == 0) {
+                ++index;
+            }
+        }
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Entry value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef typename std::conditional<Const, const Entry&, Entry&>::type reference;
+        typedef typename std::conditional<Const, const Entry*, Entry*>::type pointer;
+
+        IteratorBase(Table table, size_t index) : table(table), index(index) { skipEmpty(); }
+        // A mutable iterator converts to a const one.
+        template<bool OtherConst, typename = typename std::enable_if<Const && !OtherConst>::type>
+        IteratorBase(const IteratorBase<OtherConst>& other) : table(other.table), index(other.index) {}
+
+        reference operator*() const { return table->slots[index]; }
+        pointer operator->() const { return table->slots + index; }
+        IteratorBase& operator++() {
+            ++index;
+            skipEmpty();
+            return *this;
+        }
+        IteratorBase operator++(int) {
+            IteratorBase old = *this;
+            ++*this;
+            return old;
+        }
+        bool operator==(const IteratorBase& other) const { return index == other.index; }
+        bool operator!=(const IteratorBase& other) const { return index != other.index; }
+
+        template<bool> friend class IteratorBase;
+    };
+
+    typedef IteratorBase<false> iterator;
+    typedef IteratorBase<true> const_iterator;
+
+    explicit RobinHoodTable(size_t expected = 0, const Hash& hash = Hash(), const KeyEqual& keyEqual = KeyEqual())
+        : slots(nullptr), distances(nullptr), slotCount(0), used(0), shift(64),
+          hasher(hash), equal(keyEqual) {
+        reserve(expected);
+    }
+
+    RobinHoodTable(const RobinHoodTable& other)
+        : slots(nullptr), distances(nullptr), slotCount(0), used(0), shift(64),
+          hasher(other.hasher), equal(other.equal) {
+        reserve(other.used);
+        for (size_t i = 0; i < other.slotCount; ++i) {
+            if (other.distances[i] != 0) {
+                insertNew(Entry(other.slots[i]));
+            }
+        }
+    }
+
+    RobinHoodTable(RobinHoodTable&& other) noexcept
+        : slots(other.slots), distances(other.distances), slotCount(other.slotCount),
+          used(other.used), shift(other.shift), hasher(other.hasher), equal(other.equal) {
+        other.slots = nullptr;
+        other.distances = nullptr;
+        other.slotCount = 0;
+        other.used = 0;
+        other.shift = 64;
+    }
+
+    RobinHoodTable& operator=(RobinHoodTable other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    ~RobinHoodTable() {
+        release();
+    }
+
+    void swap(RobinHoodTable& other) noexcept {
+        std::swap(slots, other.slots);
+        std::swap(distances, other.distances);
+        std::swap(slotCount, other.slotCount);
+        std::swap(used, other.used);
+        std::swap(shift, other.shift);
+        std::swap(hasher, other.hasher);
+        std::swap(equal, other.equal);
+    }
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, slotCount); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, slotCount); }
+
+    bool empty() const { return used == 0; }
+    size_t size() const { return used; }
+    // Number of slots; up to 7/8 of them are used before the table grows.
+    size_t capacity() const { return slotCount; }
+    double load_factor() const { return slotCount == 0 ? 0.0 : static_cast<double>(used) / slotCount; }
+
+    // Makes room for `expected` entries without further rehashing.
+    void reserve(size_t expected) {
+        size_t needed = MIN_CAPACITY;
+        while (needed / 8 * 7 < expected) {
+            needed *= 2;
+        }
+        if (needed > slotCount) {
+            rehash(needed);
+        }
+    }
+
+    void clear() {
+        for (size_t i = 0; i < slotCount; ++i) {
+            if (distances[i] != 0) {
+                slots[i].~Entry();
+                distances[i] = 0;
+            }
+        }
+        used = 0;
+    }
+
+    iterator find(const Key& key) {
+        size_t i = findIndex(key);
+        return iterator(this, i == NPOS ? slotCount : i);
+    }
+
+    const_iterator find(const Key& key) const {
+        size_t i = findIndex(key);
+        return const_iterator(this, i == NPOS ? slotCount : i);
+    }
+
+    bool contains(const Key& key) const { return findIndex(key) != NPOS; }
+    size_t count(const Key& key) const { return contains(key) ? 1 : 0; }
+
+    // Returns the number of entries removed (0 or 1).
+    size_t erase(const Key& key) {
+        size_t i = findIndex(key);
+        if (i == NPOS) {
+            return 0;
+        }
+        eraseAt(i);
+        return 1;
+    }
+
+    // Heterogeneous overloads, available when Hash and KeyEqual both
+    // declare is_transparent.
+    template<typename K, typename = EnableTransparent<K>>
+    iterator find(const K& key) {
+        size_t i = findIndex(key);
+        return iterator(this, i == NPOS ? slotCount : i);
+    }
+
+    template<typename K, typename = EnableTransparent<K>>
+    const_iterator find(const K& key) const {
+        size_t i = findIndex(key);
+        return const_iterator(this, i == NPOS ? slotCount : i);
+    }
+
+    template<typename K, typename = EnableTransparent<K>>
+    bool contains(const K& key) const { return findIndex(key) != NPOS; }
+
+    template<typename K, typename = EnableTransparent<K>>
+    size_t erase(const K& key) {
+        size_t i = findIndex(key);
+        if (i == NPOS) {
+            return 0;
+        }
+        eraseAt(i);
+        return 1;
+    }
+};
+
+template<typename Key, typename Entry, typename KeyOf, typename Hash, typename KeyEqual>
+const size_t RobinHoodTable<Key, Entry, KeyOf, Hash, KeyEqual>::NPOS;
+
+template<typename Key, typename Entry, typename KeyOf, typename Hash, typename KeyEqual>
+const uint16_t RobinHoodTable<Key, Entry, KeyOf, Hash, KeyEqual>::MAX_DISTANCE;
+
+template<typename Key, typename Entry, typename KeyOf, typename Hash, typename KeyEqual>
+const size_t RobinHoodTable<Key, Entry, KeyOf, Hash, KeyEqual>::MIN_CAPACITY;
+
+}  // namespace hash_detail
+
+// Flat hash map: entries live in one array, so a lookup touches one or two
+// cache lines instead of a bucket and a node. Entries move on insert and
+// erase, which invalidates iterators and references. Keys must not be
+// modified through an iterator. Value needs no default constructor unless
+// operator[] is used.
+template<typename Key, typename Value, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class FlatHashMap
+    : public hash_detail::RobinHoodTable<Key, std::pair<Key, Value>, hash_detail::MapKey<Key, Value>, Hash, KeyEqual> {
+private:
+    typedef hash_detail::RobinHoodTable<Key, std::pair<Key, Value>, hash_detail::MapKey<Key, Value>, Hash, KeyEqual> Table;
+
+public:
+    typedef std::pair<Key, Value> value_type;
+    typedef typename Table::iterator iterator;
+    typedef typename Table::const_iterator const_iterator;
+
+    using Table::Table;
+
+    // Inserts {key, Value(args...)} unless key is present; the bool is
+    // true if an insertion happened.
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+        size_t i = this->findIndex(key);
+        if (i != Table::NPOS) {
+            return std::make_pair(iterator(this, i), false);
+        }
+        i = this->insertNew(value_type(std::piecewise_construct, std::forward_as_tuple(key),
+                                       std::forward_as_tuple(std::forward<Args>(args)...)));
+        return std::make_pair(iterator(this, i), true);
+    }
+
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(Key&& key, Args&&... args) {
+        size_t i = this->findIndex(key);
+        if (i != Table::NPOS) {
+            return std::make_pair(iterator(this, i), false);
+        }
+        i = this->insertNew(value_type(std::piecewise_construct, std::forward_as_tuple(std::move(key)),
+                                       std::forward_as_tuple(std::forward<Args>(args)...)));
+        return std::make_pair(iterator(this, i), true);
+    }
+
+    std::pair<iterator, bool> insert(const value_type& entry) {
+        return try_emplace(entry.first, entry.second);
+    }
+
+    std::pair<iterator, bool> insert(value_type&& entry) {
+        return try_emplace(std::move(entry.first), std::move(entry.second));
+    }
+
+    // Inserts or overwrites.
+    template<typename V>
+    std::pair<iterator, bool> insert_or_assign(const Key& key, V&& value) {
+        std::pair<iterator, bool> result = try_emplace(key, std::forward<V>(value));
+        if (!result.second) {
+            result.first->second = std::forward<V>(value);
+        }
+        return result;
+    }
+
+    Value& operator[](const Key& key) {
+        return try_emplace(key).first->second;
+    }
+
+    Value& operator[](Key&& key) {
+        return try_emplace(std::move(key)).first->second;
+    }
+
+    Value& at(const Key& key) {
+        iterator it = this->find(key);
+        if (it == this->end()) {
+            ASD_THROW(std::out_of_range("Key not found"));
+        }
+        return it->second;
+    }
+
+    const Value& at(const Key& key) const {
+        const_iterator it = this->find(key);
+        if (it == this->end()) {
+            ASD_THROW(std::out_of_range("Key not found"));
+        }
+        return it->second;
+    }
+};
+
+// Flat hash set with the same layout and rules as FlatHashMap.
+template<typename Key, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class FlatHashSet : public hash_detail::RobinHoodTable<Key, Key, hash_detail::SetKey<Key>, Hash, KeyEqual> {
+private:
+    typedef hash_detail::RobinHoodTable<Key, Key, hash_detail::SetKey<Key>, Hash, KeyEqual> Table;
+
+public:
+    typedef Key value_type;
+    typedef typename Table::const_iterator iterator;
+    typedef typename Table::const_iterator const_iterator;
+
+    using Table::Table;
+
+    const_iterator begin() const { return Table::begin(); }
+    const_iterator end() const { return Table::end(); }
+
+    const_iterator find(const Key& key) const { return Table::find(key); }
+
+    template<typename K, typename = typename Table::template EnableTransparent<K>>
+    const_iterator find(const K& key) const { return Table::find(key); }
+
+    std::pair<const_iterator, bool> insert(const Key& key) {
+        size_t i = this->findIndex(key);
+        if (i != Table::NPOS) {
+            return std::make_pair(const_iterator(this, i), false);
+        }
+        return std::make_pair(const_iterator(this, this->insertNew(Key(key))), true);
+    }
+
+    std::pair<const_iterator, bool> insert(Key&& key) {
+        size_t i = this->findIndex(key);
+        if (i != Table::NPOS) {
+            return std::make_pair(const_iterator(this, i), false);
+        }
+        return std::make_pair(const_iterator(this, this->insertNew(std::move(key))), true);
+    }
+};
+
+#endif
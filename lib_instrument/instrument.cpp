@@ -0,0 +1,135 @@
+#include <mutex>
+#include <sstream>
+#include "instrument.h"
+
+namespace {
+
+struct Registry {
+    std::mutex lock;
+    ContainerProbe* first;
+    size_t count;
+
+    Registry() : first(nullptr), count(0) {}
+};
+
+// Never destroyed: static containers may unregister during exit.
+Registry& registry() {
+    static Registry* instance = new Registry();
+    return *instance;
+}
+
+void write_json_string(std::ostream& out, const std::string& text) {
+    const char* HEX = "0123456789abcdef";
+    out << '"';
+    for (char c : text) {
+        unsigned char byte = static_cast<unsigned char>(c);
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        }
+        else if (byte < 0x20) {
+            out << "\\u00" << HEX[byte >> 4] << HEX[byte & 15];
+        }
+        else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+}  // namespace
+
+ContainerProbe::ContainerProbe(const char* type, size_t elementSize)
+    : typeName(type), elementSize(elementSize), operations(0), allocations(0), bytesAllocated(0),
+      resizes(0), currentSize(0), peakSize(0), currentCapacity(0), peakCapacity(0), previous(nullptr) {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> guard(r.lock);
+    next = r.first;
+    if (next != nullptr) {
+        next->previous = this;
+    }
+    r.first = this;
+    ++r.count;
+}
+
+ContainerProbe::ContainerProbe(const ContainerProbe& other) : ContainerProbe(other.typeName, other.elementSize) {}
+
+ContainerProbe::~ContainerProbe() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> guard(r.lock);
+    if (previous != nullptr) {
+        previous->next = next;
+    }
+    else {
+        r.first = next;
+    }
+    if (next != nullptr) {
+        next->previous = previous;
+    }
+    --r.count;
+}
+
+void ContainerProbe::setLabel(const std::string& label) {
+    std::lock_guard<std::mutex> guard(registry().lock);
+    name = label;
+}
+
+ContainerStats ContainerProbe::stats() const {
+    ContainerStats result;
+    result.type = typeName;
+    result.label = name;
+    result.elementSize = elementSize;
+    result.operations = operations.load(std::memory_order_relaxed);
+    result.allocations = allocations.load(std::memory_order_relaxed);
+    result.bytesAllocated = bytesAllocated.load(std::memory_order_relaxed);
+    result.resizes = resizes.load(std::memory_order_relaxed);
+    result.size = currentSize.load(std::memory_order_relaxed);
+    result.peakSize = peakSize.load(std::memory_order_relaxed);
+    result.capacity = currentCapacity.load(std::memory_order_relaxed);
+    result.peakCapacity = peakCapacity.load(std::memory_order_relaxed);
+    return result;
+}
+
+size_t ContainerRegistry::liveCount() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> guard(r.lock);
+    return r.count;
+}
+
+std::vector<ContainerStats> ContainerRegistry::snapshot() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> guard(r.lock);
+    std::vector<ContainerStats> result;
+    result.reserve(r.count);
+    for (const ContainerProbe* probe = r.first; probe != nullptr; probe = probe->next) {
+        result.push_back(probe->stats());
+    }
+    return result;
+}
+
+void ContainerRegistry::dumpJson(std::ostream& out) {
+    std::vector<ContainerStats> all = snapshot();
+    out << "{\"containers\": [";
+    for (size_t i = 0; i < all.size(); ++i) {
+        const ContainerStats& s = all[i];
+        out << (i == 0 ? "\n" : ",\n") << "  {\"type\": ";
+        write_json_string(out, s.type);
+        out << ", \"label\": ";
+        write_json_string(out, s.label);
+        out << ", \"element_size\": " << s.elementSize
+            << ", \"operations\": " << s.operations
+            << ", \"allocations\": " << s.allocations
+            << ", \"bytes_allocated\": " << s.bytesAllocated
+            << ", \"resizes\": " << s.resizes
+            << ", \"size\": " << s.size
+            << ", \"peak_size\": " << s.peakSize
+            << ", \"capacity\": " << s.capacity
+            << ", \"peak_capacity\": " << s.peakCapacity << "}";
+    }
+    out << (all.empty() ? "]}\n" : "\n]}\n");
+}
+
+std::string ContainerRegistry::json() {
+    std::ostringstream out;
+    dumpJson(out);
+    return out.str();
+}
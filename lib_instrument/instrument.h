@@ -0,0 +1,110 @@
+#ifndef INSTRUMENT_H
+#define INSTRUMENT_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Opt-in per-instance counters for Queue, List and ArrayStack.
+//
+// Build with ASD_INSTRUMENT defined (CMake option BINSTRUMENT) to give
+// every container a ContainerProbe that counts its operations,
+// allocations and resizes and tracks peak size and capacity. Without it
+// the probe member and every CONTAINER_PROBE() hook compile away, and
+// stats() returns zeros.
+struct ContainerStats {
+    std::string type;
+    std::string label;
+    size_t elementSize;
+    uint64_t operations;       // pushes, pops, inserts, erases, clears
+    uint64_t allocations;
+    uint64_t bytesAllocated;
+    uint64_t resizes;          // buffer regrowths
+    size_t size;
+    size_t peakSize;
+    size_t capacity;           // elements the container can hold without allocating
+    size_t peakCapacity;
+};
+
+// Counters of one container instance, registered in ContainerRegistry for
+// its lifetime. Only the owning container writes them (plain load+store,
+// no read-modify-write), so dumping from another thread is race-free but
+// may see slightly stale values. A copy is a new instance with fresh
+// counters; assignment keeps the target's counters.
+class ContainerProbe {
+private:
+    const char* typeName;
+    size_t elementSize;
+    std::string name;
+    std::atomic<uint64_t> operations;
+    std::atomic<uint64_t> allocations;
+    std::atomic<uint64_t> bytesAllocated;
+    std::atomic<uint64_t> resizes;
+    std::atomic<size_t> currentSize;
+    std::atomic<size_t> peakSize;
+    std::atomic<size_t> currentCapacity;
+    std::atomic<size_t> peakCapacity;
+    ContainerProbe* previous;
+    ContainerProbe* next;
+
+    friend class ContainerRegistry;
+
+    template<typename Counter, typename Value>
+    static void add(Counter& counter, Value amount) {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    template<typename Counter>
+    static void track(Counter& current, Counter& peak, size_t value) {
+        current.store(value, std::memory_order_relaxed);
+        if (value > peak.load(std::memory_order_relaxed)) {
+            peak.store(value, std::memory_order_relaxed);
+        }
+    }
+
+public:
+    ContainerProbe(const char* type, size_t elementSize);
+    ContainerProbe(const ContainerProbe& other);
+    ContainerProbe& operator=(const ContainerProbe&) { return *this; }
+    ~ContainerProbe();
+
+    void countOperation() { add(operations, 1); }
+    void countAllocation(size_t bytes) {
+        add(allocations, 1);
+        add(bytesAllocated, bytes);
+    }
+    void countResize() { add(resizes, 1); }
+    void trackSize(size_t size) { track(currentSize, peakSize, size); }
+    void trackCapacity(size_t capacity) { track(currentCapacity, peakCapacity, capacity); }
+
+    // Name shown in stats and dumps; not thread-safe against a dump.
+    void setLabel(const std::string& label);
+    ContainerStats stats() const;
+};
+
+// Every live probe in the process.
+class ContainerRegistry {
+public:
+    static size_t liveCount();
+    static std::vector<ContainerStats> snapshot();
+    // {"containers": [{"type": ..., "label": ..., ...}, ...]}
+    static void dumpJson(std::ostream& out);
+    static std::string json();
+};
+
+#if defined(ASD_INSTRUMENT)
+#define CONTAINER_PROBE_MEMBER(type) ContainerProbe probe{ type, sizeof(T) };
+#define CONTAINER_PROBE(call) probe.call
+#define CONTAINER_PROBE_OF(container, call) (container).probe.call
+#define CONTAINER_STATS() probe.stats()
+#else
+#define CONTAINER_PROBE_MEMBER(type)
+#define CONTAINER_PROBE(call) ((void)0)
+#define CONTAINER_PROBE_OF(container, call) ((void)0)
+#define CONTAINER_STATS() ContainerStats()
+#endif
+
+#endif
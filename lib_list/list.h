@@ -1,28 +1,88 @@
 #ifndef LIST_H
 #define LIST_H
 
-template<typename T>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "instrument.h"
+#include "error_policy.h"
+
+// std::pmr needs C++17 (CMake option BCXX17) and a standard library that
+// ships <memory_resource>.
+#if !defined(ASD_HAS_PMR) && defined(__has_include)
+#if __has_include(<memory_resource>) && (__cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L))
+#define ASD_HAS_PMR
+#endif
+#endif
+
+#if defined(ASD_HAS_PMR)
+#include <memory_resource>
+#endif
+
+// Nodes come from Allocator rebound to Node, and elements are constructed
+// through Allocator itself, so a scoped allocator such as
+// std::pmr::polymorphic_allocator reaches the elements too. The allocator
+// is copied, moved and swapped as allocator_traits says; swapping lists
+// whose allocators compare unequal and do not propagate on swap is
+// undefined, as for the standard containers. Allocator::pointer must be a
+// plain pointer.
+template<typename T, typename Allocator = std::allocator<T>>
 class List {
+public:
+    typedef Allocator allocator_type;
+
 private:
     struct Node {
-        T data;
         Node* next;
         Node* prev;
-        Node(const T& value) : data(value), next(nullptr), prev(nullptr) {}
+        union {
+            T data;   // constructed and destroyed through the allocator
+        };
+        Node() : next(nullptr), prev(nullptr) {}
+        ~Node() {}
     };
 
+    typedef std::allocator_traits<Allocator> ValueTraits;
+    typedef typename ValueTraits::template rebind_alloc<Node> NodeAllocator;
+    typedef std::allocator_traits<NodeAllocator> NodeTraits;
+    typedef std::integral_constant<bool, ValueTraits::propagate_on_container_move_assignment::value
+        || ValueTraits::is_always_equal::value> MoveStealsNodes;
+
     Node* head;
     Node* tail;
     size_t list_size;
+    Allocator alloc;
+    CONTAINER_PROBE_MEMBER("List")
+
+    Node* createNode(const T& value);
+    void destroyNode(Node* node);
+    void copyFrom(const List& other);
+    void stealFrom(List& other);
+    void moveAssign(List& other, std::true_type);
+    void moveAssign(List& other, std::false_type);
+
+    // polymorphic_allocator cannot be assigned at all, so the assignments
+    // only exist for allocators that propagate.
+    void replaceAllocator(const Allocator& other, std::true_type) { alloc = other; }
+    void replaceAllocator(const Allocator&, std::false_type) {}
+    void swapAllocator(List& other, std::true_type) { std::swap(alloc, other.alloc); }
+    void swapAllocator(List&, std::false_type) {}
 
 public:
     List();
+    explicit List(const Allocator& allocator);
     List(const List& other);
+    List(const List& other, const Allocator& allocator);
     List(List&& other) noexcept;
     ~List();
 
     List& operator=(const List& other);
-    List& operator=(List&& other) noexcept;
+    List& operator=(List&& other) noexcept(MoveStealsNodes::value);
+
+    Allocator get_allocator() const;
 
     T& front();
     const T& front() const;
@@ -31,6 +91,7 @@ public:
 
     class Iterator {
     private:
+        friend class List;
         Node* current;
     public:
         Iterator(Node* node);
@@ -51,143 +112,227 @@ public:
     void push_back(const T& value);
     void pop_front();
     void pop_back();
+    // Move the end element into out and remove it; false on an empty list.
+    bool try_pop_front(T& out);
+    bool try_pop_back(T& out);
+    // For callers that know the list is not empty; only asserts it.
+    void pop_front_unchecked();
+    void pop_back_unchecked();
     Iterator insert(Iterator position, const T& value);
     Iterator erase(Iterator position);
+    // Relinks the node at position to the front; no allocation, and
+    // iterators to it stay valid.
+    void move_to_front(Iterator position);
     void clear();
     void swap(List& other);
 
     void reverse();
     void unique();
     void sort();
+
+    // Zeros unless built with ASD_INSTRUMENT; see instrument.h. A list's
+    // capacity is its node count.
+    ContainerStats stats() const;
+    void setStatsLabel(const std::string& label);
 };
 
 
-template<typename T>
-List<T>::List() : head(nullptr), tail(nullptr), list_size(0) {}
+template<typename T, typename Allocator>
+typename List<T, Allocator>::Node* List<T, Allocator>::createNode(const T& value) {
+    NodeAllocator nodes(alloc);
+    Node* node = NodeTraits::allocate(nodes, 1);
+    NodeTraits::construct(nodes, node);
+    ASD_TRY {
+        ValueTraits::construct(alloc, std::addressof(node->data), value);
+    }
+    ASD_CATCH_ALL {
+        NodeTraits::destroy(nodes, node);
+        NodeTraits::deallocate(nodes, node, 1);
+        ASD_RETHROW;
+    }
+    return node;
+}
 
-template<typename T>
-List<T>::List(const List& other) : head(nullptr), tail(nullptr), list_size(0) {
+template<typename T, typename Allocator>
+void List<T, Allocator>::destroyNode(Node* node) {
+    NodeAllocator nodes(alloc);
+    ValueTraits::destroy(alloc, std::addressof(node->data));
+    NodeTraits::destroy(nodes, node);
+    NodeTraits::deallocate(nodes, node, 1);
+}
+
+template<typename T, typename Allocator>
+void List<T, Allocator>::copyFrom(const List& other) {
     for (Node* current = other.head; current != nullptr; current = current->next) {
         push_back(current->data);
     }
 }
 
-template<typename T>
-List<T>::List(List&& other) noexcept
-    : head(other.head), tail(other.tail), list_size(other.list_size) {
+template<typename T, typename Allocator>
+void List<T, Allocator>::stealFrom(List& other) {
+    head = other.head;
+    tail = other.tail;
+    list_size = other.list_size;
     other.head = nullptr;
     other.tail = nullptr;
     other.list_size = 0;
+    CONTAINER_PROBE(trackSize(list_size));
+    CONTAINER_PROBE(trackCapacity(list_size));
+    CONTAINER_PROBE_OF(other, trackSize(0));
+    CONTAINER_PROBE_OF(other, trackCapacity(0));
 }
 
-template<typename T>
-List<T>::~List() {
+template<typename T, typename Allocator>
+void List<T, Allocator>::moveAssign(List& other, std::true_type) {
     clear();
+    replaceAllocator(other.alloc, typename ValueTraits::propagate_on_container_move_assignment());
+    stealFrom(other);
 }
 
-template<typename T>
-List<T>& List<T>::operator=(const List& other) {
+// The allocators may differ and ours stays, so nodes can only be taken
+// over when they compare equal; otherwise the elements are copied into
+// nodes from our allocator.
+template<typename T, typename Allocator>
+void List<T, Allocator>::moveAssign(List& other, std::false_type) {
+    clear();
+    if (alloc == other.alloc) {
+        stealFrom(other);
+    }
+    else {
+        copyFrom(other);
+        other.clear();
+    }
+}
+
+template<typename T, typename Allocator>
+List<T, Allocator>::List() : List(Allocator()) {}
+
+template<typename T, typename Allocator>
+List<T, Allocator>::List(const Allocator& allocator)
+    : head(nullptr), tail(nullptr), list_size(0), alloc(allocator) {}
+
+template<typename T, typename Allocator>
+List<T, Allocator>::List(const List& other)
+    : List(other, ValueTraits::select_on_container_copy_construction(other.alloc)) {}
+
+template<typename T, typename Allocator>
+List<T, Allocator>::List(const List& other, const Allocator& allocator)
+    : head(nullptr), tail(nullptr), list_size(0), alloc(allocator) {
+    copyFrom(other);
+}
+
+template<typename T, typename Allocator>
+List<T, Allocator>::List(List&& other) noexcept
+    : head(nullptr), tail(nullptr), list_size(0), alloc(std::move(other.alloc)) {
+    stealFrom(other);
+}
+
+template<typename T, typename Allocator>
+List<T, Allocator>::~List() {
+    clear();
+}
+
+template<typename T, typename Allocator>
+List<T, Allocator>& List<T, Allocator>::operator=(const List& other) {
     if (this != &other) {
         clear();
-        for (Node* current = other.head; current != nullptr; current = current->next) {
-            push_back(current->data);
-        }
+        replaceAllocator(other.alloc, typename ValueTraits::propagate_on_container_copy_assignment());
+        copyFrom(other);
     }
     return *this;
 }
 
-template<typename T>
-List<T>& List<T>::operator=(List&& other) noexcept {
+template<typename T, typename Allocator>
+List<T, Allocator>& List<T, Allocator>::operator=(List&& other) noexcept(MoveStealsNodes::value) {
     if (this != &other) {
-        clear();
-        head = other.head;
-        tail = other.tail;
-        list_size = other.list_size;
-        other.head = nullptr;
-        other.tail = nullptr;
-        other.list_size = 0;
+        moveAssign(other, MoveStealsNodes());
     }
     return *this;
 }
 
-template<typename T>
-T& List<T>::front() {
-    if (empty()) throw std::runtime_error("List is empty");
+template<typename T, typename Allocator>
+Allocator List<T, Allocator>::get_allocator() const {
+    return alloc;
+}
+
+template<typename T, typename Allocator>
+T& List<T, Allocator>::front() {
+    if (empty()) ASD_THROW(std::runtime_error("List is empty"));
     return head->data;
 }
 
-template<typename T>
-const T& List<T>::front() const {
-    if (empty()) throw std::runtime_error("List is empty");
+template<typename T, typename Allocator>
+const T& List<T, Allocator>::front() const {
+    if (empty()) ASD_THROW(std::runtime_error("List is empty"));
     return head->data;
 }
 
-template<typename T>
-T& List<T>::back() {
-    if (empty()) throw std::runtime_error("List is empty");
+template<typename T, typename Allocator>
+T& List<T, Allocator>::back() {
+    if (empty()) ASD_THROW(std::runtime_error("List is empty"));
     return tail->data;
 }
 
-template<typename T>
-const T& List<T>::back() const {
-    if (empty()) throw std::runtime_error("List is empty");
+template<typename T, typename Allocator>
+const T& List<T, Allocator>::back() const {
+    if (empty()) ASD_THROW(std::runtime_error("List is empty"));
     return tail->data;
 }
 
-template<typename T>
-List<T>::Iterator::Iterator(Node* node) : current(node) {}
+template<typename T, typename Allocator>
+List<T, Allocator>::Iterator::Iterator(Node* node) : current(node) {}
 
-template<typename T>
-T& List<T>::Iterator::operator*() {
+template<typename T, typename Allocator>
+T& List<T, Allocator>::Iterator::operator*() {
     return current->data;
 }
 
-template<typename T>
-typename List<T>::Iterator& List<T>::Iterator::operator++() {
+template<typename T, typename Allocator>
+typename List<T, Allocator>::Iterator& List<T, Allocator>::Iterator::operator++() {
     if (current) current = current->next;
     return *this;
 }
 
-template<typename T>
-typename List<T>::Iterator List<T>::Iterator::operator++(int) {
+template<typename T, typename Allocator>
+typename List<T, Allocator>::Iterator List<T, Allocator>::Iterator::operator++(int) {
     Iterator temp = *this;
     ++(*this);
     return temp;
 }
 
-template<typename T>
-bool List<T>::Iterator::operator==(const Iterator& other) const {
+template<typename T, typename Allocator>
+bool List<T, Allocator>::Iterator::operator==(const Iterator& other) const {
     return current == other.current;
 }
 
-template<typename T>
-bool List<T>::Iterator::operator!=(const Iterator& other) const {
+template<typename T, typename Allocator>
+bool List<T, Allocator>::Iterator::operator!=(const Iterator& other) const {
     return current != other.current;
 }
 
-template<typename T>
-typename List<T>::Iterator List<T>::begin() {
+template<typename T, typename Allocator>
+typename List<T, Allocator>::Iterator List<T, Allocator>::begin() {
     return Iterator(head);
 }
 
-template<typename T>
-typename List<T>::Iterator List<T>::end() {
+template<typename T, typename Allocator>
+typename List<T, Allocator>::Iterator List<T, Allocator>::end() {
     return Iterator(nullptr);
 }
 
-template<typename T>
-bool List<T>::empty() const {
+template<typename T, typename Allocator>
+bool List<T, Allocator>::empty() const {
     return list_size == 0;
 }
 
-template<typename T>
-size_t List<T>::size() const {
+template<typename T, typename Allocator>
+size_t List<T, Allocator>::size() const {
     return list_size;
 }
 
-template<typename T>
-void List<T>::push_front(const T& value) {
-    Node* new_node = new Node(value);
+template<typename T, typename Allocator>
+void List<T, Allocator>::push_front(const T& value) {
+    Node* new_node = createNode(value);
     if (empty()) {
         head = tail = new_node;
     }
@@ -197,11 +342,15 @@ void List<T>::push_front(const T& value) {
         head = new_node;
     }
     ++list_size;
+    CONTAINER_PROBE(countAllocation(sizeof(Node)));
+    CONTAINER_PROBE(countOperation());
+    CONTAINER_PROBE(trackSize(list_size));
+    CONTAINER_PROBE(trackCapacity(list_size));
 }
 
-template<typename T>
-void List<T>::push_back(const T& value) {
-    Node* new_node = new Node(value);
+template<typename T, typename Allocator>
+void List<T, Allocator>::push_back(const T& value) {
+    Node* new_node = createNode(value);
     if (empty()) {
         head = tail = new_node;
     }
@@ -211,12 +360,31 @@ void List<T>::push_back(const T& value) {
         tail = new_node;
     }
     ++list_size;
+    CONTAINER_PROBE(countAllocation(sizeof(Node)));
+    CONTAINER_PROBE(countOperation());
+    CONTAINER_PROBE(trackSize(list_size));
+    CONTAINER_PROBE(trackCapacity(list_size));
 }
 
-template<typename T>
-void List<T>::pop_front() {
+template<typename T, typename Allocator>
+void List<T, Allocator>::pop_front() {
     if (empty()) return;
+    pop_front_unchecked();
+}
+
+template<typename T, typename Allocator>
+bool List<T, Allocator>::try_pop_front(T& out) {
+    if (empty()) {
+        return false;
+    }
+    out = std::move(head->data);
+    pop_front_unchecked();
+    return true;
+}
 
+template<typename T, typename Allocator>
+void List<T, Allocator>::pop_front_unchecked() {
+    assert(!empty() && "pop_front_unchecked on an empty list");
     Node* temp = head;
     if (head == tail) {
         head = tail = nullptr;
@@ -225,14 +393,32 @@ void List<T>::pop_front() {
         head = head->next;
         head->prev = nullptr;
     }
-    delete temp;
+    destroyNode(temp);
     --list_size;
+    CONTAINER_PROBE(countOperation());
+    CONTAINER_PROBE(trackSize(list_size));
+    CONTAINER_PROBE(trackCapacity(list_size));
 }
 
-template<typename T>
-void List<T>::pop_back() {
+template<typename T, typename Allocator>
+void List<T, Allocator>::pop_back() {
     if (empty()) return;
+    pop_back_unchecked();
+}
+
+template<typename T, typename Allocator>
+bool List<T, Allocator>::try_pop_back(T& out) {
+    if (empty()) {
+        return false;
+    }
+    out = std::move(tail->data);
+    pop_back_unchecked();
+    return true;
+}
 
+template<typename T, typename Allocator>
+void List<T, Allocator>::pop_back_unchecked() {
+    assert(!empty() && "pop_back_unchecked on an empty list");
     Node* temp = tail;
     if (head == tail) {
         head = tail = nullptr;
@@ -241,12 +427,15 @@ void List<T>::pop_back() {
         tail = tail->prev;
         tail->next = nullptr;
     }
-    delete temp;
+    destroyNode(temp);
     --list_size;
+    CONTAINER_PROBE(countOperation());
+    CONTAINER_PROBE(trackSize(list_size));
+    CONTAINER_PROBE(trackCapacity(list_size));
 }
 
-template<typename T>
-typename List<T>::Iterator List<T>::insert(Iterator position, const T& value) {
+template<typename T, typename Allocator>
+typename List<T, Allocator>::Iterator List<T, Allocator>::insert(Iterator position, const T& value) {
     if (position == end()) {
         push_back(value);
         return Iterator(tail);
@@ -258,7 +447,7 @@ typename List<T>::Iterator List<T>::insert(Iterator position, const T& value) {
     }
 
     Node* current = position.current;
-    Node* new_node = new Node(value);
+    Node* new_node = createNode(value);
 
     new_node->prev = current->prev;
     new_node->next = current;
@@ -266,11 +455,15 @@ typename List<T>::Iterator List<T>::insert(Iterator position, const T& value) {
     current->prev = new_node;
 
     ++list_size;
+    CONTAINER_PROBE(countAllocation(sizeof(Node)));
+    CONTAINER_PROBE(countOperation());
+    CONTAINER_PROBE(trackSize(list_size));
+    CONTAINER_PROBE(trackCapacity(list_size));
     return Iterator(new_node);
 }
 
-template<typename T>
-typename List<T>::Iterator List<T>::erase(Iterator position) {
+template<typename T, typename Allocator>
+typename List<T, Allocator>::Iterator List<T, Allocator>::erase(Iterator position) {
     if (position == end()) return end();
 
     Node* current = position.current;
@@ -285,29 +478,55 @@ typename List<T>::Iterator List<T>::erase(Iterator position) {
     else {
         current->prev->next = current->next;
         current->next->prev = current->prev;
-        delete current;
+        destroyNode(current);
         --list_size;
+        CONTAINER_PROBE(countOperation());
+        CONTAINER_PROBE(trackSize(list_size));
+        CONTAINER_PROBE(trackCapacity(list_size));
     }
 
     return Iterator(next_node);
 }
 
-template<typename T>
-void List<T>::clear() {
+template<typename T, typename Allocator>
+void List<T, Allocator>::move_to_front(Iterator position) {
+    Node* current = position.current;
+    if (current == nullptr || current == head) return;
+
+    current->prev->next = current->next;
+    if (current == tail) {
+        tail = current->prev;
+    }
+    else {
+        current->next->prev = current->prev;
+    }
+    current->prev = nullptr;
+    current->next = head;
+    head->prev = current;
+    head = current;
+}
+
+template<typename T, typename Allocator>
+void List<T, Allocator>::clear() {
     while (!empty()) {
         pop_front();
     }
 }
 
-template<typename T>
-void List<T>::swap(List& other) {
+template<typename T, typename Allocator>
+void List<T, Allocator>::swap(List& other) {
+    swapAllocator(other, typename ValueTraits::propagate_on_container_swap());
     std::swap(head, other.head);
     std::swap(tail, other.tail);
     std::swap(list_size, other.list_size);
+    CONTAINER_PROBE(trackSize(list_size));
+    CONTAINER_PROBE(trackCapacity(list_size));
+    CONTAINER_PROBE_OF(other, trackSize(other.list_size));
+    CONTAINER_PROBE_OF(other, trackCapacity(other.list_size));
 }
 
-template<typename T>
-void List<T>::reverse() {
+template<typename T, typename Allocator>
+void List<T, Allocator>::reverse() {
     if (size() <= 1) return;
 
     Node* current = head;
@@ -318,8 +537,8 @@ void List<T>::reverse() {
     std::swap(head, tail);
 }
 
-template<typename T>
-void List<T>::unique() {
+template<typename T, typename Allocator>
+void List<T, Allocator>::unique() {
     if (size() <= 1) return;
 
     Node* current = head;
@@ -333,16 +552,18 @@ void List<T>::unique() {
             else {
                 tail = current;
             }
-            delete to_delete;
+            destroyNode(to_delete);
             --list_size;
+            CONTAINER_PROBE(trackSize(list_size));
+            CONTAINER_PROBE(trackCapacity(list_size));
         }
         else {
             current = current->next;
         }
     }
 }
-template<typename T>
-void List<T>::sort() {
+template<typename T, typename Allocator>
+void List<T, Allocator>::sort() {
     if (size() <= 1) return;
 
 
@@ -360,4 +581,23 @@ void List<T>::sort() {
     } while (swapped);
 }
 
+template<typename T, typename Allocator>
+ContainerStats List<T, Allocator>::stats() const {
+    return CONTAINER_STATS();
+}
+
+template<typename T, typename Allocator>
+void List<T, Allocator>::setStatsLabel(const std::string& label) {
+    CONTAINER_PROBE(setLabel(label));
+    (void)label;
+}
+
+#if defined(ASD_HAS_PMR)
+namespace pmr {
+// Lists whose nodes and elements come from one std::pmr::memory_resource.
+template<typename T>
+using List = ::List<T, std::pmr::polymorphic_allocator<T>>;
+}
+#endif
+
 #endif
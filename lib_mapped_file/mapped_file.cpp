@@ -0,0 +1,178 @@
+#include <stdexcept>
+#include <utility>
+#include "mapped_file.h"
+#include "error_policy.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::string& path, Access access)
+    : fileSize(0), viewBase(nullptr), viewLength(0) {
+#if defined(_WIN32)
+    DWORD flags = access == Access::SEQUENTIAL ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS;
+    file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                       OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | flags, nullptr);
+    mapping = nullptr;
+    if (file == INVALID_HANDLE_VALUE) {
+        file = nullptr;
+        ASD_THROW(std::runtime_error("Cannot open file: " + path));
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        close();
+        ASD_THROW(std::runtime_error("Cannot read file size: " + path));
+    }
+    fileSize = static_cast<uint64_t>(size.QuadPart);
+    if (fileSize != 0) {
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr) {
+            close();
+            ASD_THROW(std::runtime_error("Cannot map file: " + path));
+        }
+    }
+#else
+    fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        ASD_THROW(std::runtime_error("Cannot open file: " + path));
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        close();
+        ASD_THROW(std::runtime_error("Cannot read file size: " + path));
+    }
+    fileSize = static_cast<uint64_t>(info.st_size);
+#if defined(POSIX_FADV_SEQUENTIAL)
+    ::posix_fadvise(fd, 0, 0, access == Access::SEQUENTIAL ? POSIX_FADV_SEQUENTIAL : POSIX_FADV_RANDOM);
+#else
+    (void)access;
+#endif
+#endif
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    :
+#if defined(_WIN32)
+    file(other.file), mapping(other.mapping),
+#else
+    fd(other.fd),
+#endif
+    fileSize(other.fileSize), viewBase(other.viewBase), viewLength(other.viewLength) {
+#if defined(_WIN32)
+    other.file = nullptr;
+    other.mapping = nullptr;
+#else
+    other.fd = -1;
+#endif
+    other.fileSize = 0;
+    other.viewBase = nullptr;
+    other.viewLength = 0;
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+#if defined(_WIN32)
+        std::swap(file, other.file);
+        std::swap(mapping, other.mapping);
+#else
+        std::swap(fd, other.fd);
+#endif
+        std::swap(fileSize, other.fileSize);
+        std::swap(viewBase, other.viewBase);
+        std::swap(viewLength, other.viewLength);
+    }
+    return *this;
+}
+
+void MappedFile::close() {
+    unmap();
+#if defined(_WIN32)
+    if (mapping != nullptr) {
+        CloseHandle(mapping);
+        mapping = nullptr;
+    }
+    if (file != nullptr) {
+        CloseHandle(file);
+        file = nullptr;
+    }
+#else
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+#endif
+}
+
+uint64_t MappedFile::size() const {
+    return fileSize;
+}
+
+size_t MappedFile::granularity() {
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwAllocationGranularity;
+#else
+    return static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+#endif
+}
+
+const char* MappedFile::map(uint64_t offset, size_t length, Access access) {
+    unmap();
+    if (offset >= fileSize || length == 0) {
+        return nullptr;
+    }
+    if (length > fileSize - offset) {
+        length = static_cast<size_t>(fileSize - offset);
+    }
+
+    uint64_t alignedOffset = offset - offset % granularity();
+    size_t delta = static_cast<size_t>(offset - alignedOffset);
+
+#if defined(_WIN32)
+    void* base = MapViewOfFile(mapping, FILE_MAP_READ,
+                               static_cast<DWORD>(alignedOffset >> 32),
+                               static_cast<DWORD>(alignedOffset & 0xFFFFFFFFu),
+                               length + delta);
+    if (base == nullptr) {
+        ASD_THROW(std::runtime_error("Cannot map file view"));
+    }
+    (void)access;
+#else
+    void* base = ::mmap(nullptr, length + delta, PROT_READ, MAP_PRIVATE, fd,
+                        static_cast<off_t>(alignedOffset));
+    if (base == MAP_FAILED) {
+        ASD_THROW(std::runtime_error("Cannot map file view"));
+    }
+    ::madvise(base, length + delta, access == Access::SEQUENTIAL ? MADV_SEQUENTIAL : MADV_RANDOM);
+#endif
+
+    viewBase = base;
+    viewLength = length + delta;
+    return static_cast<const char*>(base) + delta;
+}
+
+void MappedFile::unmap() {
+    if (viewBase == nullptr) {
+        return;
+    }
+#if defined(_WIN32)
+    UnmapViewOfFile(viewBase);
+#else
+    ::munmap(viewBase, viewLength);
+#endif
+    viewBase = nullptr;
+    viewLength = 0;
+}
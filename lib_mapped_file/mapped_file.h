@@ -0,0 +1,52 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Read-only memory mapping of a file, one view at a time. Mapping a large
+// file window by window keeps the resident set flat regardless of its size.
+class MappedFile {
+public:
+    enum class Access {
+        SEQUENTIAL,
+        RANDOM
+    };
+
+private:
+#if defined(_WIN32)
+    void* file;
+    void* mapping;
+#else
+    int fd;
+#endif
+    uint64_t fileSize;
+    void* viewBase;
+    size_t viewLength;
+
+    void close();
+
+public:
+    // Throws std::runtime_error if the file cannot be opened.
+    explicit MappedFile(const std::string& path, Access access = Access::SEQUENTIAL);
+    MappedFile(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    ~MappedFile();
+
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    uint64_t size() const;
+
+    // Maps [offset, offset + length) and returns a pointer to its first byte,
+    // replacing the previous view. length is clamped to the end of the file;
+    // an empty range returns nullptr. Throws std::runtime_error on failure.
+    const char* map(uint64_t offset, size_t length, Access access = Access::SEQUENTIAL);
+    void unmap();
+
+    // Offsets that are multiples of this avoid remapping the preceding bytes.
+    static size_t granularity();
+};
+
+#endif
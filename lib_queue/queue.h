@@ -1,179 +1,605 @@
 #pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <memory>
 #include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include "instrument.h"
+#include "error_policy.h"
+#include "simd_search.h"
 
-template<typename T>
+// std::pmr needs C++17 (CMake option BCXX17) and a standard library that
+// ships <memory_resource>.
+#if !defined(ASD_HAS_PMR) && defined(__has_include)
+#if __has_include(<memory_resource>) && (__cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L))
+#define ASD_HAS_PMR
+#endif
+#endif
+
+#if defined(ASD_HAS_PMR)
+#include <memory_resource>
+#endif
+
+// Ring buffer from Allocator. Only the queued elements are alive: slots are
+// constructed on push and destroyed on pop through allocator_traits, so a
+// scoped allocator such as std::pmr::polymorphic_allocator reaches the
+// elements too. The allocator is copied, moved and swapped as
+// allocator_traits says; swapping queues whose allocators compare unequal
+// and do not propagate on swap is undefined, as for the standard
+// containers. Allocator::pointer must be a plain pointer.
+template<typename T, typename Allocator = std::allocator<T>>
 class Queue {
+public:
+    typedef Allocator allocator_type;
+
 private:
+    typedef std::allocator_traits<Allocator> Traits;
+    typedef std::integral_constant<bool, Traits::propagate_on_container_move_assignment::value
+        || Traits::is_always_equal::value> MoveStealsBuffer;
+
     T* data;
     size_t capacity;
     size_t frontIndex;
     size_t backIndex;
     size_t queueSize;
+    Allocator alloc;
+    CONTAINER_PROBE_MEMBER("Queue")
+
+    static const size_t INITIAL_CAPACITY = 10;
 
     void resize();
+    T* allocate(size_t count);
+    void destroyElements();
+    void release();
+    void copyFrom(const Queue& other);
+    void stealFrom(Queue& other);
+    void moveAssign(Queue& other, std::true_type);
+    void moveAssign(Queue& other, std::false_type);
+
+    // polymorphic_allocator cannot be assigned at all, so the assignments
+    // only exist for allocators that propagate.
+    void replaceAllocator(const Allocator& other, std::true_type) { alloc = other; }
+    void replaceAllocator(const Allocator&, std::false_type) {}
+    void swapAllocator(Queue& other, std::true_type) { std::swap(alloc, other.alloc); }
+    void swapAllocator(Queue&, std::false_type) {}
 
 public:
+    // find() result for a missing value.
+    static const size_t NPOS = static_cast<size_t>(-1);
+
+    // A contiguous run of the ring buffer.
+    struct Span {
+        const T* data;
+        size_t size;
+    };
+
     Queue();
+    explicit Queue(const Allocator& allocator);
     Queue(const Queue& other);
+    Queue(const Queue& other, const Allocator& allocator);
+    Queue(Queue&& other) noexcept;
     Queue& operator=(const Queue& other);
+    Queue& operator=(Queue&& other) noexcept(MoveStealsBuffer::value);
     ~Queue();
 
+    Allocator get_allocator() const;
+
     void push(const T& value);
     void pop();
+    void push_front(const T& value);
+    void pop_back();
     T& front();
     const T& front() const;
     T& back();
     const T& back() const;
 
+    // Non-throwing variants for hot loops. try_push always succeeds (the
+    // buffer grows) and is there to match ArrayStack; try_pop moves the
+    // front into out. pop_unchecked only asserts that the queue is not empty.
+    bool try_push(const T& value);
+    bool try_pop(T& out);
+    void pop_unchecked();
+
     bool empty() const;
     size_t size() const;
     size_t getCapacity() const;
     void swap(Queue& other);
     void clear();
+
+    // Replaces the contents with values[0, count) in one bulk copy (a single
+    // memcpy for trivially copyable T, bypassing Allocator::construct),
+    // growing the buffer at most once.
+    void assign(const T* values, size_t count);
+    // The elements front to back are firstSpan() followed by secondSpan();
+    // the second is empty unless the contents wrap around the buffer end.
+    Span firstSpan() const;
+    Span secondSpan() const;
+
+    // Searches over both spans through simd_search.h, vectorised for
+    // arithmetic T. Positions count from the front.
+    size_t find(const T& value) const;
+    size_t count(const T& value) const;
+    // The first smallest/largest element from the front.
+    const T& minElement() const;
+    const T& maxElement() const;
+    bool operator==(const Queue& other) const;
+    bool operator!=(const Queue& other) const;
+
+    // Zeros unless built with ASD_INSTRUMENT; see instrument.h.
+    ContainerStats stats() const;
+    void setStatsLabel(const std::string& label);
 };
 
-template<typename T>
-Queue<T>::Queue()
-    : capacity(10), frontIndex(0), backIndex(0), queueSize(0) {
-    data = new T[capacity];
+template<typename T, typename Allocator>
+const size_t Queue<T, Allocator>::INITIAL_CAPACITY;
+
+template<typename T, typename Allocator>
+const size_t Queue<T, Allocator>::NPOS;
+
+template<typename T, typename Allocator>
+T* Queue<T, Allocator>::allocate(size_t count) {
+    T* block = Traits::allocate(alloc, count);
+    CONTAINER_PROBE(countAllocation(count * sizeof(T)));
+    CONTAINER_PROBE(trackCapacity(count));
+    return block;
 }
 
-template<typename T>
-Queue<T>::Queue(const Queue& other)
-    : capacity(other.capacity),
-    frontIndex(0),
-    backIndex(0),
-    queueSize(0) {
-    data = new T[capacity];
+template<typename T, typename Allocator>
+void Queue<T, Allocator>::destroyElements() {
+    for (size_t i = 0; i < queueSize; ++i) {
+        Traits::destroy(alloc, data + (frontIndex + i) % capacity);
+    }
+    frontIndex = 0;
+    backIndex = 0;
+    queueSize = 0;
+}
 
+// Leaves no buffer and a zero capacity, so the next push allocates one
+// even if a caller's own allocation after release() throws.
+template<typename T, typename Allocator>
+void Queue<T, Allocator>::release() {
+    destroyElements();
+    if (data != nullptr) {
+        Traits::deallocate(alloc, data, capacity);
+        data = nullptr;
+    }
+    capacity = 0;
+}
+
+// Keeps the current buffer when it is big enough for other's elements.
+template<typename T, typename Allocator>
+void Queue<T, Allocator>::copyFrom(const Queue& other) {
+    if (data == nullptr || capacity < other.queueSize) {
+        release();
+        size_t newCapacity = std::max(other.capacity, INITIAL_CAPACITY);
+        data = allocate(newCapacity);
+        capacity = newCapacity;
+    }
     for (size_t i = 0; i < other.queueSize; ++i) {
         push(other.data[(other.frontIndex + i) % other.capacity]);
     }
 }
 
-template<typename T>
-Queue<T>& Queue<T>::operator=(const Queue& other) {
-    if (this != &other) {
-        delete[] data;
+// Leaves other empty and without a buffer; its next push allocates one.
+template<typename T, typename Allocator>
+void Queue<T, Allocator>::stealFrom(Queue& other) {
+    data = other.data;
+    capacity = other.capacity;
+    frontIndex = other.frontIndex;
+    backIndex = other.backIndex;
+    queueSize = other.queueSize;
+    other.data = nullptr;
+    other.capacity = 0;
+    other.frontIndex = 0;
+    other.backIndex = 0;
+    other.queueSize = 0;
+    CONTAINER_PROBE(trackSize(queueSize));
+    CONTAINER_PROBE(trackCapacity(capacity));
+    CONTAINER_PROBE_OF(other, trackSize(0));
+    CONTAINER_PROBE_OF(other, trackCapacity(0));
+}
+
+template<typename T, typename Allocator>
+void Queue<T, Allocator>::moveAssign(Queue& other, std::true_type) {
+    release();
+    replaceAllocator(other.alloc, typename Traits::propagate_on_container_move_assignment());
+    stealFrom(other);
+}
+
+// The allocators may differ and ours stays, so the buffer can only be
+// taken over when they compare equal; otherwise the elements are copied
+// into a buffer from our allocator.
+template<typename T, typename Allocator>
+void Queue<T, Allocator>::moveAssign(Queue& other, std::false_type) {
+    if (alloc == other.alloc) {
+        release();
+        stealFrom(other);
+    }
+    else {
+        destroyElements();
+        copyFrom(other);
+        other.destroyElements();
+    }
+}
 
-        capacity = other.capacity;
-        frontIndex = 0;
-        backIndex = 0;
-        queueSize = 0;
+template<typename T, typename Allocator>
+Queue<T, Allocator>::Queue() : Queue(Allocator()) {}
 
-        data = new T[capacity];
+template<typename T, typename Allocator>
+Queue<T, Allocator>::Queue(const Allocator& allocator)
+    : data(nullptr), capacity(INITIAL_CAPACITY), frontIndex(0), backIndex(0), queueSize(0), alloc(allocator) {
+    data = allocate(capacity);
+}
+
+template<typename T, typename Allocator>
+Queue<T, Allocator>::Queue(const Queue& other)
+    : Queue(other, Traits::select_on_container_copy_construction(other.alloc)) {}
+
+template<typename T, typename Allocator>
+Queue<T, Allocator>::Queue(const Queue& other, const Allocator& allocator)
+    : data(nullptr), capacity(0), frontIndex(0), backIndex(0), queueSize(0), alloc(allocator) {
+    copyFrom(other);
+}
 
-        for (size_t i = 0; i < other.queueSize; ++i) {
-            push(other.data[(other.frontIndex + i) % other.capacity]);
+template<typename T, typename Allocator>
+Queue<T, Allocator>::Queue(Queue&& other) noexcept
+    : data(nullptr), capacity(0), frontIndex(0), backIndex(0), queueSize(0), alloc(std::move(other.alloc)) {
+    stealFrom(other);
+}
+
+template<typename T, typename Allocator>
+Queue<T, Allocator>& Queue<T, Allocator>::operator=(const Queue& other) {
+    if (this != &other) {
+        destroyElements();
+        if (Traits::propagate_on_container_copy_assignment::value && alloc != other.alloc) {
+            release();   // the buffer belongs to the allocator being replaced
         }
+        replaceAllocator(other.alloc, typename Traits::propagate_on_container_copy_assignment());
+        copyFrom(other);
     }
     return *this;
 }
 
-template<typename T>
-Queue<T>::~Queue() {
-    delete[] data;
+template<typename T, typename Allocator>
+Queue<T, Allocator>& Queue<T, Allocator>::operator=(Queue&& other) noexcept(MoveStealsBuffer::value) {
+    if (this != &other) {
+        moveAssign(other, MoveStealsBuffer());
+    }
+    return *this;
 }
 
-template<typename T>
-void Queue<T>::resize() {
-    size_t newCapacity = capacity * 2;
-    T* newData = new T[newCapacity];
+template<typename T, typename Allocator>
+Queue<T, Allocator>::~Queue() {
+    release();
+}
 
-    for (size_t i = 0; i < queueSize; ++i) {
-        newData[i] = data[(frontIndex + i) % capacity];
+template<typename T, typename Allocator>
+Allocator Queue<T, Allocator>::get_allocator() const {
+    return alloc;
+}
+
+template<typename T, typename Allocator>
+void Queue<T, Allocator>::resize() {
+    size_t newCapacity = std::max(capacity * 2, INITIAL_CAPACITY);
+    T* newData = allocate(newCapacity);
+    size_t moved = 0;
+    ASD_TRY {
+        for (; moved < queueSize; ++moved) {
+            Traits::construct(alloc, newData + moved, std::move_if_noexcept(data[(frontIndex + moved) % capacity]));
+        }
+    }
+    ASD_CATCH_ALL {
+        for (size_t i = 0; i < moved; ++i) {
+            Traits::destroy(alloc, newData + i);
+        }
+        Traits::deallocate(alloc, newData, newCapacity);
+        ASD_RETHROW;
     }
 
-    delete[] data;
+    size_t count = queueSize;
+    release();
     data = newData;
     capacity = newCapacity;
     frontIndex = 0;
-    backIndex = queueSize;
+    backIndex = count % newCapacity;
+    queueSize = count;
+    CONTAINER_PROBE(countResize());
 }
 
-template<typename T>
-void Queue<T>::push(const T& value) {
+template<typename T, typename Allocator>
+void Queue<T, Allocator>::push(const T& value) {
     if (queueSize == capacity) {
         resize();
     }
 
-    data[backIndex] = value;
+    Traits::construct(alloc, data + backIndex, value);
     backIndex = (backIndex + 1) % capacity;
     queueSize++;
+    CONTAINER_PROBE(countOperation());
+    CONTAINER_PROBE(trackSize(queueSize));
 }
 
-template<typename T>
-void Queue<T>::pop() {
+template<typename T, typename Allocator>
+void Queue<T, Allocator>::pop() {
+    if (empty()) {
+        ASD_THROW(std::runtime_error("Queue is empty"));
+    }
+    pop_unchecked();
+}
+
+template<typename T, typename Allocator>
+bool Queue<T, Allocator>::try_push(const T& value) {
+    push(value);
+    return true;
+}
+
+template<typename T, typename Allocator>
+bool Queue<T, Allocator>::try_pop(T& out) {
     if (empty()) {
-        throw std::runtime_error("Queue is empty");
+        return false;
     }
+    out = std::move(data[frontIndex]);
+    pop_unchecked();
+    return true;
+}
 
+template<typename T, typename Allocator>
+void Queue<T, Allocator>::pop_unchecked() {
+    assert(!empty() && "pop_unchecked on an empty queue");
+    Traits::destroy(alloc, data + frontIndex);
     frontIndex = (frontIndex + 1) % capacity;
     queueSize--;
+    CONTAINER_PROBE(countOperation());
+    CONTAINER_PROBE(trackSize(queueSize));
 }
 
-template<typename T>
-T& Queue<T>::front() {
+template<typename T, typename Allocator>
+void Queue<T, Allocator>::push_front(const T& value) {
+    if (queueSize == capacity) {
+        resize();
+    }
+
+    size_t slot = (frontIndex == 0) ? capacity - 1 : frontIndex - 1;
+    Traits::construct(alloc, data + slot, value);
+    frontIndex = slot;
+    queueSize++;
+    CONTAINER_PROBE(countOperation());
+    CONTAINER_PROBE(trackSize(queueSize));
+}
+
+template<typename T, typename Allocator>
+void Queue<T, Allocator>::pop_back() {
     if (empty()) {
-        throw std::runtime_error("Queue is empty");
+        ASD_THROW(std::runtime_error("Queue is empty"));
+    }
+
+    backIndex = (backIndex == 0) ? capacity - 1 : backIndex - 1;
+    Traits::destroy(alloc, data + backIndex);
+    queueSize--;
+    CONTAINER_PROBE(countOperation());
+    CONTAINER_PROBE(trackSize(queueSize));
+}
+
+template<typename T, typename Allocator>
+T& Queue<T, Allocator>::front() {
+    if (empty()) {
+        ASD_THROW(std::runtime_error("Queue is empty"));
     }
     return data[frontIndex];
 }
 
-template<typename T>
-const T& Queue<T>::front() const {
+template<typename T, typename Allocator>
+const T& Queue<T, Allocator>::front() const {
     if (empty()) {
-        throw std::runtime_error("Queue is empty");
+        ASD_THROW(std::runtime_error("Queue is empty"));
     }
     return data[frontIndex];
 }
 
-template<typename T>
-T& Queue<T>::back() {
+template<typename T, typename Allocator>
+T& Queue<T, Allocator>::back() {
     if (empty()) {
-        throw std::runtime_error("Queue is empty");
+        ASD_THROW(std::runtime_error("Queue is empty"));
     }
     return data[(backIndex == 0) ? capacity - 1 : backIndex - 1];
 }
 
-template<typename T>
-const T& Queue<T>::back() const {
+template<typename T, typename Allocator>
+const T& Queue<T, Allocator>::back() const {
     if (empty()) {
-        throw std::runtime_error("Queue is empty");
+        ASD_THROW(std::runtime_error("Queue is empty"));
     }
     return data[(backIndex == 0) ? capacity - 1 : backIndex - 1];
 }
 
-template<typename T>
-bool Queue<T>::empty() const {
+template<typename T, typename Allocator>
+bool Queue<T, Allocator>::empty() const {
     return queueSize == 0;
 }
 
-template<typename T>
-size_t Queue<T>::size() const {
+template<typename T, typename Allocator>
+size_t Queue<T, Allocator>::size() const {
     return queueSize;
 }
 
-template<typename T>
-size_t Queue<T>::getCapacity() const {
+template<typename T, typename Allocator>
+size_t Queue<T, Allocator>::getCapacity() const {
     return capacity;
 }
 
-template<typename T>
-void Queue<T>::swap(Queue& other) {
+template<typename T, typename Allocator>
+void Queue<T, Allocator>::swap(Queue& other) {
+    swapAllocator(other, typename Traits::propagate_on_container_swap());
     std::swap(data, other.data);
     std::swap(capacity, other.capacity);
     std::swap(frontIndex, other.frontIndex);
     std::swap(backIndex, other.backIndex);
     std::swap(queueSize, other.queueSize);
+    CONTAINER_PROBE(trackSize(queueSize));
+    CONTAINER_PROBE(trackCapacity(capacity));
+    CONTAINER_PROBE_OF(other, trackSize(other.queueSize));
+    CONTAINER_PROBE_OF(other, trackCapacity(other.capacity));
 }
 
-template<typename T>
-void Queue<T>::clear() {
+template<typename T, typename Allocator>
+void Queue<T, Allocator>::clear() {
+    destroyElements();
+    CONTAINER_PROBE(countOperation());
+    CONTAINER_PROBE(trackSize(0));
+}
+
+template<typename T, typename Allocator>
+void Queue<T, Allocator>::assign(const T* values, size_t count) {
+    destroyElements();
+    if (data == nullptr || count > capacity) {
+        release();
+        size_t newCapacity = std::max(count, INITIAL_CAPACITY);
+        data = allocate(newCapacity);
+        capacity = newCapacity;
+    }
+    if (std::is_trivially_copyable<T>::value) {
+        if (count != 0) {
+            std::memcpy(static_cast<void*>(data), values, count * sizeof(T));
+        }
+    }
+    else {
+        for (size_t i = 0; i < count; ++i) {
+            Traits::construct(alloc, data + i, values[i]);
+            // If a later copy throws, the queue holds the copied prefix.
+            queueSize = i + 1;
+            backIndex = queueSize % capacity;
+        }
+    }
     frontIndex = 0;
-    backIndex = 0;
-    queueSize = 0;
+    backIndex = count % capacity;
+    queueSize = count;
+    CONTAINER_PROBE(countOperation());
+    CONTAINER_PROBE(trackSize(count));
+}
+
+template<typename T, typename Allocator>
+typename Queue<T, Allocator>::Span Queue<T, Allocator>::firstSpan() const {
+    size_t run = std::min(queueSize, capacity - frontIndex);
+    Span span = { data + frontIndex, run };
+    return span;
+}
+
+template<typename T, typename Allocator>
+typename Queue<T, Allocator>::Span Queue<T, Allocator>::secondSpan() const {
+    size_t run = std::min(queueSize, capacity - frontIndex);
+    Span span = { data, queueSize - run };
+    return span;
+}
+
+template<typename T, typename Allocator>
+size_t Queue<T, Allocator>::find(const T& value) const {
+    Span first = firstSpan();
+    size_t at = span_find(first.data, first.size, value);
+    if (at != first.size) {
+        return at;
+    }
+    Span second = secondSpan();
+    at = span_find(second.data, second.size, value);
+    return at != second.size ? first.size + at : NPOS;
+}
+
+template<typename T, typename Allocator>
+size_t Queue<T, Allocator>::count(const T& value) const {
+    Span first = firstSpan();
+    Span second = secondSpan();
+    return span_count(first.data, first.size, value) + span_count(second.data, second.size, value);
+}
+
+// The second span's candidate wins only if it beats the first's, which
+// keeps the earlier element on ties.
+template<typename T, typename Allocator>
+const T& Queue<T, Allocator>::minElement() const {
+    if (empty()) {
+        ASD_THROW(std::runtime_error("Queue is empty"));
+    }
+    Span first = firstSpan();
+    Span second = secondSpan();
+    const T& best = first.data[span_min_index(first.data, first.size)];
+    if (second.size == 0) {
+        return best;
+    }
+    const T& other = second.data[span_min_index(second.data, second.size)];
+    return other < best ? other : best;
+}
+
+template<typename T, typename Allocator>
+const T& Queue<T, Allocator>::maxElement() const {
+    if (empty()) {
+        ASD_THROW(std::runtime_error("Queue is empty"));
+    }
+    Span first = firstSpan();
+    Span second = secondSpan();
+    const T& best = first.data[span_max_index(first.data, first.size)];
+    if (second.size == 0) {
+        return best;
+    }
+    const T& other = second.data[span_max_index(second.data, second.size)];
+    return other > best ? other : best;
+}
+
+// Both queues are walked span by span; the runs compared at a time end
+// wherever either queue's span ends.
+template<typename T, typename Allocator>
+bool Queue<T, Allocator>::operator==(const Queue& other) const {
+    if (queueSize != other.queueSize) {
+        return false;
+    }
+    Span mine[2] = { firstSpan(), secondSpan() };
+    Span theirs[2] = { other.firstSpan(), other.secondSpan() };
+    size_t i = 0;
+    size_t j = 0;
+    size_t offset = 0;
+    size_t otherOffset = 0;
+    while (i < 2 && j < 2) {
+        size_t run = std::min(mine[i].size - offset, theirs[j].size - otherOffset);
+        if (span_mismatch(mine[i].data + offset, theirs[j].data + otherOffset, run) != run) {
+            return false;
+        }
+        offset += run;
+        otherOffset += run;
+        if (offset == mine[i].size) {
+            ++i;
+            offset = 0;
+        }
+        if (otherOffset == theirs[j].size) {
+            ++j;
+            otherOffset = 0;
+        }
+    }
+    return true;
+}
+
+template<typename T, typename Allocator>
+bool Queue<T, Allocator>::operator!=(const Queue& other) const {
+    return !(*this == other);
+}
+
+template<typename T, typename Allocator>
+ContainerStats Queue<T, Allocator>::stats() const {
+    return CONTAINER_STATS();
+}
+
+template<typename T, typename Allocator>
+void Queue<T, Allocator>::setStatsLabel(const std::string& label) {
+    CONTAINER_PROBE(setLabel(label));
+    (void)label;
+}
+
+#if defined(ASD_HAS_PMR)
+namespace pmr {
+// Queues whose buffers and elements come from one std::pmr::memory_resource.
+template<typename T>
+using Queue = ::Queue<T, std::pmr::polymorphic_allocator<T>>;
 }
+#endif
 
 template class Queue<int>;
 template class Queue<double>;
@@ -0,0 +1,195 @@
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "epoch.h"
+#include "error_policy.h"
+
+const size_t EpochManager::RECLAIM_THRESHOLD;
+
+namespace {
+
+const uint64_t ACTIVE = 1;
+const size_t CACHE_LINE = 64;
+
+// Announcement of one reader thread; reused once that thread exits. The
+// padding keeps each slot on cache lines of its own so readers never write
+// to a shared one (C++14 new ignores alignas beyond max_align_t).
+struct Slot {
+    char before[CACHE_LINE];
+    std::atomic<uint64_t> state;   // (epoch << 1) | ACTIVE inside a guard, 0 outside
+    std::atomic<bool> owned;
+    unsigned nesting;              // touched only by the owner
+    Slot* next;                    // fixed once the slot is published
+    char after[CACHE_LINE];
+
+    Slot() : state(0), owned(true), nesting(0), next(nullptr) {}
+};
+
+struct Retired {
+    void* object;
+    EpochManager::Deleter deleter;
+    uint64_t epoch;
+};
+
+struct Domain {
+    std::atomic<uint64_t> global;
+    std::atomic<Slot*> slots;
+    std::mutex retireLock;
+    std::vector<Retired> retired;
+    size_t sinceReclaim;
+    std::atomic<size_t> pending;
+
+    Domain() : global(0), slots(nullptr), sinceReclaim(0), pending(0) {}
+};
+
+// Never destroyed: reader threads may still run during static destruction.
+Domain& domain() {
+    static Domain* instance = new Domain();
+    return *instance;
+}
+
+Slot* acquire_slot() {
+    Domain& d = domain();
+    for (Slot* slot = d.slots.load(std::memory_order_acquire); slot != nullptr; slot = slot->next) {
+        bool expected = false;
+        if (!slot->owned.load(std::memory_order_relaxed)
+            && slot->owned.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            return slot;
+        }
+    }
+    Slot* slot = new Slot();
+    Slot* top = d.slots.load(std::memory_order_relaxed);
+    do {
+        slot->next = top;
+    } while (!d.slots.compare_exchange_weak(top, slot, std::memory_order_release,
+                                           std::memory_order_relaxed));
+    return slot;
+}
+
+// Hands the slot back when its thread exits.
+struct SlotHolder {
+    Slot* slot;
+
+    SlotHolder() : slot(nullptr) {}
+    ~SlotHolder() {
+        if (slot != nullptr) {
+            slot->state.store(0, std::memory_order_release);
+            slot->owned.store(false, std::memory_order_release);
+        }
+    }
+};
+
+Slot* thread_slot() {
+    thread_local SlotHolder holder;
+    if (holder.slot == nullptr) {
+        holder.slot = acquire_slot();
+    }
+    return holder.slot;
+}
+
+// Moves the epoch forward unless some reader still announces an older one.
+bool advance(Domain& d) {
+    uint64_t current = d.global.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    for (Slot* slot = d.slots.load(std::memory_order_acquire); slot != nullptr; slot = slot->next) {
+        uint64_t state = slot->state.load(std::memory_order_acquire);
+        if ((state & ACTIVE) && (state >> 1) != current) {
+            return false;
+        }
+    }
+    // Losing the race means another thread advanced it for us.
+    d.global.compare_exchange_strong(current, current + 1, std::memory_order_seq_cst);
+    return true;
+}
+
+void reclaim(Domain& d) {
+    std::vector<Retired> ready;
+    {
+        std::lock_guard<std::mutex> guard(d.retireLock);
+        uint64_t current = d.global.load(std::memory_order_seq_cst);
+        size_t kept = 0;
+        for (const Retired& entry : d.retired) {
+            if (current - entry.epoch >= 2) {
+                ready.push_back(entry);
+            }
+            else {
+                d.retired[kept++] = entry;
+            }
+        }
+        d.retired.resize(kept);
+        d.sinceReclaim = 0;
+        d.pending.store(kept, std::memory_order_relaxed);
+    }
+    for (const Retired& entry : ready) {
+        entry.deleter(entry.object);
+    }
+}
+
+}  // namespace
+
+EpochManager::ReadGuard::ReadGuard() {
+    Slot* mine = thread_slot();
+    slot = mine;
+    if (mine->nesting++ == 0) {
+        uint64_t current = domain().global.load(std::memory_order_relaxed);
+        mine->state.store((current << 1) | ACTIVE, std::memory_order_relaxed);
+        // Orders the announcement before every load of the read section.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+}
+
+EpochManager::ReadGuard::~ReadGuard() {
+    Slot* mine = static_cast<Slot*>(slot);
+    if (--mine->nesting == 0) {
+        mine->state.store(0, std::memory_order_release);
+    }
+}
+
+void EpochManager::retire(void* object, Deleter deleter) {
+    Domain& d = domain();
+    // The object was unlinked before this point; stamp it with an epoch
+    // no older than any reader that could have reached it.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    Retired entry = { object, deleter, d.global.load(std::memory_order_relaxed) };
+    bool due;
+    {
+        std::lock_guard<std::mutex> guard(d.retireLock);
+        d.retired.push_back(entry);
+        d.pending.store(d.retired.size(), std::memory_order_relaxed);
+        due = ++d.sinceReclaim >= RECLAIM_THRESHOLD;
+    }
+    if (due) {
+        tryAdvance();
+    }
+}
+
+bool EpochManager::tryAdvance() {
+    Domain& d = domain();
+    bool advanced = advance(d);
+    reclaim(d);
+    return advanced;
+}
+
+void EpochManager::synchronize() {
+    if (thread_slot()->nesting != 0) {
+        ASD_THROW(std::logic_error("synchronize() inside a read guard would never return"));
+    }
+    Domain& d = domain();
+    uint64_t target = d.global.load(std::memory_order_seq_cst) + 2;
+    while (d.global.load(std::memory_order_seq_cst) < target) {
+        if (!advance(d)) {
+            std::this_thread::yield();
+        }
+    }
+    reclaim(d);
+}
+
+uint64_t EpochManager::epoch() {
+    return domain().global.load(std::memory_order_relaxed);
+}
+
+size_t EpochManager::pending() {
+    return domain().pending.load(std::memory_order_relaxed);
+}
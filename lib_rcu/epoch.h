@@ -0,0 +1,64 @@
+#ifndef EPOCH_H
+#define EPOCH_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Process-wide epoch-based reclamation for RCU structures.
+//
+// Readers wrap every traversal in a ReadGuard. Entering one publishes the
+// current global epoch in a slot owned by the calling thread: a plain store
+// followed by a fence, with no lock and no atomic read-modify-write on
+// shared data. Writers unlink an object and hand it to retire(); it is
+// freed once the global epoch has moved two steps past its retirement,
+// which can only happen after every reader that might still hold it has
+// left its guard.
+//
+// Guards nest. A thread parked inside a guard stalls reclamation for
+// everyone, so keep read sections short.
+class EpochManager {
+public:
+    class ReadGuard {
+    private:
+        void* slot;
+
+    public:
+        ReadGuard();
+        ~ReadGuard();
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+    };
+
+    typedef void (*Deleter)(void*);
+
+    // Frees object with deleter after a grace period. Thread-safe.
+    static void retire(void* object, Deleter deleter);
+
+    template<typename T>
+    static void retire(T* object) {
+        retire(object, &deleteObject<T>);
+    }
+
+    // Advances the epoch if every active reader has seen the current one,
+    // then frees whatever became safe. Returns true if the epoch moved.
+    static bool tryAdvance();
+
+    // Waits until every reader active at the call has left, then frees all
+    // objects retired before the call. Must not be called inside a guard.
+    static void synchronize();
+
+    static uint64_t epoch();
+    // Objects retired but not yet freed.
+    static size_t pending();
+
+    // Retired objects that trigger an attempt to reclaim.
+    static const size_t RECLAIM_THRESHOLD = 64;
+
+private:
+    template<typename T>
+    static void deleteObject(void* object) {
+        delete static_cast<T*>(object);
+    }
+};
+
+#endif
@@ -0,0 +1,214 @@
+#ifndef RCU_LIST_H
+#define RCU_LIST_H
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include "epoch.h"
+
+// Singly linked list for read-mostly data shared by many threads.
+//
+// Readers never lock and never write shared memory: each traversal runs
+// inside an EpochManager::ReadGuard and follows next pointers with acquire
+// loads. Writers serialize on a mutex, build a node completely and then
+// publish it with one release store. An element is never modified in
+// place; replace_if() swaps in a new node instead. Unlinked nodes keep
+// their next pointer, so a reader standing on one still reaches the rest of
+// the list, and they are freed only after the epoch grace period.
+template<typename T>
+class RcuList {
+private:
+    struct Node {
+        T data;
+        std::atomic<Node*> next;
+
+        Node(const T& value, Node* next) : data(value), next(next) {}
+    };
+
+    std::atomic<Node*> head;
+    std::atomic<Node*>* tailLink;   // link to fill on push_back; writers only
+    std::atomic<size_t> count;
+    std::mutex writeLock;
+
+    void resize(size_t size) {
+        count.store(size, std::memory_order_relaxed);
+    }
+
+public:
+    // Only valid inside an EpochManager::ReadGuard held by the caller.
+    class const_iterator {
+    private:
+        const Node* current;
+
+    public:
+        explicit const_iterator(const Node* node = nullptr) : current(node) {}
+
+        const T& operator*() const { return current->data; }
+        const T* operator->() const { return &current->data; }
+        const_iterator& operator++() {
+            current = current->next.load(std::memory_order_acquire);
+            return *this;
+        }
+        const_iterator operator++(int) {
+            const_iterator old = *this;
+            ++*this;
+            return old;
+        }
+        bool operator==(const const_iterator& other) const { return current == other.current; }
+        bool operator!=(const const_iterator& other) const { return current != other.current; }
+    };
+
+    RcuList() : head(nullptr), tailLink(&head), count(0) {}
+    RcuList(const RcuList&) = delete;
+    RcuList& operator=(const RcuList&) = delete;
+
+    // No thread may still read the list.
+    ~RcuList() {
+        Node* node = head.load(std::memory_order_relaxed);
+        while (node != nullptr) {
+            Node* next = node->next.load(std::memory_order_relaxed);
+            delete node;
+            node = next;
+        }
+    }
+
+    const_iterator begin() const {
+        return const_iterator(head.load(std::memory_order_acquire));
+    }
+
+    const_iterator end() const {
+        return const_iterator(nullptr);
+    }
+
+    // Calls visit(element) for every element under a read guard.
+    template<typename Visit>
+    void for_each(Visit visit) const {
+        EpochManager::ReadGuard guard;
+        for (const Node* node = head.load(std::memory_order_acquire); node != nullptr;
+             node = node->next.load(std::memory_order_acquire)) {
+            visit(node->data);
+        }
+    }
+
+    // Copies the first element matching pred into out.
+    template<typename Predicate>
+    bool find_if(Predicate pred, T& out) const {
+        EpochManager::ReadGuard guard;
+        for (const Node* node = head.load(std::memory_order_acquire); node != nullptr;
+             node = node->next.load(std::memory_order_acquire)) {
+            if (pred(node->data)) {
+                out = node->data;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool contains(const T& value) const {
+        EpochManager::ReadGuard guard;
+        for (const Node* node = head.load(std::memory_order_acquire); node != nullptr;
+             node = node->next.load(std::memory_order_acquire)) {
+            if (node->data == value) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Approximate while writers are active.
+    size_t size() const { return count.load(std::memory_order_relaxed); }
+    bool empty() const { return head.load(std::memory_order_acquire) == nullptr; }
+
+    void push_front(const T& value) {
+        std::lock_guard<std::mutex> guard(writeLock);
+        Node* first = head.load(std::memory_order_relaxed);
+        Node* node = new Node(value, first);
+        head.store(node, std::memory_order_release);
+        if (first == nullptr) {
+            tailLink = &node->next;
+        }
+        resize(size() + 1);
+    }
+
+    void push_back(const T& value) {
+        std::lock_guard<std::mutex> guard(writeLock);
+        Node* node = new Node(value, nullptr);
+        tailLink->store(node, std::memory_order_release);
+        tailLink = &node->next;
+        resize(size() + 1);
+    }
+
+    // Unlinks every element matching pred; returns how many.
+    template<typename Predicate>
+    size_t remove_if(Predicate pred) {
+        std::lock_guard<std::mutex> guard(writeLock);
+        size_t removed = 0;
+        std::atomic<Node*>* link = &head;
+        Node* node = link->load(std::memory_order_relaxed);
+        while (node != nullptr) {
+            Node* next = node->next.load(std::memory_order_relaxed);
+            if (pred(node->data)) {
+                link->store(next, std::memory_order_release);
+                if (tailLink == &node->next) {
+                    tailLink = link;
+                }
+                EpochManager::retire(node);
+                ++removed;
+            }
+            else {
+                link = &node->next;
+            }
+            node = next;
+        }
+        resize(size() - removed);
+        return removed;
+    }
+
+    size_t remove(const T& value) {
+        return remove_if([&value](const T& element) { return element == value; });
+    }
+
+    // Replaces every element matching pred with a copy of value, node by
+    // node, so readers see either the old or the new element; returns how
+    // many were replaced.
+    template<typename Predicate>
+    size_t replace_if(Predicate pred, const T& value) {
+        std::lock_guard<std::mutex> guard(writeLock);
+        size_t replaced = 0;
+        std::atomic<Node*>* link = &head;
+        Node* node = link->load(std::memory_order_relaxed);
+        while (node != nullptr) {
+            Node* next = node->next.load(std::memory_order_relaxed);
+            if (pred(node->data)) {
+                Node* fresh = new Node(value, next);
+                link->store(fresh, std::memory_order_release);
+                if (tailLink == &node->next) {
+                    tailLink = &fresh->next;
+                }
+                EpochManager::retire(node);
+                node = fresh;
+                ++replaced;
+            }
+            link = &node->next;
+            node = next;
+        }
+        return replaced;
+    }
+
+    // Detaches the whole list at once; readers already inside it finish
+    // their traversal over the old nodes.
+    void clear() {
+        std::lock_guard<std::mutex> guard(writeLock);
+        Node* node = head.load(std::memory_order_relaxed);
+        head.store(nullptr, std::memory_order_release);
+        tailLink = &head;
+        resize(0);
+        while (node != nullptr) {
+            Node* next = node->next.load(std::memory_order_relaxed);
+            EpochManager::retire(node);
+            node = next;
+        }
+    }
+};
+
+#endif
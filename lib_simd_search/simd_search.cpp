@@ -0,0 +1,506 @@
+#include <cstdint>
+#include <type_traits>
+#include "cpu_features.h"
+#include "simd_search.h"
+
+#if defined(CPU_X86)
+#include <immintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+
+template<typename T>
+size_t find_scalar(const T* data, size_t count, T value) {
+    return scalar_find(data, count, value);
+}
+
+template<typename T>
+size_t find_last_scalar(const T* data, size_t count, T value) {
+    return scalar_find_last(data, count, value);
+}
+
+template<typename T>
+size_t count_scalar(const T* data, size_t count, T value) {
+    return scalar_count(data, count, value);
+}
+
+template<typename T>
+const SearchKernels<T>* scalar_kernels() {
+    static const SearchKernels<T> kernels = {
+        find_scalar<T>, find_last_scalar<T>, count_scalar<T>,
+        scalar_min_index<T>, scalar_max_index<T>, scalar_mismatch<T>
+    };
+    return &kernels;
+}
+
+#if defined(CPU_X86)
+
+inline unsigned lowest_bit(unsigned bits) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, bits);
+    return index;
+#else
+    return static_cast<unsigned>(__builtin_ctz(bits));
+#endif
+}
+
+inline unsigned highest_bit(unsigned bits) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse(&index, bits);
+    return index;
+#else
+    return 31 - static_cast<unsigned>(__builtin_clz(bits));
+#endif
+}
+
+// Lane operations, one struct per element type and instruction set:
+// equal() gives one bit per lane, min()/max() keep acc where x is NaN, and
+// tally() adds each lane's match to a per-lane counter that total() sums;
+// the counters may take TALLY_LIMIT blocks before they could overflow.
+
+template<typename T>
+struct Sse2Bytes {
+    typedef T Element;
+    typedef __m128i Vec;
+    static const size_t LANES = 16;
+
+    static Vec load(const T* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    static void store(T* p, Vec v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+    static Vec broadcast(T value) { return _mm_set1_epi8(static_cast<char>(value)); }
+    static unsigned equal(Vec a, Vec b) {
+        return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)));
+    }
+    // SSE2 only has unsigned byte min/max; flipping the top bit maps
+    // signed order onto unsigned order.
+    static Vec bias() { return _mm_set1_epi8(std::is_signed<T>::value ? static_cast<char>(0x80) : 0); }
+    static Vec min(Vec x, Vec acc) {
+        return _mm_xor_si128(_mm_min_epu8(_mm_xor_si128(x, bias()), _mm_xor_si128(acc, bias())), bias());
+    }
+    static Vec max(Vec x, Vec acc) {
+        return _mm_xor_si128(_mm_max_epu8(_mm_xor_si128(x, bias()), _mm_xor_si128(acc, bias())), bias());
+    }
+
+    typedef __m128i Counts;
+    static const size_t TALLY_LIMIT = 255;
+    static Counts tally(Counts counts, Vec a, Vec b) { return _mm_sub_epi8(counts, _mm_cmpeq_epi8(a, b)); }
+    static size_t total(Counts counts) {
+        __m128i sums = _mm_sad_epu8(counts, _mm_setzero_si128());
+        return static_cast<size_t>(_mm_cvtsi128_si32(sums) + _mm_cvtsi128_si32(_mm_srli_si128(sums, 8)));
+    }
+};
+
+template<typename T>
+struct Sse2Words {
+    typedef T Element;
+    typedef __m128i Vec;
+    static const size_t LANES = 4;
+
+    static Vec load(const T* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    static void store(T* p, Vec v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+    static Vec broadcast(T value) { return _mm_set1_epi32(static_cast<int>(value)); }
+    static unsigned equal(Vec a, Vec b) {
+        return static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, b))));
+    }
+    // No 32-bit min/max before SSE4.1: select through a signed compare,
+    // with unsigned values biased into signed order first.
+    static Vec greater(Vec a, Vec b) {
+        const __m128i flip = _mm_set1_epi32(std::is_signed<T>::value ? 0 : INT32_MIN);
+        return _mm_cmpgt_epi32(_mm_xor_si128(a, flip), _mm_xor_si128(b, flip));
+    }
+    static Vec select(Vec mask, Vec a, Vec b) {
+        return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+    }
+    static Vec min(Vec x, Vec acc) { return select(greater(acc, x), x, acc); }
+    static Vec max(Vec x, Vec acc) { return select(greater(x, acc), x, acc); }
+
+    typedef __m128i Counts;
+    static const size_t TALLY_LIMIT = UINT32_MAX;
+    static Counts tally(Counts counts, Vec a, Vec b) { return _mm_sub_epi32(counts, _mm_cmpeq_epi32(a, b)); }
+    static size_t total(Counts counts) {
+        uint32_t lanes[4];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), counts);
+        return static_cast<size_t>(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+    }
+};
+
+struct Sse2Floats {
+    typedef float Element;
+    typedef __m128 Vec;
+    static const size_t LANES = 4;
+
+    static Vec load(const float* p) { return _mm_loadu_ps(p); }
+    static void store(float* p, Vec v) { _mm_storeu_ps(p, v); }
+    static Vec broadcast(float value) { return _mm_set1_ps(value); }
+    static unsigned equal(Vec a, Vec b) { return static_cast<unsigned>(_mm_movemask_ps(_mm_cmpeq_ps(a, b))); }
+    static Vec min(Vec x, Vec acc) { return _mm_min_ps(x, acc); }
+    static Vec max(Vec x, Vec acc) { return _mm_max_ps(x, acc); }
+
+    typedef __m128i Counts;
+    static const size_t TALLY_LIMIT = UINT32_MAX;
+    static Counts tally(Counts counts, Vec a, Vec b) {
+        return _mm_sub_epi32(counts, _mm_castps_si128(_mm_cmpeq_ps(a, b)));
+    }
+    static size_t total(Counts counts) {
+        uint32_t lanes[4];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), counts);
+        return static_cast<size_t>(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+    }
+};
+
+struct Sse2Doubles {
+    typedef double Element;
+    typedef __m128d Vec;
+    static const size_t LANES = 2;
+
+    static Vec load(const double* p) { return _mm_loadu_pd(p); }
+    static void store(double* p, Vec v) { _mm_storeu_pd(p, v); }
+    static Vec broadcast(double value) { return _mm_set1_pd(value); }
+    static unsigned equal(Vec a, Vec b) { return static_cast<unsigned>(_mm_movemask_pd(_mm_cmpeq_pd(a, b))); }
+    static Vec min(Vec x, Vec acc) { return _mm_min_pd(x, acc); }
+    static Vec max(Vec x, Vec acc) { return _mm_max_pd(x, acc); }
+
+    typedef __m128i Counts;
+    static const size_t TALLY_LIMIT = SIZE_MAX;
+    static Counts tally(Counts counts, Vec a, Vec b) {
+        return _mm_sub_epi64(counts, _mm_castpd_si128(_mm_cmpeq_pd(a, b)));
+    }
+    static size_t total(Counts counts) {
+        uint64_t lanes[2];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), counts);
+        return static_cast<size_t>(lanes[0] + lanes[1]);
+    }
+};
+
+template<typename T>
+struct Avx2Bytes {
+    typedef T Element;
+    typedef __m256i Vec;
+    static const size_t LANES = 32;
+
+    CPU_TARGET_AVX2 static Vec load(const T* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    CPU_TARGET_AVX2 static void store(T* p, Vec v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+    CPU_TARGET_AVX2 static Vec broadcast(T value) { return _mm256_set1_epi8(static_cast<char>(value)); }
+    CPU_TARGET_AVX2 static unsigned equal(Vec a, Vec b) {
+        return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)));
+    }
+    CPU_TARGET_AVX2 static Vec min(Vec x, Vec acc) {
+        return std::is_signed<T>::value ? _mm256_min_epi8(x, acc) : _mm256_min_epu8(x, acc);
+    }
+    CPU_TARGET_AVX2 static Vec max(Vec x, Vec acc) {
+        return std::is_signed<T>::value ? _mm256_max_epi8(x, acc) : _mm256_max_epu8(x, acc);
+    }
+
+    typedef __m256i Counts;
+    static const size_t TALLY_LIMIT = 255;
+    CPU_TARGET_AVX2 static Counts tally(Counts counts, Vec a, Vec b) {
+        return _mm256_sub_epi8(counts, _mm256_cmpeq_epi8(a, b));
+    }
+    CPU_TARGET_AVX2 static size_t total(Counts counts) {
+        uint64_t lanes[4];
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), _mm256_sad_epu8(counts, _mm256_setzero_si256()));
+        return static_cast<size_t>(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+    }
+};
+
+template<typename T>
+struct Avx2Words {
+    typedef T Element;
+    typedef __m256i Vec;
+    static const size_t LANES = 8;
+
+    CPU_TARGET_AVX2 static Vec load(const T* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    CPU_TARGET_AVX2 static void store(T* p, Vec v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+    CPU_TARGET_AVX2 static Vec broadcast(T value) { return _mm256_set1_epi32(static_cast<int>(value)); }
+    CPU_TARGET_AVX2 static unsigned equal(Vec a, Vec b) {
+        return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b))));
+    }
+    CPU_TARGET_AVX2 static Vec min(Vec x, Vec acc) {
+        return std::is_signed<T>::value ? _mm256_min_epi32(x, acc) : _mm256_min_epu32(x, acc);
+    }
+    CPU_TARGET_AVX2 static Vec max(Vec x, Vec acc) {
+        return std::is_signed<T>::value ? _mm256_max_epi32(x, acc) : _mm256_max_epu32(x, acc);
+    }
+
+    typedef __m256i Counts;
+    static const size_t TALLY_LIMIT = UINT32_MAX;
+    CPU_TARGET_AVX2 static Counts tally(Counts counts, Vec a, Vec b) {
+        return _mm256_sub_epi32(counts, _mm256_cmpeq_epi32(a, b));
+    }
+    CPU_TARGET_AVX2 static size_t total(Counts counts) {
+        uint32_t lanes[8];
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), counts);
+        size_t sum = 0;
+        for (uint32_t lane : lanes) {
+            sum += lane;
+        }
+        return sum;
+    }
+};
+
+struct Avx2Floats {
+    typedef float Element;
+    typedef __m256 Vec;
+    static const size_t LANES = 8;
+
+    CPU_TARGET_AVX2 static Vec load(const float* p) { return _mm256_loadu_ps(p); }
+    CPU_TARGET_AVX2 static void store(float* p, Vec v) { _mm256_storeu_ps(p, v); }
+    CPU_TARGET_AVX2 static Vec broadcast(float value) { return _mm256_set1_ps(value); }
+    CPU_TARGET_AVX2 static unsigned equal(Vec a, Vec b) {
+        return static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ)));
+    }
+    CPU_TARGET_AVX2 static Vec min(Vec x, Vec acc) { return _mm256_min_ps(x, acc); }
+    CPU_TARGET_AVX2 static Vec max(Vec x, Vec acc) { return _mm256_max_ps(x, acc); }
+
+    typedef __m256i Counts;
+    static const size_t TALLY_LIMIT = UINT32_MAX;
+    CPU_TARGET_AVX2 static Counts tally(Counts counts, Vec a, Vec b) {
+        return _mm256_sub_epi32(counts, _mm256_castps_si256(_mm256_cmp_ps(a, b, _CMP_EQ_OQ)));
+    }
+    CPU_TARGET_AVX2 static size_t total(Counts counts) {
+        uint32_t lanes[8];
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), counts);
+        size_t sum = 0;
+        for (uint32_t lane : lanes) {
+            sum += lane;
+        }
+        return sum;
+    }
+};
+
+struct Avx2Doubles {
+    typedef double Element;
+    typedef __m256d Vec;
+    static const size_t LANES = 4;
+
+    CPU_TARGET_AVX2 static Vec load(const double* p) { return _mm256_loadu_pd(p); }
+    CPU_TARGET_AVX2 static void store(double* p, Vec v) { _mm256_storeu_pd(p, v); }
+    CPU_TARGET_AVX2 static Vec broadcast(double value) { return _mm256_set1_pd(value); }
+    CPU_TARGET_AVX2 static unsigned equal(Vec a, Vec b) {
+        return static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ)));
+    }
+    CPU_TARGET_AVX2 static Vec min(Vec x, Vec acc) { return _mm256_min_pd(x, acc); }
+    CPU_TARGET_AVX2 static Vec max(Vec x, Vec acc) { return _mm256_max_pd(x, acc); }
+
+    typedef __m256i Counts;
+    static const size_t TALLY_LIMIT = SIZE_MAX;
+    CPU_TARGET_AVX2 static Counts tally(Counts counts, Vec a, Vec b) {
+        return _mm256_sub_epi64(counts, _mm256_castpd_si256(_mm256_cmp_pd(a, b, _CMP_EQ_OQ)));
+    }
+    CPU_TARGET_AVX2 static size_t total(Counts counts) {
+        uint64_t lanes[4];
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), counts);
+        return static_cast<size_t>(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+    }
+};
+
+// The kernels, written once over the lane operations. They are stamped out
+// per instruction set because GCC and Clang inline the AVX2 intrinsics
+// only into functions that carry the target attribute themselves.
+#define SEARCH_KERNELS(PREFIX, TARGET)                                                   \
+template<typename Ops>                                                                   \
+TARGET size_t PREFIX##_find(const typename Ops::Element* data, size_t count,             \
+                            typename Ops::Element value) {                               \
+    typename Ops::Vec needle = Ops::broadcast(value);                                    \
+    size_t i = 0;                                                                        \
+    for (; i + Ops::LANES <= count; i += Ops::LANES) {                                   \
+        unsigned bits = Ops::equal(Ops::load(data + i), needle);                         \
+        if (bits != 0) {                                                                 \
+            return i + lowest_bit(bits);                                                 \
+        }                                                                                \
+    }                                                                                    \
+    size_t rest = scalar_find(data + i, count - i, value);                               \
+    return rest == count - i ? count : i + rest;                                         \
+}                                                                                        \
+                                                                                         \
+template<typename Ops>                                                                   \
+TARGET size_t PREFIX##_find_last(const typename Ops::Element* data, size_t count,        \
+                                 typename Ops::Element value) {                          \
+    typename Ops::Vec needle = Ops::broadcast(value);                                    \
+    size_t end = count;                                                                  \
+    for (; end >= Ops::LANES; end -= Ops::LANES) {                                       \
+        unsigned bits = Ops::equal(Ops::load(data + end - Ops::LANES), needle);          \
+        if (bits != 0) {                                                                 \
+            return end - Ops::LANES + highest_bit(bits);                                 \
+        }                                                                                \
+    }                                                                                    \
+    size_t rest = scalar_find_last(data, end, value);                                    \
+    return rest == end ? count : rest;                                                   \
+}                                                                                        \
+                                                                                         \
+template<typename Ops>                                                                   \
+TARGET size_t PREFIX##_count(const typename Ops::Element* data, size_t count,            \
+                             typename Ops::Element value) {                              \
+    typename Ops::Vec needle = Ops::broadcast(value);                                    \
+    size_t found = 0;                                                                    \
+    size_t i = 0;                                                                        \
+    while (count - i >= Ops::LANES) {                                                    \
+        size_t blocks = (count - i) / Ops::LANES;                                        \
+        if (blocks > Ops::TALLY_LIMIT) {                                                 \
+            blocks = Ops::TALLY_LIMIT;                                                   \
+        }                                                                                \
+        size_t end = i + blocks * Ops::LANES;                                            \
+        typename Ops::Counts counts = typename Ops::Counts();                            \
+        for (; i < end; i += Ops::LANES) {                                               \
+            counts = Ops::tally(counts, Ops::load(data + i), needle);                    \
+        }                                                                                \
+        found += Ops::total(counts);                                                     \
+    }                                                                                    \
+    return found + scalar_count(data + i, count - i, value);                             \
+}                                                                                        \
+                                                                                         \
+/* The smallest (or largest) value, then its first position. A leading */               \
+/* NaN wins, as it does in the scalar loop; any other NaN is skipped.   */               \
+template<typename Ops, bool LARGEST>                                                     \
+TARGET size_t PREFIX##_extreme_index(const typename Ops::Element* data, size_t count) {  \
+    typedef typename Ops::Element Element;                                               \
+    if (!(data[0] == data[0])) {                                                         \
+        return 0;                                                                        \
+    }                                                                                    \
+    typename Ops::Vec best = Ops::broadcast(data[0]);                                    \
+    size_t i = 0;                                                                        \
+    for (; i + Ops::LANES <= count; i += Ops::LANES) {                                   \
+        typename Ops::Vec v = Ops::load(data + i);                                       \
+        best = LARGEST ? Ops::max(v, best) : Ops::min(v, best);                          \
+    }                                                                                    \
+    Element lanes[Ops::LANES];                                                           \
+    Ops::store(lanes, best);                                                             \
+    Element value = lanes[0];                                                            \
+    for (size_t lane = 1; lane < Ops::LANES; ++lane) {                                   \
+        if (LARGEST ? lanes[lane] > value : lanes[lane] < value) {                       \
+            value = lanes[lane];                                                         \
+        }                                                                                \
+    }                                                                                    \
+    for (; i < count; ++i) {                                                             \
+        if (LARGEST ? data[i] > value : data[i] < value) {                               \
+            value = data[i];                                                             \
+        }                                                                                \
+    }                                                                                    \
+    return PREFIX##_find<Ops>(data, count, value);                                       \
+}                                                                                        \
+                                                                                         \
+template<typename Ops>                                                                   \
+TARGET size_t PREFIX##_min_index(const typename Ops::Element* data, size_t count) {      \
+    return PREFIX##_extreme_index<Ops, false>(data, count);                              \
+}                                                                                        \
+                                                                                         \
+template<typename Ops>                                                                   \
+TARGET size_t PREFIX##_max_index(const typename Ops::Element* data, size_t count) {      \
+    return PREFIX##_extreme_index<Ops, true>(data, count);                               \
+}                                                                                        \
+                                                                                         \
+template<typename Ops>                                                                   \
+TARGET size_t PREFIX##_mismatch(const typename Ops::Element* a,                          \
+                                const typename Ops::Element* b, size_t count) {          \
+    const unsigned all = static_cast<unsigned>((uint64_t(1) << Ops::LANES) - 1);         \
+    size_t i = 0;                                                                        \
+    for (; i + Ops::LANES <= count; i += Ops::LANES) {                                   \
+        unsigned bits = Ops::equal(Ops::load(a + i), Ops::load(b + i));                  \
+        if (bits != all) {                                                               \
+            return i + lowest_bit(~bits & all);                                          \
+        }                                                                                \
+    }                                                                                    \
+    return i + scalar_mismatch(a + i, b + i, count - i);                                 \
+}                                                                                        \
+                                                                                         \
+template<typename Ops>                                                                   \
+const SearchKernels<typename Ops::Element>* PREFIX##_kernels() {                         \
+    static const SearchKernels<typename Ops::Element> kernels = {                        \
+        PREFIX##_find<Ops>, PREFIX##_find_last<Ops>, PREFIX##_count<Ops>,                \
+        PREFIX##_min_index<Ops>, PREFIX##_max_index<Ops>, PREFIX##_mismatch<Ops>         \
+    };                                                                                   \
+    return &kernels;                                                                     \
+}
+
+SEARCH_KERNELS(sse2, )
+SEARCH_KERNELS(avx2, CPU_TARGET_AVX2)
+
+#undef SEARCH_KERNELS
+
+template<typename T> struct Sse2Ops;
+template<> struct Sse2Ops<char> { typedef Sse2Bytes<char> type; };
+template<> struct Sse2Ops<signed char> { typedef Sse2Bytes<signed char> type; };
+template<> struct Sse2Ops<unsigned char> { typedef Sse2Bytes<unsigned char> type; };
+template<> struct Sse2Ops<int> { typedef Sse2Words<int> type; };
+template<> struct Sse2Ops<unsigned> { typedef Sse2Words<unsigned> type; };
+template<> struct Sse2Ops<float> { typedef Sse2Floats type; };
+template<> struct Sse2Ops<double> { typedef Sse2Doubles type; };
+
+template<typename T> struct Avx2Ops;
+template<> struct Avx2Ops<char> { typedef Avx2Bytes<char> type; };
+template<> struct Avx2Ops<signed char> { typedef Avx2Bytes<signed char> type; };
+template<> struct Avx2Ops<unsigned char> { typedef Avx2Bytes<unsigned char> type; };
+template<> struct Avx2Ops<int> { typedef Avx2Words<int> type; };
+template<> struct Avx2Ops<unsigned> { typedef Avx2Words<unsigned> type; };
+template<> struct Avx2Ops<float> { typedef Avx2Floats type; };
+template<> struct Avx2Ops<double> { typedef Avx2Doubles type; };
+
+static_assert(sizeof(int) == 4 && sizeof(unsigned) == 4, "the word kernels assume 32-bit int");
+
+#endif
+
+template<typename T>
+const SearchKernels<T>* best_kernels() {
+#if defined(CPU_X86)
+    if (cpu_features().avx2) {
+        return avx2_kernels<typename Avx2Ops<T>::type>();
+    }
+    if (cpu_features().sse2) {
+        return sse2_kernels<typename Sse2Ops<T>::type>();
+    }
+#endif
+    return scalar_kernels<T>();
+}
+
+}  // namespace
+
+bool search_kernel_supported(SearchKernel kernel) {
+    const CpuFeatures& cpu = cpu_features();
+    switch (kernel) {
+    case SearchKernel::AUTO:
+    case SearchKernel::SCALAR:
+        return true;
+#if defined(CPU_X86)
+    case SearchKernel::SSE2:
+        return cpu.sse2;
+    case SearchKernel::AVX2:
+        return cpu.avx2;
+#endif
+    default:
+        (void)cpu;
+        return false;
+    }
+}
+
+template<typename T>
+const SearchKernels<T>* search_kernels(SearchKernel kernel) {
+    if (kernel == SearchKernel::AUTO) {
+        static const SearchKernels<T>* best = best_kernels<T>();
+        return best;
+    }
+    if (!search_kernel_supported(kernel)) {
+        return nullptr;
+    }
+    switch (kernel) {
+#if defined(CPU_X86)
+    case SearchKernel::SSE2:
+        return sse2_kernels<typename Sse2Ops<T>::type>();
+    case SearchKernel::AVX2:
+        return avx2_kernels<typename Avx2Ops<T>::type>();
+#endif
+    default:
+        return scalar_kernels<T>();
+    }
+}
+
+template const SearchKernels<char>* search_kernels<char>(SearchKernel);
+template const SearchKernels<signed char>* search_kernels<signed char>(SearchKernel);
+template const SearchKernels<unsigned char>* search_kernels<unsigned char>(SearchKernel);
+template const SearchKernels<int>* search_kernels<int>(SearchKernel);
+template const SearchKernels<unsigned>* search_kernels<unsigned>(SearchKernel);
+template const SearchKernels<float>* search_kernels<float>(SearchKernel);
+template const SearchKernels<double>* search_kernels<double>(SearchKernel);
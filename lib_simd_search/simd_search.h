@@ -0,0 +1,204 @@
+#ifndef SIMD_SEARCH_H
+#define SIMD_SEARCH_H
+
+#include <cstddef>
+#include <type_traits>
+
+// Linear search over one contiguous span, used by ArrayStack and Queue (a
+// wrapped Queue is two spans). char, signed/unsigned char, int, unsigned,
+// float and double get SSE2 and AVX2 kernels picked at run time; every
+// other type takes the plain loops below. Comparisons are the ones the
+// scalar code makes: == for equality, < and > for ordering, so a NaN
+// matches nothing and is never an extreme unless it comes first.
+enum class SearchKernel {
+    AUTO,
+    SCALAR,
+    SSE2,
+    AVX2
+};
+
+// Results are indices into the span; count means "none".
+template<typename T>
+struct SearchKernels {
+    size_t (*find)(const T* data, size_t count, T value);
+    size_t (*findLast)(const T* data, size_t count, T value);
+    size_t (*count)(const T* data, size_t count, T value);
+    // First smallest/largest element; count must be positive.
+    size_t (*minIndex)(const T* data, size_t count);
+    size_t (*maxIndex)(const T* data, size_t count);
+    // First i with a[i] != b[i].
+    size_t (*mismatch)(const T* a, const T* b, size_t count);
+};
+
+template<typename T>
+struct has_search_kernels : std::integral_constant<bool,
+    std::is_same<T, char>::value || std::is_same<T, signed char>::value ||
+    std::is_same<T, unsigned char>::value || std::is_same<T, int>::value ||
+    std::is_same<T, unsigned>::value || std::is_same<T, float>::value ||
+    std::is_same<T, double>::value> {};
+
+bool search_kernel_supported(SearchKernel kernel);
+
+// AUTO picks the widest kernel the CPU supports. Returns nullptr for an
+// unsupported kernel. Defined for the types of has_search_kernels.
+template<typename T>
+const SearchKernels<T>* search_kernels(SearchKernel kernel = SearchKernel::AUTO);
+
+// Shorter spans are not worth the indirect call.
+const size_t SEARCH_KERNEL_MIN_COUNT = 32;
+
+// The plain loops: the SCALAR kernels, and the whole story for other types.
+template<typename T>
+size_t scalar_find(const T* data, size_t count, const T& value) {
+    for (size_t i = 0; i < count; ++i) {
+        if (data[i] == value) {
+            return i;
+        }
+    }
+    return count;
+}
+
+template<typename T>
+size_t scalar_find_last(const T* data, size_t count, const T& value) {
+    for (size_t i = count; i > 0; --i) {
+        if (data[i - 1] == value) {
+            return i - 1;
+        }
+    }
+    return count;
+}
+
+template<typename T>
+size_t scalar_count(const T* data, size_t count, const T& value) {
+    size_t found = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (data[i] == value) {
+            ++found;
+        }
+    }
+    return found;
+}
+
+template<typename T>
+size_t scalar_min_index(const T* data, size_t count) {
+    size_t best = 0;
+    for (size_t i = 1; i < count; ++i) {
+        if (data[i] < data[best]) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+template<typename T>
+size_t scalar_max_index(const T* data, size_t count) {
+    size_t best = 0;
+    for (size_t i = 1; i < count; ++i) {
+        if (data[i] > data[best]) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+template<typename T>
+size_t scalar_mismatch(const T* a, const T* b, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        if (a[i] != b[i]) {
+            return i;
+        }
+    }
+    return count;
+}
+
+template<typename T>
+typename std::enable_if<has_search_kernels<T>::value, size_t>::type
+span_find(const T* data, size_t count, const T& value) {
+    if (count < SEARCH_KERNEL_MIN_COUNT) {
+        return scalar_find(data, count, value);
+    }
+    return search_kernels<T>()->find(data, count, value);
+}
+
+template<typename T>
+typename std::enable_if<!has_search_kernels<T>::value, size_t>::type
+span_find(const T* data, size_t count, const T& value) {
+    return scalar_find(data, count, value);
+}
+
+template<typename T>
+typename std::enable_if<has_search_kernels<T>::value, size_t>::type
+span_find_last(const T* data, size_t count, const T& value) {
+    if (count < SEARCH_KERNEL_MIN_COUNT) {
+        return scalar_find_last(data, count, value);
+    }
+    return search_kernels<T>()->findLast(data, count, value);
+}
+
+template<typename T>
+typename std::enable_if<!has_search_kernels<T>::value, size_t>::type
+span_find_last(const T* data, size_t count, const T& value) {
+    return scalar_find_last(data, count, value);
+}
+
+template<typename T>
+typename std::enable_if<has_search_kernels<T>::value, size_t>::type
+span_count(const T* data, size_t count, const T& value) {
+    if (count < SEARCH_KERNEL_MIN_COUNT) {
+        return scalar_count(data, count, value);
+    }
+    return search_kernels<T>()->count(data, count, value);
+}
+
+template<typename T>
+typename std::enable_if<!has_search_kernels<T>::value, size_t>::type
+span_count(const T* data, size_t count, const T& value) {
+    return scalar_count(data, count, value);
+}
+
+template<typename T>
+typename std::enable_if<has_search_kernels<T>::value, size_t>::type
+span_min_index(const T* data, size_t count) {
+    if (count < SEARCH_KERNEL_MIN_COUNT) {
+        return scalar_min_index(data, count);
+    }
+    return search_kernels<T>()->minIndex(data, count);
+}
+
+template<typename T>
+typename std::enable_if<!has_search_kernels<T>::value, size_t>::type
+span_min_index(const T* data, size_t count) {
+    return scalar_min_index(data, count);
+}
+
+template<typename T>
+typename std::enable_if<has_search_kernels<T>::value, size_t>::type
+span_max_index(const T* data, size_t count) {
+    if (count < SEARCH_KERNEL_MIN_COUNT) {
+        return scalar_max_index(data, count);
+    }
+    return search_kernels<T>()->maxIndex(data, count);
+}
+
+template<typename T>
+typename std::enable_if<!has_search_kernels<T>::value, size_t>::type
+span_max_index(const T* data, size_t count) {
+    return scalar_max_index(data, count);
+}
+
+template<typename T>
+typename std::enable_if<has_search_kernels<T>::value, size_t>::type
+span_mismatch(const T* a, const T* b, size_t count) {
+    if (count < SEARCH_KERNEL_MIN_COUNT) {
+        return scalar_mismatch(a, b, count);
+    }
+    return search_kernels<T>()->mismatch(a, b, count);
+}
+
+template<typename T>
+typename std::enable_if<!has_search_kernels<T>::value, size_t>::type
+span_mismatch(const T* a, const T* b, size_t count) {
+    return scalar_mismatch(a, b, count);
+}
+
+#endif
@@ -0,0 +1,397 @@
+#ifndef SKIP_LIST_H
+#define SKIP_LIST_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <utility>
+#include "epoch.h"
+#include "error_policy.h"
+
+// Ordered map for many threads, after the lazy skip list of Herlihy, Lev,
+// Luchangco and Shavit. Lookups and iteration take no locks; insert and
+// erase lock only the predecessors they relink. Erase first marks a node
+// (logical removal), then unlinks it.
+//
+// Values are immutable once inserted. Every operation runs inside an
+// EpochManager::ReadGuard, and erased nodes are retired to EpochManager, so
+// a node is freed only after every thread that might still stand on it has
+// left its guard. Iterators are weakly consistent: they never see a torn
+// entry and never skip an entry that stays in the map for the whole scan,
+// but may or may not see concurrent inserts and erases. While other
+// threads erase, hold a ReadGuard for as long as an iterator is in use.
+template<typename K, typename V, typename Compare = std::less<K>>
+class ConcurrentSkipListMap {
+public:
+    typedef std::pair<const K, V> value_type;
+    static const int MAX_LEVEL = 24;
+
+private:
+    // One allocation per node: the level links trail the struct, so a hop
+    // touches a single cache line for both the key and the next pointer.
+    struct Node {
+        std::atomic<bool> marked;
+        std::atomic<bool> fullyLinked;
+        int height;
+        std::mutex lock;
+        union {
+            value_type entry;   // left unconstructed in the head node
+        };
+        std::atomic<Node*> next[1];   // really `height` links
+
+        explicit Node(int height) : marked(false), fullyLinked(false), height(height) {
+            for (int level = 0; level < height; ++level) {
+                new (next + level) std::atomic<Node*>(nullptr);
+            }
+        }
+        ~Node() {}
+
+        static Node* create(int height) {
+            void* memory = ::operator new(sizeof(Node) + (height - 1) * sizeof(std::atomic<Node*>));
+            return new (memory) Node(height);
+        }
+
+        static Node* create(const K& key, const V& value, int height) {
+            Node* node = create(height);
+            ASD_TRY {
+                new (&node->entry) value_type(key, value);
+            }
+            ASD_CATCH_ALL {
+                destroy(node, false);
+                ASD_RETHROW;
+            }
+            return node;
+        }
+
+        static void destroy(Node* node, bool hasEntry = true) {
+            if (hasEntry) {
+                node->entry.~value_type();
+            }
+            node->~Node();
+            ::operator delete(node);
+        }
+
+        // EpochManager's deleter for an erased node.
+        static void destroyRetired(void* node) {
+            destroy(static_cast<Node*>(node));
+        }
+    };
+
+    Node* head;
+    std::atomic<int> topLevel;   // levels in use; searches start below it
+    std::atomic<size_t> count;
+    Compare less;
+
+    static int randomHeight() {
+        static std::atomic<uint64_t> seeds(0x2545F4914F6CDD1Dull);
+        thread_local uint64_t state = seeds.fetch_add(0x9E3779B97F4A7C15ull) | 1;
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        // One level per trailing one bit: P(height > h) = 2^-h.
+        int height = 1;
+        for (uint64_t bits = state; (bits & 1) && height < MAX_LEVEL; bits >>= 1) {
+            ++height;
+        }
+        return height;
+    }
+
+    // Fills preds/succs with the last node before key and the first at or
+    // after it on every level; returns the highest level where succ holds
+    // key, or -1.
+    int search(const K& key, Node** preds, Node** succs) const {
+        int found = -1;
+        Node* pred = head;
+        int top = topLevel.load(std::memory_order_acquire);
+        for (int level = MAX_LEVEL - 1; level >= top; --level) {
+            preds[level] = head;
+            succs[level] = head->next[level].load(std::memory_order_acquire);
+        }
+        for (int level = top - 1; level >= 0; --level) {
+            Node* current = pred->next[level].load(std::memory_order_acquire);
+            while (current != nullptr && less(current->entry.first, key)) {
+                pred = current;
+                current = pred->next[level].load(std::memory_order_acquire);
+            }
+            if (found == -1 && current != nullptr && !less(key, current->entry.first)) {
+                found = level;
+            }
+            preds[level] = pred;
+            succs[level] = current;
+        }
+        return found;
+    }
+
+    // Locks each distinct predecessor on levels [0, height) bottom-up and
+    // checks that pred still links to succ and that neither is being erased
+    // (succ may be, when it is the node erase() is unlinking).
+    // Returns the number of levels locked, negated on failure.
+    static int lockPredecessors(Node** preds, Node** succs, int height, bool succMayBeMarked) {
+        Node* previous = nullptr;
+        for (int level = 0; level < height; ++level) {
+            Node* pred = preds[level];
+            if (pred != previous) {
+                pred->lock.lock();
+                previous = pred;
+            }
+            bool valid = !pred->marked.load(std::memory_order_acquire)
+                && pred->next[level].load(std::memory_order_acquire) == succs[level]
+                && (succMayBeMarked || succs[level] == nullptr
+                    || !succs[level]->marked.load(std::memory_order_acquire));
+            if (!valid) {
+                return -(level + 1);
+            }
+        }
+        return height;
+    }
+
+    static void unlockPredecessors(Node** preds, int levels) {
+        Node* previous = nullptr;
+        for (int level = 0; level < levels; ++level) {
+            if (preds[level] != previous) {
+                preds[level]->lock.unlock();
+                previous = preds[level];
+            }
+        }
+    }
+
+    // Last node before key on level 0; stops early at a node holding key.
+    Node* descend(const K& key) const {
+        Node* pred = head;
+        for (int level = topLevel.load(std::memory_order_acquire) - 1; level >= 0; --level) {
+            Node* current = pred->next[level].load(std::memory_order_acquire);
+            while (current != nullptr && less(current->entry.first, key)) {
+                pred = current;
+                current = pred->next[level].load(std::memory_order_acquire);
+            }
+            if (current != nullptr && !less(key, current->entry.first)) {
+                return current;
+            }
+        }
+        return pred;
+    }
+
+    // First live node at or after node on level 0.
+    static Node* live(Node* node) {
+        while (node != nullptr && node->marked.load(std::memory_order_acquire)) {
+            node = node->next[0].load(std::memory_order_acquire);
+        }
+        return node;
+    }
+
+public:
+    class const_iterator {
+    private:
+        Node* current;
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef typename ConcurrentSkipListMap::value_type value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const value_type& reference;
+        typedef const value_type* pointer;
+
+        explicit const_iterator(Node* node = nullptr) : current(node) {}
+
+        reference operator*() const { return current->entry; }
+        pointer operator->() const { return &current->entry; }
+        const_iterator& operator++() {
+            current = live(current->next[0].load(std::memory_order_acquire));
+            return *this;
+        }
+        const_iterator operator++(int) {
+            const_iterator old = *this;
+            ++*this;
+            return old;
+        }
+        bool operator==(const const_iterator& other) const { return current == other.current; }
+        bool operator!=(const const_iterator& other) const { return current != other.current; }
+    };
+
+    typedef const_iterator iterator;
+
+    explicit ConcurrentSkipListMap(const Compare& compare = Compare())
+        : head(Node::create(MAX_LEVEL)), topLevel(1), count(0), less(compare) {}
+
+    ConcurrentSkipListMap(const ConcurrentSkipListMap&) = delete;
+    ConcurrentSkipListMap& operator=(const ConcurrentSkipListMap&) = delete;
+
+    // No thread may still use the map. Erased nodes are EpochManager's and
+    // are freed by it after their grace period.
+    ~ConcurrentSkipListMap() {
+        Node* node = head->next[0].load(std::memory_order_relaxed);
+        while (node != nullptr) {
+            Node* next = node->next[0].load(std::memory_order_relaxed);
+            Node::destroy(node);
+            node = next;
+        }
+        Node::destroy(head, false);
+    }
+
+    // Inserts {key, value} unless key is present; returns true if inserted.
+    bool insert(const K& key, const V& value) {
+        int height = randomHeight();
+        int top = topLevel.load(std::memory_order_relaxed);
+        while (top < height && !topLevel.compare_exchange_weak(top, height, std::memory_order_release,
+                                                                std::memory_order_relaxed)) {
+        }
+        Node* preds[MAX_LEVEL];
+        Node* succs[MAX_LEVEL];
+        Node* created = nullptr;   // kept across retries until linked
+        EpochManager::ReadGuard guard;
+        while (true) {
+            int found = search(key, preds, succs);
+            if (found != -1) {
+                Node* existing = succs[found];
+                if (!existing->marked.load(std::memory_order_acquire)) {
+                    // Wait for a concurrent insert of the same key to finish
+                    // so that a following find() sees it.
+                    while (!existing->fullyLinked.load(std::memory_order_acquire)) {
+                        std::this_thread::yield();
+                    }
+                    if (created != nullptr) {
+                        Node::destroy(created);
+                    }
+                    return false;
+                }
+                continue;   // being erased: retry once it is unlinked
+            }
+
+            // Built before any lock is taken, so a throwing allocation or
+            // copy cannot leave the predecessors locked.
+            if (created == nullptr) {
+                created = Node::create(key, value, height);
+            }
+            int locked = lockPredecessors(preds, succs, height, false);
+            if (locked < 0) {
+                unlockPredecessors(preds, -locked);
+                continue;
+            }
+            for (int level = 0; level < height; ++level) {
+                created->next[level].store(succs[level], std::memory_order_relaxed);
+            }
+            for (int level = 0; level < height; ++level) {
+                preds[level]->next[level].store(created, std::memory_order_release);
+            }
+            created->fullyLinked.store(true, std::memory_order_release);
+            unlockPredecessors(preds, height);
+            count.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    // Returns true if key was present and this call removed it.
+    bool erase(const K& key) {
+        Node* preds[MAX_LEVEL];
+        Node* succs[MAX_LEVEL];
+        Node* victim = nullptr;
+        EpochManager::ReadGuard guard;
+        while (true) {
+            int found = search(key, preds, succs);
+            if (victim == nullptr) {
+                if (found == -1) {
+                    return false;
+                }
+                Node* candidate = succs[found];
+                // A node still being inserted, or already being erased, is
+                // not there yet or any more.
+                if (!candidate->fullyLinked.load(std::memory_order_acquire)
+                    || candidate->height - 1 != found
+                    || candidate->marked.load(std::memory_order_acquire)) {
+                    return false;
+                }
+                candidate->lock.lock();
+                if (candidate->marked.load(std::memory_order_relaxed)) {
+                    candidate->lock.unlock();
+                    return false;
+                }
+                candidate->marked.store(true, std::memory_order_release);
+                victim = candidate;
+            }
+
+            for (int level = 0; level < victim->height; ++level) {
+                succs[level] = victim;
+            }
+            int locked = lockPredecessors(preds, succs, victim->height, true);
+            if (locked < 0) {
+                unlockPredecessors(preds, -locked);
+                continue;
+            }
+            for (int level = victim->height - 1; level >= 0; --level) {
+                preds[level]->next[level].store(victim->next[level].load(std::memory_order_relaxed),
+                                                std::memory_order_release);
+            }
+            victim->lock.unlock();
+            unlockPredecessors(preds, victim->height);
+            EpochManager::retire(victim, &Node::destroyRetired);
+            count.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    // Copies the value for key into `value`; false if key is absent.
+    bool find(const K& key, V& value) const {
+        EpochManager::ReadGuard guard;
+        const_iterator it = lookup(key);
+        if (it == end()) {
+            return false;
+        }
+        value = it->second;
+        return true;
+    }
+
+    bool contains(const K& key) const {
+        EpochManager::ReadGuard guard;
+        return lookup(key) != end();
+    }
+
+    // First entry with a key not less than key. See the class comment on
+    // holding a ReadGuard while iterating.
+    const_iterator lower_bound(const K& key) const {
+        Node* node = descend(key);
+        if (node == head || less(node->entry.first, key)) {
+            node = node->next[0].load(std::memory_order_acquire);
+        }
+        return const_iterator(live(node));
+    }
+
+    const_iterator begin() const {
+        return const_iterator(live(head->next[0].load(std::memory_order_acquire)));
+    }
+
+    const_iterator end() const {
+        return const_iterator(nullptr);
+    }
+
+    // Approximate while other threads are updating the map.
+    size_t size() const { return count.load(std::memory_order_relaxed); }
+    bool empty() const { return size() == 0; }
+
+    // Erased nodes are freed as the epoch advances during normal use; this
+    // waits out the grace period and frees them now. Must not be called
+    // inside a ReadGuard.
+    void collect() {
+        EpochManager::synchronize();
+    }
+
+private:
+    const_iterator lookup(const K& key) const {
+        Node* node = descend(key);
+        if (node == head || less(node->entry.first, key)) {
+            return end();
+        }
+        bool present = node->fullyLinked.load(std::memory_order_acquire)
+            && !node->marked.load(std::memory_order_acquire);
+        return present ? const_iterator(node) : end();
+    }
+};
+
+template<typename K, typename V, typename Compare>
+const int ConcurrentSkipListMap<K, V, Compare>::MAX_LEVEL;
+
+#endif
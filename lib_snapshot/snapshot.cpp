@@ -0,0 +1,163 @@
+#include <cstring>
+#include <stdexcept>
+#include "snapshot.h"
+#include "error_policy.h"
+
+const size_t SnapshotChecksum::BLOCK;
+
+namespace {
+
+const char MAGIC[8] = { 'A', 'S', 'D', 'S', 'N', 'A', 'P', '\0' };
+const uint32_t BYTE_ORDER_MARK = 0x01020304;
+const uint64_t PRIME_1 = 0x9E3779B185EBCA87ull;
+const uint64_t PRIME_2 = 0xC2B2AE3D27D4EB4Full;
+
+static_assert(sizeof(SnapshotHeader) == 64, "Snapshot header must stay 64 bytes");
+
+uint64_t rotate_left(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+uint64_t load_word(const unsigned char* bytes) {
+    uint64_t word;
+    std::memcpy(&word, bytes, sizeof(word));
+    return word;
+}
+
+uint64_t round_up(uint64_t value, uint64_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+}  // namespace
+
+SnapshotChecksum::SnapshotChecksum() : buffered(0), total(0) {
+    lanes[0] = PRIME_1 + PRIME_2;
+    lanes[1] = PRIME_2;
+    lanes[2] = 0;
+    lanes[3] = 0 - PRIME_1;
+}
+
+void SnapshotChecksum::consume(const unsigned char* block) {
+    for (int lane = 0; lane < 4; ++lane) {
+        uint64_t mixed = lanes[lane] + load_word(block + 8 * lane) * PRIME_2;
+        lanes[lane] = rotate_left(mixed, 31) * PRIME_1;
+    }
+}
+
+void SnapshotChecksum::update(const void* data, size_t length) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    total += length;
+    if (buffered != 0) {
+        size_t take = BLOCK - buffered < length ? BLOCK - buffered : length;
+        std::memcpy(buffer + buffered, bytes, take);
+        buffered += take;
+        bytes += take;
+        length -= take;
+        if (buffered < BLOCK) {
+            return;
+        }
+        consume(buffer);
+        buffered = 0;
+    }
+    for (; length >= BLOCK; bytes += BLOCK, length -= BLOCK) {
+        consume(bytes);
+    }
+    std::memcpy(buffer, bytes, length);
+    buffered = length;
+}
+
+uint64_t SnapshotChecksum::value() const {
+    uint64_t result = rotate_left(lanes[0], 1) + rotate_left(lanes[1], 7)
+        + rotate_left(lanes[2], 12) + rotate_left(lanes[3], 18);
+    result += total;
+    unsigned char tail[BLOCK] = {};
+    std::memcpy(tail, buffer, buffered);
+    for (size_t offset = 0; offset < buffered; offset += 8) {
+        result ^= rotate_left(load_word(tail + offset) * PRIME_2, 31) * PRIME_1;
+        result = rotate_left(result, 27) * PRIME_1 + PRIME_2;
+    }
+    result ^= result >> 33;
+    result *= PRIME_2;
+    result ^= result >> 29;
+    return result;
+}
+
+SnapshotWriter::SnapshotWriter(const std::string& path, size_t elementSize, size_t elementAlign)
+    : out(path, std::ios::binary | std::ios::trunc), path(path) {
+    if (!out) {
+        ASD_THROW(std::runtime_error("Cannot create snapshot: " + path));
+    }
+    std::memset(&header, 0, sizeof(header));
+    header.version = SNAPSHOT_VERSION;
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.elementSize = elementSize;
+    header.elementAlign = elementAlign;
+    header.payloadOffset = round_up(sizeof(header), elementAlign > PAYLOAD_ALIGNMENT ? elementAlign : PAYLOAD_ALIGNMENT);
+
+    // Header with a zero magic plus padding; finish() fills the magic in.
+    std::vector<char> prefix(static_cast<size_t>(header.payloadOffset), 0);
+    std::memcpy(prefix.data(), &header, sizeof(header));
+    out.write(prefix.data(), static_cast<std::streamsize>(prefix.size()));
+    if (!out) {
+        ASD_THROW(std::runtime_error("Cannot write snapshot: " + path));
+    }
+}
+
+void SnapshotWriter::append(const void* elements, size_t count) {
+    size_t bytes = count * static_cast<size_t>(header.elementSize);
+    if (bytes == 0) {
+        return;
+    }
+    out.write(static_cast<const char*>(elements), static_cast<std::streamsize>(bytes));
+    if (!out) {
+        ASD_THROW(std::runtime_error("Cannot write snapshot: " + path));
+    }
+    checksum.update(elements, bytes);
+    header.count += count;
+}
+
+void SnapshotWriter::finish() {
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.checksum = checksum.value();
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.close();
+    if (!out) {
+        ASD_THROW(std::runtime_error("Cannot write snapshot: " + path));
+    }
+}
+
+SnapshotFile::SnapshotFile(const std::string& path, size_t elementSize, size_t elementAlign, bool verify)
+    : file(path, MappedFile::Access::SEQUENTIAL), payload(nullptr) {
+    if (file.size() < sizeof(header)) {
+        ASD_THROW(std::runtime_error("Not a snapshot: " + path));
+    }
+    const char* view = file.map(0, static_cast<size_t>(file.size()));
+    std::memcpy(&header, view, sizeof(header));
+
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        ASD_THROW(std::runtime_error("Not a snapshot: " + path));
+    }
+    if (header.version != SNAPSHOT_VERSION) {
+        ASD_THROW(std::runtime_error("Unsupported snapshot version: " + path));
+    }
+    if (header.byteOrder != BYTE_ORDER_MARK) {
+        ASD_THROW(std::runtime_error("Snapshot was written with another byte order: " + path));
+    }
+    if (header.elementSize != elementSize || header.elementAlign != elementAlign) {
+        ASD_THROW(std::runtime_error("Snapshot holds a different element type: " + path));
+    }
+    if (header.payloadOffset % elementAlign != 0 || header.payloadOffset > file.size()
+        || (file.size() - header.payloadOffset) / elementSize < header.count) {
+        ASD_THROW(std::runtime_error("Snapshot is truncated: " + path));
+    }
+
+    payload = view + header.payloadOffset;
+    if (verify) {
+        SnapshotChecksum actual;
+        actual.update(payload, static_cast<size_t>(header.count * elementSize));
+        if (actual.value() != header.checksum) {
+            ASD_THROW(std::runtime_error("Snapshot checksum mismatch: " + path));
+        }
+    }
+}
@@ -0,0 +1,181 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "list.h"
+#include "mapped_file.h"
+#include "queue.h"
+#include "stack.h"
+
+// Binary snapshots of containers of trivially copyable elements.
+//
+// Layout: a 64-byte SnapshotHeader, zero padding up to payloadOffset, then
+// count * elementSize bytes of elements in container order (front to back,
+// bottom to top). payloadOffset is a multiple of PAYLOAD_ALIGNMENT, so a
+// mapped payload is aligned for any element type. The checksum covers the
+// payload only. Integers are stored in the writer's byte order; readers
+// reject a file from the other one.
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint64_t elementSize;
+    uint64_t elementAlign;
+    uint64_t count;
+    uint64_t payloadOffset;
+    uint64_t checksum;
+    uint64_t reserved;
+};
+
+const uint32_t SNAPSHOT_VERSION = 1;
+const size_t PAYLOAD_ALIGNMENT = 64;
+
+// 64-bit checksum that can be fed in pieces of any length. Four
+// independent multiply-rotate lanes over 32-byte blocks keep it well ahead
+// of disk and page-fault speed.
+class SnapshotChecksum {
+private:
+    static const size_t BLOCK = 32;
+
+    uint64_t lanes[4];
+    unsigned char buffer[BLOCK];   // start of an unfinished block
+    size_t buffered;
+    uint64_t total;
+
+    void consume(const unsigned char* block);
+
+public:
+    SnapshotChecksum();
+    void update(const void* data, size_t length);
+    uint64_t value() const;
+};
+
+// Streams a snapshot to disk. Throws std::runtime_error on I/O failure.
+class SnapshotWriter {
+private:
+    std::ofstream out;
+    std::string path;
+    SnapshotHeader header;
+    SnapshotChecksum checksum;
+
+public:
+    SnapshotWriter(const std::string& path, size_t elementSize, size_t elementAlign);
+    SnapshotWriter(const SnapshotWriter&) = delete;
+    SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+
+    void append(const void* elements, size_t count);
+    // Writes the final header and closes the file. Until then the file
+    // carries a zero magic and no reader accepts it.
+    void finish();
+};
+
+// A snapshot mapped read-only. Throws std::runtime_error if the file is
+// not a snapshot, has another version or byte order, does not match the
+// expected element size and alignment, is truncated, or (when verify is
+// set) fails its checksum.
+class SnapshotFile {
+private:
+    MappedFile file;
+    SnapshotHeader header;
+    const char* payload;
+
+public:
+    SnapshotFile(const std::string& path, size_t elementSize, size_t elementAlign, bool verify);
+
+    size_t count() const { return static_cast<size_t>(header.count); }
+    const void* data() const { return payload; }
+};
+
+// Zero-copy read-only view of a snapshot; the elements live in the mapping
+// and stay valid for the lifetime of the view.
+template<typename T>
+class SnapshotView {
+    static_assert(std::is_trivially_copyable<T>::value, "Snapshots hold trivially copyable types only");
+
+private:
+    SnapshotFile file;
+
+public:
+    explicit SnapshotView(const std::string& path, bool verify = true)
+        : file(path, sizeof(T), alignof(T), verify) {}
+
+    const T* data() const { return static_cast<const T*>(file.data()); }
+    size_t size() const { return file.count(); }
+    bool empty() const { return size() == 0; }
+    const T& operator[](size_t index) const { return data()[index]; }
+    const T* begin() const { return data(); }
+    const T* end() const { return data() + size(); }
+};
+
+template<typename T>
+void save_snapshot(const std::string& path, const T* elements, size_t count) {
+    static_assert(std::is_trivially_copyable<T>::value, "Snapshots hold trivially copyable types only");
+    SnapshotWriter writer(path, sizeof(T), alignof(T));
+    writer.append(elements, count);
+    writer.finish();
+}
+
+template<typename T, typename Allocator>
+void save_snapshot(const std::string& path, const Queue<T, Allocator>& queue) {
+    static_assert(std::is_trivially_copyable<T>::value, "Snapshots hold trivially copyable types only");
+    SnapshotWriter writer(path, sizeof(T), alignof(T));
+    typename Queue<T, Allocator>::Span first = queue.firstSpan();
+    typename Queue<T, Allocator>::Span second = queue.secondSpan();
+    writer.append(first.data, first.size);
+    writer.append(second.data, second.size);
+    writer.finish();
+}
+
+template<typename T, size_t MAX_SIZE>
+void save_snapshot(const std::string& path, const ArrayStack<T, MAX_SIZE>& stack) {
+    save_snapshot(path, stack.elements(), stack.size());
+}
+
+// List nodes are not contiguous, so elements go through a small buffer.
+template<typename T, typename Allocator>
+void save_snapshot(const std::string& path, List<T, Allocator>& list) {
+    static_assert(std::is_trivially_copyable<T>::value, "Snapshots hold trivially copyable types only");
+    const size_t BATCH = 4096;
+    SnapshotWriter writer(path, sizeof(T), alignof(T));
+    std::vector<T> batch;
+    batch.reserve(BATCH);
+    for (auto it = list.begin(); it != list.end(); ++it) {
+        batch.push_back(*it);
+        if (batch.size() == BATCH) {
+            writer.append(batch.data(), batch.size());
+            batch.clear();
+        }
+    }
+    writer.append(batch.data(), batch.size());
+    writer.finish();
+}
+
+// Bulk loads: one memcpy from the mapping into the container's storage.
+template<typename T, typename Allocator>
+void load_snapshot(const std::string& path, Queue<T, Allocator>& queue, bool verify = true) {
+    SnapshotView<T> view(path, verify);
+    queue.assign(view.data(), view.size());
+}
+
+template<typename T, size_t MAX_SIZE>
+void load_snapshot(const std::string& path, ArrayStack<T, MAX_SIZE>& stack, bool verify = true) {
+    SnapshotView<T> view(path, verify);
+    stack.assign(view.data(), view.size());
+}
+
+template<typename T, typename Allocator>
+void load_snapshot(const std::string& path, List<T, Allocator>& list, bool verify = true) {
+    SnapshotView<T> view(path, verify);
+    List<T, Allocator> loaded(list.get_allocator());
+    for (const T& element : view) {
+        loaded.push_back(element);
+    }
+    list.swap(loaded);
+}
+
+#endif
@@ -0,0 +1,300 @@
+#ifndef SPILLING_QUEUE_H
+#define SPILLING_QUEUE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include "queue.h"
+#include "snapshot.h"
+#include "error_policy.h"
+
+// FIFO queue of trivially copyable elements whose middle can live on disk.
+//
+// Elements are grouped into segments of segmentElements. Pushes fill the
+// in-memory tail segment; pops drain the head segment. A full tail joins
+// the middle and stays in memory while the memory budget allows;
+// otherwise it is written, in one sequential append, to its own snapshot
+// file in `directory`. When the head runs out, the next middle segment
+// becomes the head: in memory directly, or by mapping its file with
+// sequential read-ahead. Files are deleted once drained and by the
+// destructor.
+//
+// I/O failures and corrupted segments throw std::runtime_error.
+template<typename T>
+class SpillingQueue {
+    static_assert(std::is_trivially_copyable<T>::value, "Spilled elements must be trivially copyable");
+
+public:
+    struct Stats {
+        size_t memoryBudget;
+        size_t residentBytes;       // segment buffers and mapped head
+        size_t peakResidentBytes;
+        size_t segmentsOnDisk;
+        uint64_t segmentsSpilled;
+        uint64_t segmentsLoaded;
+        uint64_t bytesSpilled;
+        uint64_t bytesLoaded;
+    };
+
+private:
+    struct Segment {
+        uint64_t id;
+        size_t count;
+        T* data;   // nullptr when the segment is in its file
+    };
+
+    std::string directory;
+    std::string prefix;
+    size_t segmentElements;
+    size_t segmentBytes;
+
+    // Head: elements headData[headPosition, headCount), from headBuffer or
+    // from the mapped file of segment headFile.
+    T* headBuffer;
+    std::unique_ptr<SnapshotView<T>> headView;
+    uint64_t headFile;
+    const T* headData;
+    size_t headPosition;
+    size_t headCount;
+
+    Queue<Segment> middle;
+    size_t residentMiddle;
+
+    T* tailBuffer;
+    size_t tailCount;
+
+    T last;
+    size_t count;
+    uint64_t nextId;
+    Stats statistics;
+
+    std::string segmentPath(uint64_t id) const {
+        return directory + "/" + prefix + std::to_string(id) + ".seg";
+    }
+
+    size_t residentBytes() const {
+        size_t buffers = (headBuffer != nullptr) + (headView != nullptr) + (tailBuffer != nullptr) + residentMiddle;
+        return buffers * segmentBytes;
+    }
+
+    void account() {
+        statistics.residentBytes = residentBytes();
+        if (statistics.residentBytes > statistics.peakResidentBytes) {
+            statistics.peakResidentBytes = statistics.residentBytes;
+        }
+    }
+
+    void releaseHeadView() {
+        if (headView != nullptr) {
+            headView.reset();
+            std::remove(segmentPath(headFile).c_str());
+        }
+    }
+
+    // Moves the full tail into the middle, in memory if a fresh tail buffer
+    // still fits the budget, otherwise into a file. Changes nothing if it
+    // throws, so a failed spill can be retried.
+    void seal() {
+        Segment segment = { nextId, tailCount, nullptr };
+        if (residentBytes() + segmentBytes <= statistics.memoryBudget) {
+            T* fresh = new T[segmentElements];
+            segment.data = tailBuffer;
+            ASD_TRY {
+                middle.push(segment);
+            }
+            ASD_CATCH_ALL {
+                delete[] fresh;
+                ASD_RETHROW;
+            }
+            tailBuffer = fresh;
+            ++residentMiddle;
+        }
+        else {
+            std::string path = segmentPath(segment.id);
+            save_snapshot(path, tailBuffer, tailCount);
+            ASD_TRY {
+                middle.push(segment);
+            }
+            ASD_CATCH_ALL {
+                std::remove(path.c_str());
+                ASD_RETHROW;
+            }
+            ++statistics.segmentsOnDisk;
+            ++statistics.segmentsSpilled;
+            statistics.bytesSpilled += tailCount * sizeof(T);
+        }
+        ++nextId;
+        tailCount = 0;
+        account();
+    }
+
+    // Makes the next elements the head once the current one is drained.
+    // The next source is opened before the old head is let go, so a
+    // missing or corrupt segment throws with the queue unchanged.
+    void refill() {
+        if (!middle.empty()) {
+            const Segment& segment = middle.front();
+            if (segment.data != nullptr) {
+                releaseHeadView();
+                delete[] headBuffer;
+                headBuffer = segment.data;
+                headData = headBuffer;
+                --residentMiddle;
+            }
+            else {
+                std::unique_ptr<SnapshotView<T>> view(new SnapshotView<T>(segmentPath(segment.id)));
+                // The mapping takes the place of the head buffer in the budget.
+                releaseHeadView();
+                delete[] headBuffer;
+                headBuffer = nullptr;
+                headView = std::move(view);
+                headFile = segment.id;
+                headData = headView->data();
+                --statistics.segmentsOnDisk;
+                ++statistics.segmentsLoaded;
+                statistics.bytesLoaded += segment.count * sizeof(T);
+            }
+            headCount = segment.count;
+            middle.pop();
+        }
+        else if (tailCount != 0) {
+            if (headBuffer == nullptr) {
+                headBuffer = new T[segmentElements];
+            }
+            releaseHeadView();
+            std::swap(headBuffer, tailBuffer);
+            headData = headBuffer;
+            headCount = tailCount;
+            tailCount = 0;
+        }
+        else {
+            releaseHeadView();
+            headData = headBuffer;
+            headCount = 0;
+        }
+        headPosition = 0;
+        account();
+    }
+
+    static std::string uniquePrefix() {
+        static std::atomic<uint64_t> instances(0);
+        uint64_t stamp = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+        return "spill-" + std::to_string(stamp) + "-" + std::to_string(instances.fetch_add(1)) + "-";
+    }
+
+public:
+    // The budget must hold at least the head and tail segments.
+    SpillingQueue(const std::string& directory, size_t segmentElements, size_t memoryBudget)
+        : directory(directory), prefix(uniquePrefix()), segmentElements(segmentElements),
+          segmentBytes(segmentElements * sizeof(T)), headBuffer(nullptr), headFile(0), headData(nullptr),
+          headPosition(0), headCount(0), residentMiddle(0), tailBuffer(nullptr), tailCount(0),
+          last(), count(0), nextId(0), statistics() {
+        if (segmentElements == 0) {
+            ASD_THROW(std::invalid_argument("Segment size must be positive"));
+        }
+        if (memoryBudget < 2 * segmentBytes) {
+            ASD_THROW(std::invalid_argument("Memory budget must hold at least two segments"));
+        }
+        statistics.memoryBudget = memoryBudget;
+        tailBuffer = new T[segmentElements];
+        account();
+    }
+
+    SpillingQueue(const SpillingQueue&) = delete;
+    SpillingQueue& operator=(const SpillingQueue&) = delete;
+
+    ~SpillingQueue() {
+        clear();
+        delete[] headBuffer;
+        delete[] tailBuffer;
+    }
+
+    // A full tail is sealed before the value is stored, so a push whose
+    // spill fails leaves the queue unchanged.
+    void push(const T& value) {
+        if (tailCount == segmentElements) {
+            seal();
+        }
+        tailBuffer[tailCount++] = value;
+        if (headPosition == headCount) {
+            ASD_TRY {
+                refill();
+            }
+            ASD_CATCH_ALL {
+                --tailCount;
+                ASD_RETHROW;
+            }
+        }
+        last = value;
+        ++count;
+    }
+
+    void pop() {
+        if (empty()) {
+            ASD_THROW(std::runtime_error("Queue is empty"));
+        }
+        ++headPosition;
+        --count;
+        if (headPosition == headCount && count != 0) {
+            ASD_TRY {
+                refill();
+            }
+            ASD_CATCH_ALL {
+                // The old head is still in place: undo the pop.
+                --headPosition;
+                ++count;
+                ASD_RETHROW;
+            }
+        }
+    }
+
+    const T& front() const {
+        if (empty()) {
+            ASD_THROW(std::runtime_error("Queue is empty"));
+        }
+        return headData[headPosition];
+    }
+
+    const T& back() const {
+        if (empty()) {
+            ASD_THROW(std::runtime_error("Queue is empty"));
+        }
+        return last;
+    }
+
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+    size_t segmentSize() const { return segmentElements; }
+    const Stats& stats() const { return statistics; }
+
+    // Drops every element and deletes the spill files.
+    void clear() {
+        while (!middle.empty()) {
+            Segment segment = middle.front();
+            middle.pop();
+            if (segment.data != nullptr) {
+                delete[] segment.data;
+            }
+            else {
+                std::remove(segmentPath(segment.id).c_str());
+            }
+        }
+        residentMiddle = 0;
+        statistics.segmentsOnDisk = 0;
+        releaseHeadView();
+        headData = headBuffer;
+        headPosition = 0;
+        headCount = 0;
+        tailCount = 0;
+        count = 0;
+        account();
+    }
+};
+
+#endif
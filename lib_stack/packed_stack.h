@@ -0,0 +1,196 @@
+#ifndef PACKED_STACK_H
+#define PACKED_STACK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <algorithm>
+#include "error_policy.h"
+
+// Growable stack of small codes (BITS wide) packed into 64-bit words.
+// The topmost word lives in a member, so push/pop only touch the word
+// array once per CODES_PER_WORD operations.
+template<unsigned BITS = 2>
+class PackedStack {
+    static_assert(BITS > 0 && BITS <= 32 && 64 % BITS == 0,
+                  "BITS must divide 64");
+
+public:
+    static const size_t CODES_PER_WORD = 64 / BITS;
+    static const uint64_t CODE_MASK = (uint64_t(1) << BITS) - 1;
+
+private:
+    uint64_t* words;
+    size_t wordCapacity;
+    size_t count;
+    uint64_t topWord;
+
+    void spill() {
+        size_t index = count / CODES_PER_WORD - 1;
+        if (index == wordCapacity) {
+            reserveWords(wordCapacity == 0 ? 4 : wordCapacity * 2);
+        }
+        words[index] = topWord;
+        topWord = 0;
+    }
+
+    void reserveWords(size_t newCapacity) {
+        uint64_t* newWords = new uint64_t[newCapacity];
+        for (size_t i = 0; i < wordCapacity; ++i) {
+            newWords[i] = words[i];
+        }
+        delete[] words;
+        words = newWords;
+        wordCapacity = newCapacity;
+    }
+
+public:
+    PackedStack() : words(nullptr), wordCapacity(0), count(0), topWord(0) {}
+
+    PackedStack(const PackedStack& other)
+        : words(nullptr), wordCapacity(0), count(other.count), topWord(other.topWord) {
+        if (other.wordCapacity != 0) {
+            reserveWords(other.wordCapacity);
+            std::copy(other.words, other.words + other.wordCapacity, words);
+        }
+    }
+
+    PackedStack(PackedStack&& other) noexcept
+        : words(other.words), wordCapacity(other.wordCapacity),
+        count(other.count), topWord(other.topWord) {
+        other.words = nullptr;
+        other.wordCapacity = 0;
+        other.count = 0;
+        other.topWord = 0;
+    }
+
+    ~PackedStack() {
+        delete[] words;
+    }
+
+    PackedStack& operator=(const PackedStack& other) {
+        if (this != &other) {
+            PackedStack copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    PackedStack& operator=(PackedStack&& other) noexcept {
+        if (this != &other) {
+            delete[] words;
+            words = other.words;
+            wordCapacity = other.wordCapacity;
+            count = other.count;
+            topWord = other.topWord;
+            other.words = nullptr;
+            other.wordCapacity = 0;
+            other.count = 0;
+            other.topWord = 0;
+        }
+        return *this;
+    }
+
+    void push(unsigned code) {
+        if (count != 0 && count % CODES_PER_WORD == 0) {
+            spill();
+        }
+        topWord = (topWord << BITS) | (code & CODE_MASK);
+        ++count;
+    }
+
+    unsigned pop() {
+        if (isEmpty()) {
+            ASD_THROW(std::underflow_error("Stack underflow"));
+        }
+        unsigned code = static_cast<unsigned>(topWord & CODE_MASK);
+        topWord >>= BITS;
+        --count;
+        if (count != 0 && count % CODES_PER_WORD == 0) {
+            topWord = words[count / CODES_PER_WORD - 1];
+        }
+        return code;
+    }
+
+    unsigned top() const {
+        if (isEmpty()) {
+            ASD_THROW(std::underflow_error("Stack is empty"));
+        }
+        return static_cast<unsigned>(topWord & CODE_MASK);
+    }
+
+    bool isEmpty() const {
+        return count == 0;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    // Number of codes that fit without reallocating.
+    size_t capacity() const {
+        return (wordCapacity + 1) * CODES_PER_WORD;
+    }
+
+    void reserve(size_t codes) {
+        size_t needed = codes == 0 ? 0 : (codes - 1) / CODES_PER_WORD;
+        if (needed > wordCapacity) {
+            reserveWords(needed);
+        }
+    }
+
+    void clear() {
+        count = 0;
+        topWord = 0;
+    }
+
+    // Pushes n codes laid out like the top word: the oldest code in the
+    // highest bits, the newest in the lowest.
+    void pushPacked(uint64_t codes, unsigned n) {
+        while (n > 0) {
+            size_t used = count % CODES_PER_WORD;
+            if (used == 0 && count != 0) {
+                spill();
+            }
+            unsigned room = static_cast<unsigned>(CODES_PER_WORD - used);
+            unsigned take = n < room ? n : room;
+            unsigned rest = n - take;
+            if (take == CODES_PER_WORD) {
+                topWord = codes;
+            }
+            else {
+                uint64_t chunk = (codes >> (rest * BITS)) & ((uint64_t(1) << (take * BITS)) - 1);
+                topWord = (topWord << (take * BITS)) | chunk;
+            }
+            count += take;
+            n = rest;
+        }
+    }
+
+    // Pushes every code of other, bottom first, a word at a time.
+    void append(const PackedStack& other) {
+        if (other.count == 0) {
+            return;
+        }
+        size_t fullWords = (other.count - 1) / CODES_PER_WORD;
+        for (size_t i = 0; i < fullWords; ++i) {
+            pushPacked(other.words[i], static_cast<unsigned>(CODES_PER_WORD));
+        }
+        pushPacked(other.topWord, static_cast<unsigned>(other.count - fullWords * CODES_PER_WORD));
+    }
+
+    void swap(PackedStack& other) {
+        std::swap(words, other.words);
+        std::swap(wordCapacity, other.wordCapacity);
+        std::swap(count, other.count);
+        std::swap(topWord, other.topWord);
+    }
+};
+
+template<unsigned BITS>
+const size_t PackedStack<BITS>::CODES_PER_WORD;
+
+template<unsigned BITS>
+const uint64_t PackedStack<BITS>::CODE_MASK;
+
+#endif
@@ -1,22 +1,62 @@
 #ifndef STACK_H
 #define STACK_H
 
+#include <algorithm>
+#include <cassert>
 #include <iostream>
 #include <stdexcept>
 #include <initializer_list>
+#include <utility>
+#include "instrument.h"
+#include "error_policy.h"
+#include "simd_search.h"
+
+// Usable in constant expressions (C++14 relaxed constexpr) for literal T
+// when constructed from ZeroFilled{}: everything but assign(), copy
+// construction and the searches. An instrumented build counts operations
+// at run time, so there ArrayStack is an ordinary class and
+// ASD_CONSTEXPR_ARRAY_STACK is left undefined.
+#if !defined(ASD_INSTRUMENT)
+#define ASD_CONSTEXPR_ARRAY_STACK
+#endif
+
+// Selects the ArrayStack constructors that value-initialise the storage.
+struct ZeroFilled {};
 
 template<typename T, size_t MAX_SIZE = 100>
 class ArrayStack {
 private:
     T data[MAX_SIZE];
     int topIndex;
+    CONTAINER_PROBE_MEMBER("ArrayStack")
 
 public:
-    ArrayStack() : topIndex(-1) {}
+    // Storage is inline, so an instrumented stack reports no allocations
+    // and a constant capacity of MAX_SIZE.
+    ArrayStack() : topIndex(-1) {
+        CONTAINER_PROBE(trackCapacity(MAX_SIZE));
+    }
 
     ArrayStack(std::initializer_list<T> initList) : topIndex(-1) {
+        CONTAINER_PROBE(trackCapacity(MAX_SIZE));
+        if (initList.size() > MAX_SIZE) {
+            ASD_THROW(std::overflow_error("Initializer list exceeds stack capacity"));
+        }
+        for (const auto& item : initList) {
+            push(item);
+        }
+    }
+
+    // Constant evaluation needs every slot initialised, so these fill all
+    // MAX_SIZE of them first; the constructors above leave them as they are.
+    constexpr explicit ArrayStack(ZeroFilled) : data(), topIndex(-1) {
+        CONTAINER_PROBE(trackCapacity(MAX_SIZE));
+    }
+
+    constexpr ArrayStack(ZeroFilled, std::initializer_list<T> initList) : data(), topIndex(-1) {
+        CONTAINER_PROBE(trackCapacity(MAX_SIZE));
         if (initList.size() > MAX_SIZE) {
-            throw std::overflow_error("Initializer list exceeds stack capacity");
+            ASD_THROW(std::overflow_error("Initializer list exceeds stack capacity"));
         }
         for (const auto& item : initList) {
             push(item);
@@ -24,173 +64,215 @@ public:
     }
 
     ArrayStack(const ArrayStack& other) : topIndex(other.topIndex) {
+        CONTAINER_PROBE(trackCapacity(MAX_SIZE));
+        CONTAINER_PROBE(trackSize(size()));
         for (int i = 0; i <= topIndex; ++i) {
             data[i] = other.data[i];
         }
     }
 
-    ArrayStack& operator=(const ArrayStack& other) {
+    constexpr ArrayStack& operator=(const ArrayStack& other) {
         if (this != &other) {
             topIndex = other.topIndex;
             for (int i = 0; i <= topIndex; ++i) {
                 data[i] = other.data[i];
             }
+            CONTAINER_PROBE(trackSize(size()));
         }
         return *this;
     }
 
-    void push(const T& value) {
+    constexpr void push(const T& value) {
+        if (isFull()) {
+            ASD_THROW(std::overflow_error("Stack overflow"));
+        }
+        data[++topIndex] = value;
+        CONTAINER_PROBE(countOperation());
+        CONTAINER_PROBE(trackSize(size()));
+    }
+
+    constexpr void push(T&& value) {
+        if (isFull()) {
+            ASD_THROW(std::overflow_error("Stack overflow"));
+        }
+        data[++topIndex] = std::move(value);
+        CONTAINER_PROBE(countOperation());
+        CONTAINER_PROBE(trackSize(size()));
+    }
+
+    constexpr T pop() {
+        if (isEmpty()) {
+            ASD_THROW(std::underflow_error("Stack underflow"));
+        }
+        return pop_unchecked();
+    }
+
+    // Non-throwing variants for hot loops: the try_ calls report a full or
+    // empty stack through their result, pop_unchecked only asserts it.
+    constexpr bool try_push(const T& value) {
         if (isFull()) {
-            throw std::overflow_error("Stack overflow");
+            return false;
         }
         data[++topIndex] = value;
+        CONTAINER_PROBE(countOperation());
+        CONTAINER_PROBE(trackSize(size()));
+        return true;
     }
 
-    void push(T&& value) {
+    constexpr bool try_push(T&& value) {
         if (isFull()) {
-            throw std::overflow_error("Stack overflow");
+            return false;
         }
         data[++topIndex] = std::move(value);
+        CONTAINER_PROBE(countOperation());
+        CONTAINER_PROBE(trackSize(size()));
+        return true;
     }
 
-    T pop() {
+    constexpr bool try_pop(T& out) {
         if (isEmpty()) {
-            throw std::underflow_error("Stack underflow");
+            return false;
         }
+        out = std::move(data[topIndex]);
+        pop_unchecked();
+        return true;
+    }
+
+    constexpr T pop_unchecked() {
+        assert(!isEmpty() && "pop_unchecked on an empty stack");
+        CONTAINER_PROBE(countOperation());
+        CONTAINER_PROBE(trackSize(size() - 1));
         return data[topIndex--];
     }
 
-    T& top() {
+    constexpr T& top() {
         if (isEmpty()) {
-            throw std::underflow_error("Stack is empty");
+            ASD_THROW(std::underflow_error("Stack is empty"));
         }
         return data[topIndex];
     }
 
-    const T& top() const {
+    constexpr const T& top() const {
         if (isEmpty()) {
-            throw std::underflow_error("Stack is empty");
+            ASD_THROW(std::underflow_error("Stack is empty"));
         }
         return data[topIndex];
     }
 
-    bool isEmpty() const {
+    constexpr bool isEmpty() const {
         return topIndex == -1;
     }
 
-    bool isFull() const {
+    constexpr bool isFull() const {
         return topIndex >= static_cast<int>(MAX_SIZE) - 1;
     }
 
-    size_t size() const {
+    constexpr size_t size() const {
         return topIndex + 1;
     }
 
-    size_t capacity() const {
+    constexpr size_t capacity() const {
         return MAX_SIZE;
     }
 
-    void clear() {
+    constexpr void clear() {
         topIndex = -1;
+        CONTAINER_PROBE(countOperation());
+        CONTAINER_PROBE(trackSize(0));
     }
 
-    T& at(int index) {
+    // Replaces the contents with values[0, count), bottom first, in one
+    // bulk copy (a single memmove for trivially copyable T).
+    void assign(const T* values, size_t count) {
+        if (count > MAX_SIZE) {
+            ASD_THROW(std::overflow_error("Stack overflow"));
+        }
+        std::copy(values, values + count, data);
+        topIndex = static_cast<int>(count) - 1;
+        CONTAINER_PROBE(countOperation());
+        CONTAINER_PROBE(trackSize(count));
+    }
+
+    // The elements from bottom to top, size() of them.
+    constexpr const T* elements() const {
+        return data;
+    }
+
+    // Zeros unless built with ASD_INSTRUMENT; see instrument.h.
+    ContainerStats stats() const {
+        return CONTAINER_STATS();
+    }
+
+    void setStatsLabel(const std::string& label) {
+        CONTAINER_PROBE(setLabel(label));
+        (void)label;
+    }
+
+    constexpr T& at(int index) {
         if (index < 0 || index > topIndex) {
-            throw std::out_of_range("Index out of range");
+            ASD_THROW(std::out_of_range("Index out of range"));
         }
         return data[topIndex - index];
     }
 
-    const T& at(int index) const {
+    constexpr const T& at(int index) const {
         if (index < 0 || index > topIndex) {
-            throw std::out_of_range("Index out of range");
+            ASD_THROW(std::out_of_range("Index out of range"));
         }
         return data[topIndex - index];
     }
 
-    T& operator[](int index) {
+    constexpr T& operator[](int index) {
         return at(index);
     }
 
-    const T& operator[](int index) const {
+    constexpr const T& operator[](int index) const {
         return at(index);
     }
 
+    // Searches run through simd_search.h: vectorised for arithmetic T.
+
+    // Distance from the top of the topmost match, or -1.
     int find(const T& value) const {
-        for (int i = topIndex; i >= 0; --i) {
-            if (data[i] == value) {
-                return topIndex - i;
-            }
-        }
-        return -1;
+        size_t at = span_find_last(data, size(), value);
+        return at == size() ? -1 : topIndex - static_cast<int>(at);
     }
 
+    size_t count(const T& value) const {
+        return span_count(data, size(), value);
+    }
+
+    // The first smallest/largest element from the bottom.
     T& minElement() {
         if (isEmpty()) {
-            throw std::underflow_error("Stack is empty");
-        }
-
-        T& minVal = data[0];
-        for (int i = 1; i <= topIndex; ++i) {
-            if (data[i] < minVal) {
-                minVal = data[i];
-            }
+            ASD_THROW(std::underflow_error("Stack is empty"));
         }
-        return minVal;
+        return data[span_min_index(data, size())];
     }
 
     const T& minElement() const {
         if (isEmpty()) {
-            throw std::underflow_error("Stack is empty");
-        }
-
-        const T& minVal = data[0];
-        for (int i = 1; i <= topIndex; ++i) {
-            if (data[i] < minVal) {
-                minVal = data[i];
-            }
+            ASD_THROW(std::underflow_error("Stack is empty"));
         }
-        return minVal;
+        return data[span_min_index(data, size())];
     }
 
     T& maxElement() {
         if (isEmpty()) {
-            throw std::underflow_error("Stack is empty");
+            ASD_THROW(std::underflow_error("Stack is empty"));
         }
-
-        T& maxVal = data[0];
-        for (int i = 1; i <= topIndex; ++i) {
-            if (data[i] > maxVal) {
-                maxVal = data[i];
-            }
-        }
-        return maxVal;
+        return data[span_max_index(data, size())];
     }
 
     const T& maxElement() const {
         if (isEmpty()) {
-            throw std::underflow_error("Stack is empty");
-        }
-
-        const T& maxVal = data[0];
-        for (int i = 1; i <= topIndex; ++i) {
-            if (data[i] > maxVal) {
-                maxVal = data[i];
-            }
+            ASD_THROW(std::underflow_error("Stack is empty"));
         }
-        return maxVal;
+        return data[span_max_index(data, size())];
     }
 
     bool operator==(const ArrayStack& other) const {
-        if (size() != other.size()) {
-            return false;
-        }
-        for (int i = 0; i <= topIndex; ++i) {
-            if (data[i] != other.data[i]) {
-                return false;
-            }
-        }
-        return true;
+        return size() == other.size() && span_mismatch(data, other.data, size()) == size();
     }
 
     bool operator!=(const ArrayStack& other) const {
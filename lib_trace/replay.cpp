@@ -0,0 +1,350 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <list>
+#include <stdexcept>
+#include <vector>
+#include "LStack.h"
+#include "list.h"
+#include "queue.h"
+#include "replay.h"
+#include "error_policy.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#define PSAPI_VERSION 2
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+typedef std::string Element;
+typedef std::chrono::steady_clock Clock;
+
+// Adapters return false for an operation they skip.
+
+struct QueueTarget {
+    Queue<Element> c;
+    bool push(const Element& value) { c.push(value); return true; }
+    bool pop() {
+        if (c.empty()) {
+            return false;
+        }
+        c.pop();
+        return true;
+    }
+    bool front(size_t& sink) {
+        if (c.empty()) {
+            return false;
+        }
+        sink += c.front().size();
+        return true;
+    }
+    bool insert(uint32_t, const Element&) { return false; }
+    bool erase(uint32_t) { return false; }
+    bool sort() { return false; }
+};
+
+struct StackTarget {
+    Stack<Element> c;
+    bool push(const Element& value) { c.push(value); return true; }
+    bool pop() {
+        if (c.empty()) {
+            return false;
+        }
+        c.pop();
+        return true;
+    }
+    bool front(size_t& sink) {
+        if (c.empty()) {
+            return false;
+        }
+        sink += c.top().size();
+        return true;
+    }
+    bool insert(uint32_t, const Element&) { return false; }
+    bool erase(uint32_t) { return false; }
+    bool sort() { return false; }
+};
+
+// Positions count from the front, as in a text editor's buffer.
+template<typename Iterator>
+Iterator advanced(Iterator it, size_t position) {
+    for (size_t i = 0; i < position; ++i) {
+        ++it;
+    }
+    return it;
+}
+
+struct ListTarget {
+    List<Element> c;
+    bool push(const Element& value) { c.push_back(value); return true; }
+    bool pop() {
+        if (c.empty()) {
+            return false;
+        }
+        c.pop_front();
+        return true;
+    }
+    bool front(size_t& sink) {
+        if (c.empty()) {
+            return false;
+        }
+        sink += c.front().size();
+        return true;
+    }
+    bool insert(uint32_t position, const Element& value) {
+        c.insert(advanced(c.begin(), position % (c.size() + 1)), value);
+        return true;
+    }
+    bool erase(uint32_t position) {
+        if (c.empty()) {
+            return false;
+        }
+        c.erase(advanced(c.begin(), position % c.size()));
+        return true;
+    }
+    bool sort() { c.sort(); return true; }
+};
+
+struct StdListTarget {
+    std::list<Element> c;
+    bool push(const Element& value) { c.push_back(value); return true; }
+    bool pop() {
+        if (c.empty()) {
+            return false;
+        }
+        c.pop_front();
+        return true;
+    }
+    bool front(size_t& sink) {
+        if (c.empty()) {
+            return false;
+        }
+        sink += c.front().size();
+        return true;
+    }
+    bool insert(uint32_t position, const Element& value) {
+        c.insert(advanced(c.begin(), position % (c.size() + 1)), value);
+        return true;
+    }
+    bool erase(uint32_t position) {
+        if (c.empty()) {
+            return false;
+        }
+        c.erase(advanced(c.begin(), position % c.size()));
+        return true;
+    }
+    bool sort() { c.sort(); return true; }
+};
+
+struct StdDequeTarget {
+    std::deque<Element> c;
+    bool push(const Element& value) { c.push_back(value); return true; }
+    bool pop() {
+        if (c.empty()) {
+            return false;
+        }
+        c.pop_front();
+        return true;
+    }
+    bool front(size_t& sink) {
+        if (c.empty()) {
+            return false;
+        }
+        sink += c.front().size();
+        return true;
+    }
+    bool insert(uint32_t position, const Element& value) {
+        c.insert(c.begin() + position % (c.size() + 1), value);
+        return true;
+    }
+    bool erase(uint32_t position) {
+        if (c.empty()) {
+            return false;
+        }
+        c.erase(c.begin() + position % c.size());
+        return true;
+    }
+    bool sort() { std::sort(c.begin(), c.end()); return true; }
+};
+
+// The stack baseline: push, pop and front work at the back.
+struct StdVectorTarget {
+    std::vector<Element> c;
+    bool push(const Element& value) { c.push_back(value); return true; }
+    bool pop() {
+        if (c.empty()) {
+            return false;
+        }
+        c.pop_back();
+        return true;
+    }
+    bool front(size_t& sink) {
+        if (c.empty()) {
+            return false;
+        }
+        sink += c.back().size();
+        return true;
+    }
+    bool insert(uint32_t position, const Element& value) {
+        c.insert(c.begin() + position % (c.size() + 1), value);
+        return true;
+    }
+    bool erase(uint32_t position) {
+        if (c.empty()) {
+            return false;
+        }
+        c.erase(c.begin() + position % c.size());
+        return true;
+    }
+    bool sort() { std::sort(c.begin(), c.end()); return true; }
+};
+
+template<typename Target>
+bool apply(Target& target, const TraceRecord& record, const Element& value, size_t& sink) {
+    switch (record.op) {
+    case TraceOp::PUSH:
+        return target.push(value);
+    case TraceOp::POP:
+        return target.pop();
+    case TraceOp::FRONT:
+        return target.front(sink);
+    case TraceOp::INSERT:
+        return target.insert(record.position, value);
+    case TraceOp::ERASE:
+        return target.erase(record.position);
+    default:
+        return target.sort();
+    }
+}
+
+template<typename Target>
+ReplayResult replay(const std::vector<TraceRecord>& trace, const std::string& name) {
+    ReplayResult result = {};
+    result.container = name;
+
+    size_t counts[TRACE_OP_COUNT] = {};
+    for (const TraceRecord& record : trace) {
+        ++counts[static_cast<size_t>(record.op)];
+    }
+    std::vector<uint32_t> samples[TRACE_OP_COUNT];
+    for (size_t op = 0; op < TRACE_OP_COUNT; ++op) {
+        samples[op].reserve(counts[op]);
+        result.bufferBytes += counts[op] * sizeof(uint32_t);
+    }
+
+    Element value;
+    size_t sink = 0;   // sizes read by front, so the reads are not optimised away
+    {
+        Target target;
+        Clock::time_point begin = Clock::now();
+        for (size_t i = 0; i < trace.size(); ++i) {
+            const TraceRecord& record = trace[i];
+            // Building the element is not part of the push being timed.
+            if (record.op == TraceOp::PUSH || record.op == TraceOp::INSERT) {
+                value.assign(record.payload, static_cast<char>('a' + i % 26));
+            }
+            Clock::time_point start = Clock::now();
+            bool done = apply(target, record, value, sink);
+            Clock::time_point stop = Clock::now();
+            if (done) {
+                uint64_t ns = static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count());
+                samples[static_cast<size_t>(record.op)].push_back(
+                    static_cast<uint32_t>(std::min<uint64_t>(ns, UINT32_MAX)));
+            }
+            else {
+                ++result.skipped;
+            }
+        }
+        result.seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+        result.peakRssBytes = peak_rss_bytes();
+    }
+
+    std::vector<uint32_t> all;
+    all.reserve(trace.size() - result.skipped);
+    for (size_t op = 0; op < TRACE_OP_COUNT; ++op) {
+        all.insert(all.end(), samples[op].begin(), samples[op].end());
+        result.perOp[op] = summarize_latencies(samples[op]);
+        std::vector<uint32_t>().swap(samples[op]);
+    }
+    result.operations = all.size();
+    result.overall = summarize_latencies(all);
+    return result;
+}
+
+uint64_t nearest_rank(const std::vector<uint32_t>& sorted, double fraction) {
+    size_t rank = static_cast<size_t>(std::ceil(fraction * static_cast<double>(sorted.size())));
+    return sorted[std::max<size_t>(rank, 1) - 1];
+}
+
+}  // namespace
+
+LatencySummary summarize_latencies(std::vector<uint32_t>& samples) {
+    LatencySummary summary = {};
+    summary.count = samples.size();
+    if (samples.empty()) {
+        return summary;
+    }
+    std::sort(samples.begin(), samples.end());
+    summary.p50 = nearest_rank(samples, 0.50);
+    summary.p99 = nearest_rank(samples, 0.99);
+    summary.p999 = nearest_rank(samples, 0.999);
+    summary.max = samples.back();
+    return summary;
+}
+
+const std::vector<std::string>& replay_containers() {
+    static const std::vector<std::string> names = {
+        "queue", "list", "stack", "std-deque", "std-list", "std-vector"
+    };
+    return names;
+}
+
+ReplayResult replay_trace(const std::vector<TraceRecord>& trace, const std::string& container) {
+    if (container == "queue") {
+        return replay<QueueTarget>(trace, container);
+    }
+    if (container == "list") {
+        return replay<ListTarget>(trace, container);
+    }
+    if (container == "stack") {
+        return replay<StackTarget>(trace, container);
+    }
+    if (container == "std-deque") {
+        return replay<StdDequeTarget>(trace, container);
+    }
+    if (container == "std-list") {
+        return replay<StdListTarget>(trace, container);
+    }
+    if (container == "std-vector") {
+        return replay<StdVectorTarget>(trace, container);
+    }
+    ASD_THROW(std::invalid_argument("Unknown container: " + container));
+}
+
+size_t peak_rss_bytes() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.PeakWorkingSetSize;
+    }
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#if defined(__APPLE__)
+    return static_cast<size_t>(usage.ru_maxrss);          // bytes
+#else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;   // kilobytes
+#endif
+#endif
+}
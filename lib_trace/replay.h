@@ -0,0 +1,49 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "trace.h"
+
+// Latencies of one kind of operation, in nanoseconds (nearest rank).
+struct LatencySummary {
+    size_t count;
+    uint64_t p50;
+    uint64_t p99;
+    uint64_t p999;
+    uint64_t max;
+};
+
+// Sorts the samples in place; an empty set gives all zeros.
+LatencySummary summarize_latencies(std::vector<uint32_t>& samples);
+
+struct ReplayResult {
+    std::string container;
+    size_t operations;        // replayed, skipped ones excluded
+    size_t skipped;           // unsupported by the container, or on an empty one
+    double seconds;           // wall time of the whole replay
+    LatencySummary perOp[TRACE_OP_COUNT];
+    LatencySummary overall;
+    size_t bufferBytes;       // latency samples, allocated before the replay starts
+    size_t peakRssBytes;      // process-wide, so includes the trace and bufferBytes
+};
+
+// Names accepted by replay_trace: the library's "queue", "list" and
+// "stack" and the baselines "std-deque", "std-list" and "std-vector".
+const std::vector<std::string>& replay_containers();
+
+// Replays the trace against an empty container of std::string elements,
+// each payload bytes long, timing every operation separately with
+// std::chrono::steady_clock (whose own cost, tens of nanoseconds, is part
+// of every sample). push and pop work at opposite ends for queues and
+// lists and at the top for stacks; front reads the element pop would
+// remove. Queue and stack skip insert, erase and sort. Throws
+// std::invalid_argument for an unknown container.
+ReplayResult replay_trace(const std::vector<TraceRecord>& trace, const std::string& container);
+
+// Peak resident set of this process so far; 0 where unsupported.
+size_t peak_rss_bytes();
+
+#endif
@@ -0,0 +1,326 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include "trace.h"
+#include "error_policy.h"
+
+namespace {
+
+const char MAGIC[8] = { 'A', 'S', 'D', 'T', 'R', 'A', 'C', 'E' };
+const uint32_t TRACE_VERSION = 1;
+
+const char* const OP_NAMES[TRACE_OP_COUNT] = { "push", "pop", "front", "insert", "erase", "sort" };
+
+bool has_position(TraceOp op) {
+    return op == TraceOp::INSERT || op == TraceOp::ERASE;
+}
+
+bool has_payload(TraceOp op) {
+    return op == TraceOp::PUSH || op == TraceOp::INSERT;
+}
+
+void write_varint(std::string& out, uint32_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+uint32_t read_varint(const std::string& in, size_t& offset) {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (offset >= in.size()) {
+            ASD_THROW(std::runtime_error("Truncated trace record at byte " + std::to_string(offset)));
+        }
+        unsigned char byte = static_cast<unsigned char>(in[offset++]);
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            if (value > UINT32_MAX) {
+                break;
+            }
+            return static_cast<uint32_t>(value);
+        }
+    }
+    ASD_THROW(std::runtime_error("Trace value out of range at byte " + std::to_string(offset)));
+}
+
+std::vector<TraceRecord> parse_binary(const std::string& in) {
+    if (in.size() < sizeof(MAGIC) + 4) {
+        ASD_THROW(std::runtime_error("Truncated trace header"));
+    }
+    uint32_t version = 0;
+    for (int i = 3; i >= 0; --i) {
+        version = (version << 8) | static_cast<unsigned char>(in[sizeof(MAGIC) + i]);
+    }
+    if (version != TRACE_VERSION) {
+        ASD_THROW(std::runtime_error("Unsupported trace version " + std::to_string(version)));
+    }
+    std::vector<TraceRecord> trace;
+    size_t offset = sizeof(MAGIC) + 4;
+    while (offset < in.size()) {
+        unsigned char op = static_cast<unsigned char>(in[offset]);
+        if (op >= TRACE_OP_COUNT) {
+            ASD_THROW(std::runtime_error("Unknown trace operation at byte " + std::to_string(offset)));
+        }
+        ++offset;
+        TraceRecord record = { static_cast<TraceOp>(op), 0, 0 };
+        if (has_position(record.op)) {
+            record.position = read_varint(in, offset);
+        }
+        if (has_payload(record.op)) {
+            record.payload = read_varint(in, offset);
+        }
+        trace.push_back(record);
+    }
+    return trace;
+}
+
+std::vector<TraceRecord> parse_text(const std::string& in) {
+    std::vector<TraceRecord> trace;
+    std::istringstream lines(in);
+    std::string line;
+    for (size_t number = 1; std::getline(lines, line); ++number) {
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) {
+            line.erase(comment);
+        }
+        std::istringstream fields(line);
+        std::string name;
+        if (!(fields >> name)) {
+            continue;
+        }
+        const char* const* found = std::find(OP_NAMES, OP_NAMES + TRACE_OP_COUNT, name);
+        if (found == OP_NAMES + TRACE_OP_COUNT) {
+            ASD_THROW(std::runtime_error("Unknown trace operation '" + name + "' on line " + std::to_string(number)));
+        }
+        TraceRecord record = { static_cast<TraceOp>(found - OP_NAMES), 0, 0 };
+        bool ok = true;
+        if (has_position(record.op)) {
+            ok = ok && static_cast<bool>(fields >> record.position);
+        }
+        if (has_payload(record.op)) {
+            ok = ok && static_cast<bool>(fields >> record.payload);
+        }
+        std::string rest;
+        if (!ok || fields >> rest) {
+            ASD_THROW(std::runtime_error("Malformed '" + name + "' on line " + std::to_string(number)));
+        }
+        trace.push_back(record);
+    }
+    return trace;
+}
+
+void write_file(const std::string& path, const std::string& contents) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+    out.close();
+    if (!out) {
+        ASD_THROW(std::runtime_error("Cannot write trace: " + path));
+    }
+}
+
+// splitmix64: tiny, and unlike the <random> distributions it gives the
+// same sequence with every standard library.
+class Random {
+private:
+    uint64_t state;
+
+public:
+    explicit Random(uint64_t seed) : state(seed) {}
+
+    uint64_t next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    uint32_t below(uint64_t bound) {
+        return static_cast<uint32_t>(next() % bound);
+    }
+
+    double unit() {
+        return static_cast<double>(next() >> 11) / 9007199254740992.0;
+    }
+};
+
+class TraceBuilder {
+private:
+    const TraceProfile& profile;
+    Random random;
+    std::vector<TraceRecord> trace;
+    size_t size;
+
+    uint32_t payload() {
+        uint64_t mean = profile.meanPayload;
+        switch (profile.payload) {
+        case PayloadDistribution::UNIFORM:
+            return 1 + random.below(2 * mean);
+        case PayloadDistribution::EXPONENTIAL: {
+            double value = std::ceil(-std::log(1.0 - random.unit()) * static_cast<double>(mean));
+            return static_cast<uint32_t>(std::min(std::max(value, 1.0), 64.0 * static_cast<double>(mean)));
+        }
+        default:
+            return profile.meanPayload;
+        }
+    }
+
+public:
+    TraceBuilder(const TraceProfile& profile) : profile(profile), random(profile.seed), size(0) {
+        trace.reserve(profile.operations);
+    }
+
+    bool full() const { return trace.size() >= profile.operations; }
+    size_t containerSize() const { return size; }
+    uint32_t below(uint64_t bound) { return random.below(bound); }
+
+    // Ops that need elements turn into pushes on an empty container.
+    void add(TraceOp op, uint32_t position = 0) {
+        if (size == 0 && op != TraceOp::PUSH && op != TraceOp::INSERT) {
+            op = TraceOp::PUSH;
+        }
+        TraceRecord record = { op, 0, 0 };
+        if (has_position(op)) {
+            record.position = position;
+        }
+        if (has_payload(op)) {
+            record.payload = payload();
+            ++size;
+        }
+        if (op == TraceOp::POP || op == TraceOp::ERASE) {
+            --size;
+        }
+        trace.push_back(record);
+    }
+
+    std::vector<TraceRecord> take() { return std::move(trace); }
+};
+
+void generate_steady(TraceBuilder& builder, size_t operations) {
+    size_t backlog = std::max<size_t>(1, std::min<size_t>(4096, operations / 8));
+    while (!builder.full() && builder.containerSize() < backlog) {
+        builder.add(TraceOp::PUSH);
+    }
+    while (!builder.full()) {
+        uint32_t roll = builder.below(10);
+        builder.add(roll < 4 ? TraceOp::PUSH : roll < 8 ? TraceOp::POP : TraceOp::FRONT);
+    }
+}
+
+void generate_burst(TraceBuilder& builder, size_t operations) {
+    size_t longest = std::max<size_t>(1, std::min<size_t>(1 << 16, operations / 4));
+    while (!builder.full()) {
+        size_t burst = 1 + builder.below(longest);
+        for (size_t i = 0; i < burst && !builder.full(); ++i) {
+            builder.add(TraceOp::PUSH);
+        }
+        size_t floor = burst / 16;
+        while (!builder.full() && builder.containerSize() > floor) {
+            builder.add(builder.below(5) == 0 ? TraceOp::FRONT : TraceOp::POP);
+        }
+    }
+}
+
+void generate_random_edit(TraceBuilder& builder, size_t operations) {
+    size_t backlog = std::max<size_t>(1, std::min<size_t>(1024, operations / 8));
+    while (!builder.full() && builder.containerSize() < backlog) {
+        builder.add(TraceOp::PUSH);
+    }
+    while (!builder.full()) {
+        uint32_t roll = builder.below(10000);
+        size_t size = builder.containerSize();
+        if (roll < 2500) {
+            builder.add(TraceOp::INSERT, builder.below(size + 1));
+        }
+        else if (roll < 5000) {
+            builder.add(TraceOp::ERASE, size == 0 ? 0 : builder.below(size));
+        }
+        else if (roll < 6500) {
+            builder.add(TraceOp::PUSH);
+        }
+        else if (roll < 8000) {
+            builder.add(TraceOp::POP);
+        }
+        else if (roll < 9999) {
+            builder.add(TraceOp::FRONT);
+        }
+        else {
+            builder.add(TraceOp::SORT);
+        }
+    }
+}
+
+}  // namespace
+
+const char* trace_op_name(TraceOp op) {
+    return OP_NAMES[static_cast<size_t>(op)];
+}
+
+std::vector<TraceRecord> read_trace(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        ASD_THROW(std::runtime_error("Cannot open trace: " + path));
+    }
+    std::string contents((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (contents.size() >= sizeof(MAGIC) && std::memcmp(contents.data(), MAGIC, sizeof(MAGIC)) == 0) {
+        return parse_binary(contents);
+    }
+    return parse_text(contents);
+}
+
+void write_trace_text(const std::string& path, const std::vector<TraceRecord>& trace) {
+    std::string out;
+    for (const TraceRecord& record : trace) {
+        out += trace_op_name(record.op);
+        if (has_position(record.op)) {
+            out += ' ' + std::to_string(record.position);
+        }
+        if (has_payload(record.op)) {
+            out += ' ' + std::to_string(record.payload);
+        }
+        out += '\n';
+    }
+    write_file(path, out);
+}
+
+void write_trace_binary(const std::string& path, const std::vector<TraceRecord>& trace) {
+    std::string out(MAGIC, sizeof(MAGIC));
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<char>((TRACE_VERSION >> (8 * i)) & 0xFF));
+    }
+    for (const TraceRecord& record : trace) {
+        out.push_back(static_cast<char>(record.op));
+        if (has_position(record.op)) {
+            write_varint(out, record.position);
+        }
+        if (has_payload(record.op)) {
+            write_varint(out, record.payload);
+        }
+    }
+    write_file(path, out);
+}
+
+std::vector<TraceRecord> generate_trace(const TraceProfile& profile) {
+    if (profile.meanPayload == 0) {
+        ASD_THROW(std::invalid_argument("Mean payload must be positive"));
+    }
+    TraceBuilder builder(profile);
+    switch (profile.pattern) {
+    case TracePattern::BURST:
+        generate_burst(builder, profile.operations);
+        break;
+    case TracePattern::RANDOM_EDIT:
+        generate_random_edit(builder, profile.operations);
+        break;
+    default:
+        generate_steady(builder, profile.operations);
+        break;
+    }
+    return builder.take();
+}
@@ -0,0 +1,75 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Operation traces for replaying access patterns against the containers.
+//
+// Text format, one operation per line ('#' starts a comment):
+//     push <payload>
+//     pop
+//     front
+//     insert <position> <payload>
+//     erase <position>
+//     sort
+// Binary format: the 8-byte magic "ASDTRACE", a little-endian uint32
+// version, then per operation one op byte followed by LEB128 varints for
+// its position and payload (in that order, only for the ops that have
+// them). A typical push takes 2 bytes.
+//
+// Payloads are element sizes in bytes. Positions are taken modulo the
+// container size at replay time, so a trace stays valid on containers
+// that skip some of its operations.
+enum class TraceOp : uint8_t {
+    PUSH,
+    POP,
+    FRONT,
+    INSERT,
+    ERASE,
+    SORT
+};
+
+const size_t TRACE_OP_COUNT = 6;
+
+struct TraceRecord {
+    TraceOp op;
+    uint32_t position;
+    uint32_t payload;
+};
+
+const char* trace_op_name(TraceOp op);
+
+// Throw std::runtime_error if the file cannot be opened or is malformed;
+// text errors name the offending line.
+std::vector<TraceRecord> read_trace(const std::string& path);   // either format
+void write_trace_text(const std::string& path, const std::vector<TraceRecord>& trace);
+void write_trace_binary(const std::string& path, const std::vector<TraceRecord>& trace);
+
+enum class TracePattern {
+    STEADY,        // standing backlog, pushes and pops balanced, some fronts
+    BURST,         // bursts of pushes drained back to near empty
+    RANDOM_EDIT    // inserts and erases at uniform positions, rare sorts
+};
+
+enum class PayloadDistribution {
+    FIXED,         // always meanPayload
+    UNIFORM,       // 1 .. 2 * meanPayload
+    EXPONENTIAL    // mostly small, long tail, capped at 64 * meanPayload
+};
+
+struct TraceProfile {
+    TracePattern pattern;
+    PayloadDistribution payload;
+    size_t operations;
+    uint32_t meanPayload;
+    uint64_t seed;
+};
+
+// The same profile gives the same trace on every platform. Pops, fronts,
+// erases and sorts are only generated on a non-empty container.
+std::vector<TraceRecord> generate_trace(const TraceProfile& profile);
+
+#endif
@@ -1,37 +1,182 @@
 // Copyright 2024 Marina Usova
 
-#define EASY_EXAMPLE
-#ifdef EASY_EXAMPLE
+// Replays operation traces (see lib_trace/trace.h) against the containers.
+//
+//   Application generate <steady|burst|edit> <operations> <file>
+//                        [--payload fixed|uniform|exponential] [--mean <bytes>]
+//                        [--seed <n>] [--text]
+//   Application replay <file> <container>
+//
+// Peak RSS is a per-process high-water mark, so replay one container per run.
 
-#include <iostream>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
 #include <iomanip>
-#include "../lib_easy_example/easy_example.h"
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "error_policy.h"
+#include "replay.h"
+#include "trace.h"
+
+namespace {
+
+void print_usage(std::ostream& out) {
+    out << "usage:\n"
+        << "  Application generate <steady|burst|edit> <operations> <file>\n"
+        << "                       [--payload fixed|uniform|exponential] [--mean <bytes>]\n"
+        << "                       [--seed <n>] [--text]\n"
+        << "  Application replay <file> <container>\n"
+        << "containers:";
+    for (const std::string& name : replay_containers()) {
+        out << ' ' << name;
+    }
+    out << '\n';
+}
+
+uint64_t parse_number(const std::string& text) {
+    char* end = nullptr;
+    errno = 0;
+    unsigned long long value = std::strtoull(text.c_str(), &end, 10);
+    if (text.empty() || !std::isdigit(static_cast<unsigned char>(text[0])) || errno == ERANGE ||
+        end != text.c_str() + text.size()) {
+        ASD_THROW(std::invalid_argument("Not a number: " + text));
+    }
+    return value;
+}
+
+TracePattern parse_pattern(const std::string& name) {
+    if (name == "steady") return TracePattern::STEADY;
+    if (name == "burst") return TracePattern::BURST;
+    if (name == "edit") return TracePattern::RANDOM_EDIT;
+    ASD_THROW(std::invalid_argument("Unknown pattern: " + name));
+}
+
+PayloadDistribution parse_distribution(const std::string& name) {
+    if (name == "fixed") return PayloadDistribution::FIXED;
+    if (name == "uniform") return PayloadDistribution::UNIFORM;
+    if (name == "exponential") return PayloadDistribution::EXPONENTIAL;
+    ASD_THROW(std::invalid_argument("Unknown payload distribution: " + name));
+}
 
-int main() {
-  int a, b;
-  float result;
+int generate(const std::vector<std::string>& args) {
+    if (args.size() < 3) {
+        ASD_THROW(std::invalid_argument("generate needs a pattern, an operation count and a file"));
+    }
+    TraceProfile profile;
+    profile.pattern = parse_pattern(args[0]);
+    profile.payload = PayloadDistribution::FIXED;
+    profile.operations = static_cast<size_t>(parse_number(args[1]));
+    profile.meanPayload = 32;
+    profile.seed = 1;
+    bool text = false;
+    for (size_t i = 3; i < args.size(); ++i) {
+        bool hasValue = i + 1 < args.size();
+        if (args[i] == "--text") {
+            text = true;
+        }
+        else if (args[i] == "--payload" && hasValue) {
+            profile.payload = parse_distribution(args[++i]);
+        }
+        else if (args[i] == "--mean" && hasValue) {
+            profile.meanPayload = static_cast<uint32_t>(parse_number(args[++i]));
+        }
+        else if (args[i] == "--seed" && hasValue) {
+            profile.seed = parse_number(args[++i]);
+        }
+        else {
+            ASD_THROW(std::invalid_argument("Unexpected argument: " + args[i]));
+        }
+    }
 
-  a = 1; b = 4;
+    std::vector<TraceRecord> trace = generate_trace(profile);
+    if (text) {
+        write_trace_text(args[2], trace);
+    }
+    else {
+        write_trace_binary(args[2], trace);
+    }
+    std::cout << "wrote " << trace.size() << " operations to " << args[2] << std::endl;
+    return 0;
+}
 
-  try {
-      result = division(a, b);
-      std::cout << a << " / " << b << " = "
-          << std::setprecision(2) << result << std::endl;
-  } catch (std::exception err) {
-      std::cerr << err.what() << std::endl;
-  }
+void print_latency(const char* name, const LatencySummary& latency) {
+    std::cout << std::left << std::setw(8) << name << std::right
+              << std::setw(12) << latency.count
+              << std::setw(10) << latency.p50
+              << std::setw(10) << latency.p99
+              << std::setw(10) << latency.p999
+              << std::setw(14) << latency.max << '\n';
+}
 
-  a = 1; b = 0;
+int replay(const std::vector<std::string>& args) {
+    if (args.size() != 2) {
+        ASD_THROW(std::invalid_argument("replay needs a trace file and a container"));
+    }
+    std::vector<TraceRecord> trace = read_trace(args[0]);
+    ReplayResult result = replay_trace(trace, args[1]);
 
-  try {
-      result = division(a, b);
-      std::cout << a << " / " << b << " = "
-          << std::setprecision(2) << result << std::endl;
-  } catch (std::exception err) {
-      std::cerr << err.what() << std::endl;
-  }
+    const double MIB = 1024.0 * 1024.0;
+    std::cout << std::fixed << std::setprecision(2)
+              << "container   " << result.container << '\n'
+              << "operations  " << result.operations << " (" << result.skipped << " skipped)\n"
+              << "time        " << result.seconds * 1000.0 << " ms\n"
+              << "throughput  " << std::setprecision(0)
+              << (result.seconds > 0 ? result.operations / result.seconds : 0.0) << " ops/s\n"
+              << std::setprecision(2)
+              << "peak RSS    " << result.peakRssBytes / MIB << " MiB (trace "
+              << trace.capacity() * sizeof(TraceRecord) / MIB << " MiB, latency samples "
+              << result.bufferBytes / MIB << " MiB)\n\n";
+    std::cout << std::left << std::setw(8) << "op" << std::right
+              << std::setw(12) << "count"
+              << std::setw(10) << "p50 ns"
+              << std::setw(10) << "p99 ns"
+              << std::setw(10) << "p99.9 ns"
+              << std::setw(14) << "max ns" << '\n';
+    for (size_t op = 0; op < TRACE_OP_COUNT; ++op) {
+        if (result.perOp[op].count != 0) {
+            print_latency(trace_op_name(static_cast<TraceOp>(op)), result.perOp[op]);
+        }
+    }
+    print_latency("all", result.overall);
+    return 0;
+}
 
-  return 0;
+int run(const std::string& command, const std::vector<std::string>& args) {
+    if (command == "generate") {
+        return generate(args);
+    }
+    if (command == "replay") {
+        return replay(args);
+    }
+    print_usage(std::cerr);
+    return 1;
 }
 
-#endif  // EASY_EXAMPLE
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        print_usage(std::cerr);
+        return 1;
+    }
+    std::string command = argv[1];
+    std::vector<std::string> args(argv + 2, argv + argc);
+#if ASD_EXCEPTIONS
+    try {
+        return run(command, args);
+    }
+    catch (const std::exception& err) {
+        std::cerr << err.what() << std::endl;
+        if (dynamic_cast<const std::invalid_argument*>(&err) != nullptr) {
+            print_usage(std::cerr);
+        }
+        return 1;
+    }
+#else
+    // Without exceptions a bad argument aborts with its message instead.
+    return run(command, args);
+#endif
+}
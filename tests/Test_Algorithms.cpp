@@ -0,0 +1,474 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "algorithms.h"
+#include "expect_error.h"
+
+TEST(CheckBracketsTest, EmptyString) {
+    EXPECT_TRUE(check_brackets(""));
+}
+
+TEST(CheckBracketsTest, Balanced) {
+    EXPECT_TRUE(check_brackets("()"));
+    EXPECT_TRUE(check_brackets("([]{})"));
+    EXPECT_TRUE(check_brackets("{a: [1, (2 + 3)], b: {}}"));
+}
+
+TEST(CheckBracketsTest, Unbalanced) {
+    EXPECT_FALSE(check_brackets("("));
+    EXPECT_FALSE(check_brackets(")"));
+    EXPECT_FALSE(check_brackets("(]"));
+    EXPECT_FALSE(check_brackets("([)]"));
+    EXPECT_FALSE(check_brackets("{}}"));
+}
+
+TEST(CheckBracketsTest, DeepNesting) {
+    const size_t DEPTH = 1000000;
+    std::string expression = std::string(DEPTH, '[') + std::string(DEPTH, ']');
+    EXPECT_TRUE(check_brackets(expression));
+
+    expression[DEPTH] = ')';
+    EXPECT_FALSE(check_brackets(expression));
+}
+
+TEST(CheckBracketsTest, MixedDeepNesting) {
+    std::string open, close;
+    for (int i = 0; i < 5000; ++i) {
+        const char* pair = (i % 3 == 0) ? "()" : (i % 3 == 1) ? "[]" : "{}";
+        open += pair[0];
+        close = pair[1] + close;
+    }
+    EXPECT_TRUE(check_brackets(open + close));
+    EXPECT_FALSE(check_brackets(open + close.substr(1)));
+}
+
+TEST(CheckBracketsTest, ScannersAgreeOnRandomInput) {
+    const BracketScanner scanners[] = {
+        BracketScanner::SCALAR, BracketScanner::SSE2,
+        BracketScanner::AVX2, BracketScanner::AVX512
+    };
+    const char alphabet[] = "()[]{}ab )(";
+    unsigned state = 12345;
+
+    for (int round = 0; round < 200; ++round) {
+        std::string text;
+        size_t length = round * 3;
+        for (size_t i = 0; i < length; ++i) {
+            state = state * 1103515245u + 12345u;
+            text += alphabet[(state >> 16) % (sizeof(alphabet) - 1)];
+        }
+        bool expected = check_brackets(text.data(), text.size(), BracketScanner::SCALAR);
+        for (BracketScanner scanner : scanners) {
+            if (bracket_scanner_supported(scanner)) {
+                EXPECT_EQ(check_brackets(text.data(), text.size(), scanner), expected);
+            }
+        }
+    }
+}
+
+TEST(CheckBracketsTest, BracketsAcrossBlockBoundaries) {
+    std::string text(200, 'x');
+    text[63] = '(';
+    text[64] = '[';
+    text[127] = ']';
+    text[128] = ')';
+    text[199] = '{';
+    EXPECT_FALSE(check_brackets(text));
+    text[199] = ' ';
+    EXPECT_TRUE(check_brackets(text));
+}
+
+TEST(CheckBracketsTest, HighBytesAreNotBrackets) {
+    std::string text(128, static_cast<char>(0xFB));
+    text += std::string(64, static_cast<char>(0xA9));
+    EXPECT_TRUE(check_brackets(text));
+}
+
+#if defined(ASD_CONSTEXPR_ARRAY_STACK)
+
+namespace {
+
+const char* const NOT_A_LITERAL = "([)]";
+
+}  // namespace
+
+TEST(CheckBracketsTest, LiteralsAreCheckedAtCompileTime) {
+    static_assert(check_brackets_constexpr(""), "empty");
+    static_assert(check_brackets_constexpr("{a: [1, (2 + 3)], b: {}}"), "balanced");
+    static_assert(!check_brackets_constexpr("([)]"), "crossed");
+    static_assert(!check_brackets_constexpr("(("), "unclosed");
+    static_assert(check_brackets_constexpr<2>("(x)[y]{z}", 9), "depth 1 fits");
+#if defined(ASD_HAS_STRING_VIEW)
+    static_assert(!check_brackets_constexpr<8>(std::string_view("{}}")), "extra closer");
+#endif
+    // Run time gives the same answers as the scanner overloads.
+    EXPECT_FALSE(check_brackets_constexpr<4>(NOT_A_LITERAL, std::strlen(NOT_A_LITERAL)));
+    char buffer[16] = "[()]";
+    EXPECT_TRUE(check_brackets_constexpr(buffer));   // stops at the terminator
+}
+
+#endif
+
+TEST(CheckBracketsTest, NestingBeyondMaxDepthThrows) {
+    EXPECT_THROW(check_brackets_constexpr<2>("(((", 3), std::length_error);
+    EXPECT_TRUE(check_brackets_constexpr<3>("((()))", 6));
+}
+
+TEST(CheckBracketsTest, AutoScannerIsAlwaysSupported) {
+    EXPECT_TRUE(bracket_scanner_supported(BracketScanner::AUTO));
+    EXPECT_TRUE(bracket_scanner_supported(BracketScanner::SCALAR));
+    EXPECT_NE(bracket_mask_function(BracketScanner::AUTO), nullptr);
+}
+
+TEST(BracketValidatorTest, ReportsErrorOffset) {
+    BracketValidator validator;
+    EXPECT_FALSE(validator.feed("(a[b)c]", 7));
+    EXPECT_TRUE(validator.hasError());
+    EXPECT_EQ(validator.errorPosition(), 4);
+    EXPECT_FALSE(validator.finish());
+}
+
+TEST(BracketValidatorTest, UnclosedOpenersFailAtEnd) {
+    BracketValidator validator;
+    EXPECT_TRUE(validator.feed("{[(", 3));
+    EXPECT_EQ(validator.depth(), 3);
+    EXPECT_FALSE(validator.finish());
+
+    BracketCheckResult result = validator.result();
+    EXPECT_FALSE(result.balanced);
+    EXPECT_EQ(result.error_offset, 3);
+}
+
+TEST(BracketValidatorTest, StackSurvivesChunks) {
+    std::string text;
+    for (int i = 0; i < 300; ++i) {
+        text += "{\"key\": [1, (2)]}, ";
+    }
+    text = "[" + text + "]";
+
+    for (size_t chunk : { 1, 7, 64, 100, 1000 }) {
+        BracketValidator validator;
+        for (size_t offset = 0; offset < text.size(); offset += chunk) {
+            size_t length = std::min(chunk, text.size() - offset);
+            EXPECT_TRUE(validator.feed(text.data() + offset, length));
+        }
+        EXPECT_TRUE(validator.finish());
+        EXPECT_EQ(validator.bytesConsumed(), text.size());
+    }
+}
+
+TEST(BracketValidatorTest, ErrorOffsetIsAbsoluteAcrossChunks) {
+    std::string text = std::string(150, '(') + "]";
+    BracketValidator validator;
+    EXPECT_TRUE(validator.feed(text.data(), 100));
+    EXPECT_FALSE(validator.feed(text.data() + 100, text.size() - 100));
+    EXPECT_EQ(validator.errorPosition(), 150);
+    EXPECT_FALSE(validator.feed("()", 2));
+}
+
+TEST(BracketValidatorTest, Reset) {
+    BracketValidator validator;
+    validator.feed(")", 1);
+    EXPECT_TRUE(validator.hasError());
+    validator.reset();
+    EXPECT_FALSE(validator.hasError());
+    EXPECT_TRUE(validator.feed("()", 2));
+    EXPECT_TRUE(validator.finish());
+}
+
+TEST(CheckBracketsFileTest, ValidatesThroughSmallWindows) {
+    const char* path = "check_brackets_file_test.tmp";
+    std::string text;
+    for (int i = 0; i < 20000; ++i) {
+        text += "(a[b]{c})";
+    }
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << text << ")";
+    }
+
+    BracketCheckResult result = check_brackets_file(path, 1);
+    EXPECT_FALSE(result.balanced);
+    EXPECT_EQ(result.error_offset, text.size());
+
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << text;
+    }
+    EXPECT_TRUE(check_brackets_file(path, 1).balanced);
+    EXPECT_TRUE(check_brackets_file(path).balanced);
+
+    std::remove(path);
+}
+
+TEST(CheckBracketsFileTest, EmptyFileIsBalanced) {
+    const char* path = "check_brackets_file_empty.tmp";
+    { std::ofstream out(path, std::ios::binary); }
+    EXPECT_TRUE(check_brackets_file(path).balanced);
+    std::remove(path);
+}
+
+TEST(CheckBracketsFileTest, MissingFileThrows) {
+    EXPECT_THROW(check_brackets_file("no/such/file.txt"), std::runtime_error);
+}
+
+namespace {
+
+std::string random_brackets(size_t length, unsigned seed, const char* alphabet) {
+    std::string text;
+    size_t size = std::strlen(alphabet);
+    for (size_t i = 0; i < length; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        text += alphabet[(seed >> 16) % size];
+    }
+    return text;
+}
+
+BracketCheckResult sequential_result(const std::string& text) {
+    BracketValidator validator;
+    validator.feed(text.data(), text.size());
+    validator.finish();
+    return validator.result();
+}
+
+BracketCheckResult summary_result(const std::string& text, size_t chunk) {
+    BracketSummary total;
+    for (size_t begin = 0; begin < text.size(); begin += chunk) {
+        size_t length = std::min(chunk, text.size() - begin);
+        combine_brackets(total, summarize_brackets(text.data() + begin, length, begin));
+    }
+    return finish_brackets(total, text.size());
+}
+
+}  // namespace
+
+TEST(ParallelBracketsTest, SummariesMatchSequentialErrors) {
+    for (unsigned seed = 1; seed < 300; ++seed) {
+        std::string text = random_brackets(seed % 50 * 4, seed, "(([[{{}])]x");
+        BracketCheckResult expected = sequential_result(text);
+        for (size_t chunk : { 1, 3, 8, 64 }) {
+            BracketCheckResult actual = summary_result(text, chunk);
+            ASSERT_EQ(actual.balanced, expected.balanced) << text;
+            if (!expected.balanced) {
+                ASSERT_EQ(actual.error_offset, expected.error_offset) << text;
+            }
+        }
+    }
+}
+
+TEST(ParallelBracketsTest, BalancedAcrossChunks) {
+    std::string text = std::string(100, '{') + "[()]" + std::string(100, '}');
+    BracketCheckResult result = summary_result(text, 7);
+    EXPECT_TRUE(result.balanced);
+}
+
+TEST(ParallelBracketsTest, ParallelMatchesSequentialOnLargeInput) {
+    std::string block;
+    for (int i = 0; i < 1000; ++i) {
+        block += "{\"a\": [1, (2)]}, ";
+    }
+    std::string text = "[";
+    while (text.size() < (size_t(5) << 20)) {
+        text += block;
+    }
+    text += "]";
+
+    EXPECT_TRUE(check_brackets_parallel(text.data(), text.size(), 4).balanced);
+
+    size_t broken = text.size() / 2;
+    while (text[broken] != ']') {
+        ++broken;
+    }
+    text[broken] = ')';
+    BracketCheckResult result = check_brackets_parallel(text.data(), text.size(), 4);
+    EXPECT_FALSE(result.balanced);
+    EXPECT_EQ(result.error_offset, broken);
+    EXPECT_EQ(result.error_offset, sequential_result(text).error_offset);
+}
+
+TEST(ParallelBracketsTest, UnmatchedCloserInLaterChunk) {
+    std::string text(size_t(3) << 20, 'x');
+    text[(size_t(5) << 19)] = '}';
+    BracketCheckResult result = check_brackets_parallel(text.data(), text.size(), 3);
+    EXPECT_FALSE(result.balanced);
+    EXPECT_EQ(result.error_offset, size_t(5) << 19);
+}
+
+TEST(CheckBracketsBatchTest, MatchesPerInputResults) {
+    std::vector<std::string> inputs = {
+        "", "()", "(]", "((", "x + (y * [z])", ")", "{[()]}", "", "[[[", "a}",
+        std::string(150, '(') + std::string(150, ')'),
+        std::string(100, '[') + "x)" + std::string(100, ']'),
+    };
+    std::string buffer;
+    std::vector<size_t> offsets = { 0 };
+    for (const std::string& input : inputs) {
+        buffer += input;
+        offsets.push_back(buffer.size());
+    }
+
+    std::vector<BracketCheckResult> results(inputs.size());
+    check_brackets_batch(buffer.data(), offsets.data(), inputs.size(), results.data());
+
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        BracketCheckResult expected = sequential_result(inputs[i]);
+        EXPECT_EQ(results[i].balanced, expected.balanced) << i;
+        EXPECT_EQ(results[i].error_offset, expected.error_offset) << i;
+    }
+}
+
+TEST(CheckBracketsBatchTest, ThreadedBatch) {
+    std::string buffer;
+    std::vector<size_t> offsets = { 0 };
+    std::vector<BracketCheckResult> expected;
+    for (unsigned i = 0; i < 20000; ++i) {
+        std::string input = random_brackets(i % 23, i, "(([[{{}])]x");
+        buffer += input;
+        offsets.push_back(buffer.size());
+        expected.push_back(sequential_result(input));
+    }
+
+    std::vector<BracketCheckResult> results(expected.size());
+    check_brackets_batch(buffer.data(), offsets.data(), expected.size(), results.data(), 4);
+
+    for (size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_EQ(results[i].balanced, expected[i].balanced) << i;
+        ASSERT_EQ(results[i].error_offset, expected[i].error_offset) << i;
+    }
+}
+
+namespace {
+
+// Position-by-position reference for BracketIndex, with an explicit stack.
+struct NaiveBracketIndex {
+    std::vector<size_t> match, depth, open, close;
+
+    explicit NaiveBracketIndex(const std::string& text)
+        : match(text.size(), BracketIndex::NPOS), depth(text.size(), 0),
+        open(text.size(), BracketIndex::NPOS), close(text.size(), BracketIndex::NPOS) {
+        std::vector<size_t> stack;
+        std::vector<size_t> scopeOf(text.size(), BracketIndex::NPOS);
+        for (size_t i = 0; i < text.size(); ++i) {
+            char c = text[i];
+            scopeOf[i] = stack.empty() ? BracketIndex::NPOS : stack.back();
+            depth[i] = stack.size();
+            if (c == '(' || c == '[' || c == '{') {
+                stack.push_back(i);
+            }
+            else if ((c == ')' || c == ']' || c == '}') && !stack.empty()
+                     && std::string("([{").find(text[stack.back()]) == std::string(")]}").find(c)) {
+                match[i] = stack.back();
+                match[stack.back()] = i;
+                stack.pop_back();
+                scopeOf[i] = scopeOf[match[i]];
+                depth[i] = depth[match[i]];
+            }
+        }
+        for (size_t i = 0; i < text.size(); ++i) {
+            size_t scope = scopeOf[i];
+            if (scope != BracketIndex::NPOS) {
+                open[i] = scope;
+                close[i] = match[scope];
+            }
+        }
+    }
+};
+
+void expect_index_matches(const BracketIndex& index, const std::string& text) {
+    NaiveBracketIndex naive(text);
+    ASSERT_EQ(index.length(), text.size());
+    for (size_t i = 0; i < text.size(); ++i) {
+        ASSERT_EQ(index.match(i), naive.match[i]) << text << " @" << i;
+        ASSERT_EQ(index.depth(i), naive.depth[i]) << text << " @" << i;
+        ASSERT_EQ(index.enclosing(i).open, naive.open[i]) << text << " @" << i;
+        ASSERT_EQ(index.enclosing(i).close, naive.close[i]) << text << " @" << i;
+    }
+}
+
+}  // namespace
+
+TEST(BracketIndexTest, MatchesAndDepths) {
+    std::string text = "f(a[i], {b: (c)})";
+    BracketIndex index(text.data(), text.size());
+
+    EXPECT_TRUE(index.balanced());
+    EXPECT_EQ(index.bracketCount(), 8);
+    EXPECT_EQ(index.match(1), 16);
+    EXPECT_EQ(index.match(16), 1);
+    EXPECT_EQ(index.match(3), 5);
+    EXPECT_EQ(index.match(0), BracketIndex::NPOS);
+    EXPECT_EQ(index.depth(0), 0);
+    EXPECT_EQ(index.depth(13), 3);
+    EXPECT_EQ(index.depth(12), 2);
+    EXPECT_EQ(index.enclosing(13).open, 12);
+    EXPECT_EQ(index.enclosing(12).open, 8);
+    EXPECT_EQ(index.enclosing(8).close, 16);
+    EXPECT_EQ(index.enclosing(0).open, BracketIndex::NPOS);
+    EXPECT_THROW(index.match(text.size()), std::out_of_range);
+}
+
+TEST(BracketIndexTest, UnmatchedBrackets) {
+    std::string text = "(]x[";
+    BracketIndex index(text.data(), text.size());
+
+    EXPECT_FALSE(index.balanced());
+    EXPECT_EQ(index.match(0), BracketIndex::NPOS);
+    EXPECT_EQ(index.match(1), BracketIndex::NPOS);
+    EXPECT_EQ(index.enclosing(2).open, 0);
+    EXPECT_EQ(index.enclosing(2).close, BracketIndex::NPOS);
+    expect_index_matches(index, text);
+}
+
+TEST(BracketIndexTest, AgreesWithNaiveOnRandomText) {
+    for (unsigned seed = 1; seed < 200; ++seed) {
+        std::string text = random_brackets(seed % 40 * 5, seed, "(([[{{}])]}xy");
+        BracketIndex index(text.data(), text.size());
+        expect_index_matches(index, text);
+    }
+}
+
+TEST(BracketIndexTest, IncrementalUpdateInsideSubtree) {
+    std::string text = "a{b[c(d)e]f(g)h}i";
+    BracketIndex index(text.data(), text.size());
+
+    // Replace "c(d)e" with "(x[y])" inside the [...] pair.
+    std::string edited = text.substr(0, 4) + "(x[y])" + text.substr(9);
+    EXPECT_TRUE(index.update(edited.data(), edited.size(), 4, 5, 6));
+    expect_index_matches(index, edited);
+    EXPECT_TRUE(index.balanced());
+}
+
+TEST(BracketIndexTest, UpdateFallsBackWhenNestingChanges) {
+    std::string text = "{a(b)c}";
+    BracketIndex index(text.data(), text.size());
+
+    std::string edited = "{a(b}c}";
+    EXPECT_FALSE(index.update(edited.data(), edited.size(), 4, 1, 1));
+    expect_index_matches(index, edited);
+
+    std::string outside = edited + "(";
+    EXPECT_FALSE(index.update(outside.data(), outside.size(), edited.size(), 0, 1));
+    expect_index_matches(index, outside);
+}
+
+TEST(BracketIndexTest, RandomEditsMatchFullRebuild) {
+    unsigned seed = 99;
+    std::string text = "{" + random_brackets(300, 7, "()[]xy") + "}";
+    BracketIndex index(text.data(), text.size());
+
+    for (int round = 0; round < 200; ++round) {
+        seed = seed * 1103515245u + 12345u;
+        size_t begin = 1 + (seed >> 8) % (text.size() - 1);
+        size_t removed = std::min<size_t>((seed >> 20) % 4, text.size() - 1 - begin);
+        std::string inserted = random_brackets((seed >> 4) % 5, seed, "()[]{}ab");
+
+        text = text.substr(0, begin) + inserted + text.substr(begin + removed);
+        index.update(text.data(), text.size(), begin, removed, inserted.size());
+        expect_index_matches(index, text);
+    }
+}
@@ -0,0 +1,310 @@
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include "LStack.h"
+#include "list.h"
+#include "queue.h"
+
+namespace {
+
+// Bytes handed out by one CountingAllocator family.
+struct Arena {
+    size_t live;
+    size_t allocations;
+};
+
+// Stateful allocator: copies share an arena and compare equal only when
+// they do. PROPAGATE sets all three propagation traits.
+template<typename T, bool PROPAGATE>
+struct CountingAllocator {
+    typedef T value_type;
+    typedef std::integral_constant<bool, PROPAGATE> propagate_on_container_copy_assignment;
+    typedef std::integral_constant<bool, PROPAGATE> propagate_on_container_move_assignment;
+    typedef std::integral_constant<bool, PROPAGATE> propagate_on_container_swap;
+    typedef std::false_type is_always_equal;
+
+    template<typename U>
+    struct rebind {
+        typedef CountingAllocator<U, PROPAGATE> other;
+    };
+
+    Arena* arena;
+
+    explicit CountingAllocator(Arena* arena) : arena(arena) {}
+    template<typename U>
+    CountingAllocator(const CountingAllocator<U, PROPAGATE>& other) : arena(other.arena) {}
+
+    T* allocate(size_t count) {
+        arena->live += count * sizeof(T);
+        ++arena->allocations;
+        return static_cast<T*>(::operator new(count * sizeof(T)));
+    }
+
+    void deallocate(T* block, size_t count) {
+        arena->live -= count * sizeof(T);
+        ::operator delete(block);
+    }
+};
+
+template<typename T, typename U, bool P>
+bool operator==(const CountingAllocator<T, P>& a, const CountingAllocator<U, P>& b) {
+    return a.arena == b.arena;
+}
+
+template<typename T, typename U, bool P>
+bool operator!=(const CountingAllocator<T, P>& a, const CountingAllocator<U, P>& b) {
+    return a.arena != b.arena;
+}
+
+typedef CountingAllocator<std::string, false> Sticky;
+typedef CountingAllocator<std::string, true> Propagating;
+
+// Counts live instances, to check that pops destroy what they remove.
+struct Tracked {
+    static int live;
+    int value;
+    Tracked(int value = 0) : value(value) { ++live; }
+    Tracked(const Tracked& other) : value(other.value) { ++live; }
+    ~Tracked() { --live; }
+    Tracked& operator=(const Tracked&) = default;
+};
+
+int Tracked::live = 0;
+
+const std::string LONG = "a string long enough to need its own heap block";
+
+}  // namespace
+
+TEST(AllocatorTest, EveryContainerAllocatesThroughItsAllocator) {
+    Arena arena = {};
+    {
+        Queue<std::string, Sticky> queue{ Sticky(&arena) };
+        List<std::string, Sticky> list{ Sticky(&arena) };
+        Stack<std::string, Sticky> stack{ Sticky(&arena) };
+        for (int i = 0; i < 50; ++i) {
+            queue.push(LONG);
+            list.push_back(LONG);
+            stack.push(LONG);
+        }
+        EXPECT_GT(arena.live, 0);
+        EXPECT_EQ(queue.get_allocator(), Sticky(&arena));
+        EXPECT_EQ(stack.get_allocator(), Sticky(&arena));
+        list.pop_front();
+        list.erase(++list.begin());
+        stack.pop();
+        queue.clear();
+    }
+    EXPECT_EQ(arena.live, 0);
+    EXPECT_GT(arena.allocations, 100);
+}
+
+TEST(AllocatorTest, QueueConstructsOnlyQueuedElements) {
+    Tracked::live = 0;
+    {
+        Queue<Tracked> queue;
+        EXPECT_EQ(Tracked::live, 0);   // no default-constructed slots
+        for (int i = 0; i < 25; ++i) {
+            queue.push(Tracked(i));   // grows across two resizes
+        }
+        EXPECT_EQ(Tracked::live, 25);
+        queue.pop();
+        queue.pop_back();
+        EXPECT_EQ(Tracked::live, 23);
+        EXPECT_EQ(queue.front().value, 1);
+        EXPECT_EQ(queue.back().value, 23);
+    }
+    EXPECT_EQ(Tracked::live, 0);
+}
+
+TEST(AllocatorTest, CopyAssignmentFollowsPropagationTrait) {
+    Arena a = {};
+    Arena b = {};
+    List<std::string, Sticky> stickySource{ Sticky(&a) };
+    List<std::string, Sticky> stickyTarget{ Sticky(&b) };
+    stickySource.push_back(LONG);
+    stickyTarget = stickySource;
+    EXPECT_EQ(stickyTarget.get_allocator(), Sticky(&b));
+    EXPECT_EQ(stickyTarget.front(), LONG);
+
+    Arena c = {};
+    Arena d = {};
+    Queue<std::string, Propagating> source{ Propagating(&c) };
+    Queue<std::string, Propagating> target{ Propagating(&d) };
+    source.push(LONG);
+    target.push(LONG);
+    target = source;
+    EXPECT_EQ(target.get_allocator(), Propagating(&c));
+    EXPECT_EQ(d.live, 0);   // the old buffer went back to the old arena
+    EXPECT_EQ(target.front(), LONG);
+}
+
+TEST(AllocatorTest, MoveBetweenUnequalAllocatorsCopiesElements) {
+    Arena a = {};
+    Arena b = {};
+    Queue<std::string, Sticky> source{ Sticky(&a) };
+    Queue<std::string, Sticky> target{ Sticky(&b) };
+    for (int i = 0; i < 12; ++i) {
+        source.push(std::to_string(i));
+    }
+    target = std::move(source);
+    EXPECT_EQ(target.get_allocator(), Sticky(&b));
+    EXPECT_TRUE(source.empty());
+    ASSERT_EQ(target.size(), 12);
+    EXPECT_EQ(target.front(), "0");
+    EXPECT_EQ(target.back(), "11");
+
+    // Equal allocators: the buffer changes hands without copying.
+    Queue<std::string, Sticky> same{ Sticky(&b) };
+    size_t allocations = b.allocations;
+    same = std::move(target);
+    EXPECT_EQ(b.allocations, allocations);
+    EXPECT_EQ(same.size(), 12);
+    target.push("reused");   // a moved-from queue works again
+    EXPECT_EQ(target.front(), "reused");
+
+    static_assert(!std::is_nothrow_move_assignable<List<std::string, Sticky>>::value,
+                  "a move that may copy can throw");
+    static_assert(std::is_nothrow_move_assignable<List<std::string>>::value,
+                  "std::allocator moves steal nodes");
+}
+
+TEST(AllocatorTest, SwapExchangesPropagatingAllocators) {
+    Arena a = {};
+    Arena b = {};
+    List<std::string, Propagating> left{ Propagating(&a) };
+    List<std::string, Propagating> right{ Propagating(&b) };
+    left.push_back("left");
+    right.push_back("right");
+    left.swap(right);
+    EXPECT_EQ(left.get_allocator(), Propagating(&b));
+    EXPECT_EQ(left.front(), "right");
+    left.clear();
+    EXPECT_EQ(b.live, 0);
+}
+
+#if ASD_EXCEPTIONS
+
+namespace {
+
+int allocationsToFail = 0;
+
+// Stateless allocator that throws bad_alloc for the next
+// allocationsToFail requests.
+template<typename T>
+struct FlakyAllocator {
+    typedef T value_type;
+
+    FlakyAllocator() {}
+    template<typename U>
+    FlakyAllocator(const FlakyAllocator<U>&) {}
+
+    T* allocate(size_t count) {
+        if (allocationsToFail > 0) {
+            --allocationsToFail;
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(::operator new(count * sizeof(T)));
+    }
+
+    void deallocate(T* block, size_t) {
+        ::operator delete(block);
+    }
+};
+
+template<typename T, typename U>
+bool operator==(const FlakyAllocator<T>&, const FlakyAllocator<U>&) {
+    return true;
+}
+
+template<typename T, typename U>
+bool operator!=(const FlakyAllocator<T>&, const FlakyAllocator<U>&) {
+    return false;
+}
+
+// A copy throws once copiesUntilFailure counts down to zero.
+struct FragileString {
+    static int copiesUntilFailure;
+    std::string value;
+
+    FragileString(const char* value) : value(value) {}
+    FragileString(const FragileString& other) : value(other.value) {
+        if (copiesUntilFailure > 0 && --copiesUntilFailure == 0) {
+            throw std::runtime_error("copy failed");
+        }
+    }
+    FragileString& operator=(const FragileString&) = default;
+};
+
+int FragileString::copiesUntilFailure = 0;
+
+}  // namespace
+
+TEST(AllocatorTest, FailedReallocationLeavesQueueUsable) {
+    Queue<int, FlakyAllocator<int>> queue;
+    int values[30] = {};
+    allocationsToFail = 1;
+    EXPECT_THROW(queue.assign(values, 30), std::bad_alloc);
+    EXPECT_TRUE(queue.empty());
+    queue.push(7);
+    EXPECT_EQ(queue.front(), 7);
+
+    Queue<int, FlakyAllocator<int>> large;
+    large.assign(values, 30);
+    allocationsToFail = 1;
+    EXPECT_THROW(queue = large, std::bad_alloc);
+    EXPECT_TRUE(queue.empty());
+    queue.push(8);
+    EXPECT_EQ(queue.size(), 1);
+    EXPECT_EQ(queue.back(), 8);
+}
+
+TEST(AllocatorTest, ThrowingCopyInAssignKeepsCopiedPrefix) {
+    FragileString values[] = { "a", "b", "c", "d" };
+    Queue<FragileString> queue;
+    FragileString::copiesUntilFailure = 3;
+    EXPECT_THROW(queue.assign(values, 4), std::runtime_error);
+    ASSERT_EQ(queue.size(), 2);
+
+    queue.push("X");   // goes after the prefix, not over its front
+    EXPECT_EQ(queue.size(), 3);
+    EXPECT_EQ(queue.front().value, "a");
+    EXPECT_EQ(queue.back().value, "X");
+    queue.pop();
+    EXPECT_EQ(queue.front().value, "b");
+}
+
+#endif
+
+#if defined(ASD_HAS_PMR)
+
+TEST(AllocatorTest, PmrContainersShareOneMonotonicBuffer) {
+    alignas(std::max_align_t) static char buffer[1 << 16];
+    std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+    {
+        // The null upstream throws if anything, strings included, falls
+        // outside the buffer.
+        pmr::Queue<std::pmr::string> queue(&arena);
+        pmr::List<std::pmr::string> list(&arena);
+        pmr::Stack<int> stack(&arena);
+        for (int i = 0; i < 40; ++i) {
+            queue.push(std::pmr::string(LONG.c_str(), &arena));
+            list.push_back(std::pmr::string(LONG.c_str(), &arena));
+            stack.push(i);
+        }
+        EXPECT_EQ(queue.front().get_allocator().resource(), &arena);
+        EXPECT_EQ(list.back().get_allocator().resource(), &arena);
+
+        // Copies start on the default resource, as polymorphic_allocator
+        // asks.
+        pmr::List<std::pmr::string> copy(list);
+        EXPECT_EQ(copy.get_allocator().resource(), std::pmr::get_default_resource());
+    }
+    arena.release();
+}
+
+#endif
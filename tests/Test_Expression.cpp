@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "expression.h"
+#include "expect_error.h"
+
+TEST(ExpressionTest, Constants) {
+    Expression expression("1 + 2 * 3", {});
+    EXPECT_DOUBLE_EQ(expression.evaluate(nullptr), 7);
+    EXPECT_EQ(expression.code().size(), 5);
+}
+
+TEST(ExpressionTest, PrecedenceAndGrouping) {
+    EXPECT_DOUBLE_EQ(Expression("(1 + 2) * 3", {}).evaluate(nullptr), 9);
+    EXPECT_DOUBLE_EQ(Expression("[1 + 2] * {3 - 1}", {}).evaluate(nullptr), 6);
+    EXPECT_DOUBLE_EQ(Expression("8 / 4 / 2", {}).evaluate(nullptr), 1);
+    EXPECT_DOUBLE_EQ(Expression("10 - 4 - 3", {}).evaluate(nullptr), 3);
+    EXPECT_DOUBLE_EQ(Expression("2 ^ 3 ^ 2", {}).evaluate(nullptr), 512);
+}
+
+TEST(ExpressionTest, UnaryMinus) {
+    EXPECT_DOUBLE_EQ(Expression("-2 ^ 2", {}).evaluate(nullptr), -4);
+    EXPECT_DOUBLE_EQ(Expression("2 ^ -1", {}).evaluate(nullptr), 0.5);
+    EXPECT_DOUBLE_EQ(Expression("3 * -(1 + 1)", {}).evaluate(nullptr), -6);
+    EXPECT_DOUBLE_EQ(Expression("--4", {}).evaluate(nullptr), 4);
+}
+
+TEST(ExpressionTest, Numbers) {
+    EXPECT_DOUBLE_EQ(Expression("1.5e2 + .25", {}).evaluate(nullptr), 150.25);
+}
+
+TEST(ExpressionTest, Variables) {
+    Expression expression("price * (1 + tax_rate) - discount", { "price", "tax_rate", "discount" });
+    double values[] = { 100, 0.2, 5 };
+    EXPECT_DOUBLE_EQ(expression.evaluate(values), 115);
+    EXPECT_EQ(expression.variableCount(), 3);
+}
+
+TEST(ExpressionTest, RejectsMalformedInput) {
+    EXPECT_THROW(Expression("(1 + 2", {}), std::invalid_argument);
+    EXPECT_THROW(Expression("(1 + 2]", {}), std::invalid_argument);
+    EXPECT_THROW(Expression("1 +", {}), std::invalid_argument);
+    EXPECT_THROW(Expression("1 2", {}), std::invalid_argument);
+    EXPECT_THROW(Expression("()", {}), std::invalid_argument);
+    EXPECT_THROW(Expression("* 3", {}), std::invalid_argument);
+    EXPECT_THROW(Expression("x + 1", {}), std::invalid_argument);
+    EXPECT_THROW(Expression("1 % 2", {}), std::invalid_argument);
+    EXPECT_THROW(Expression("", {}), std::invalid_argument);
+}
+
+TEST(ExpressionTest, RejectsTooDeepNesting) {
+    std::string text = std::string(300, '(') + "1" + std::string(300, ')');
+    EXPECT_THROW(Expression(text, {}), std::invalid_argument);
+}
+
+TEST(ExpressionTest, StackDepth) {
+    Expression expression("a + (b * (c - d))", { "a", "b", "c", "d" });
+    EXPECT_EQ(expression.stackDepth(), 4);
+}
+
+TEST(ExpressionTest, BatchMatchesScalar) {
+    Expression expression("-x ^ 2 + 3 * y / (x + 1) - 0.5", { "x", "y" });
+    const size_t rows = 1000;
+    std::vector<double> x(rows), y(rows), out(rows);
+    for (size_t i = 0; i < rows; ++i) {
+        x[i] = static_cast<double>(i) / 7;
+        y[i] = static_cast<double>(rows - i);
+    }
+    const double* columns[] = { x.data(), y.data() };
+
+    expression.evaluate(columns, rows, out.data());
+
+    for (size_t i = 0; i < rows; ++i) {
+        double values[] = { x[i], y[i] };
+        EXPECT_DOUBLE_EQ(out[i], expression.evaluate(values));
+    }
+}
+
+TEST(ExpressionTest, DeepExpressionUsesHeapStack) {
+    std::string text = "1";
+    for (int i = 0; i < 40; ++i) {
+        text = "1 + (" + text + ")";
+    }
+    std::string reversed = "1";
+    for (int i = 0; i < 40; ++i) {
+        reversed = "(" + reversed + ") + 1";
+    }
+    Expression expression(text, {});
+    EXPECT_DOUBLE_EQ(expression.evaluate(nullptr), 41);
+    EXPECT_GT(expression.stackDepth(), 32);
+
+    double out[3];
+    expression.evaluate(nullptr, 3, out);
+    EXPECT_DOUBLE_EQ(out[2], 41);
+    EXPECT_DOUBLE_EQ(Expression(reversed, {}).evaluate(nullptr), 41);
+}
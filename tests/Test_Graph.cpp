@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+#include "graph.h"
+#include "graph_search.h"
+#include "parallel_bfs.h"
+#include "expect_error.h"
+
+namespace {
+
+std::vector<uint32_t> as_vector(Graph::Neighbors neighbors) {
+    return std::vector<uint32_t>(neighbors.begin(), neighbors.end());
+}
+
+// 0 -> 1, 2; 1 -> 3; 2 -> 3; 3 -> 4; 5 isolated.
+Graph sample_graph() {
+    std::vector<Graph::Edge> edges = { { 0, 1 }, { 1, 3 }, { 0, 2 }, { 2, 3 }, { 3, 4 } };
+    return Graph(6, edges);
+}
+
+void dfs_reference(const std::vector<std::vector<uint32_t>>& adjacency, uint32_t vertex,
+                   std::vector<bool>& seen, std::vector<uint32_t>& order) {
+    seen[vertex] = true;
+    order.push_back(vertex);
+    for (uint32_t next : adjacency[vertex]) {
+        if (!seen[next]) {
+            dfs_reference(adjacency, next, seen, order);
+        }
+    }
+}
+
+// Skewed degrees: low vertex numbers collect most edges, like R-MAT.
+std::vector<Graph::Edge> skewed_edges(uint32_t vertices, size_t count, unsigned seed) {
+    std::vector<Graph::Edge> edges(count);
+    for (Graph::Edge& edge : edges) {
+        seed = seed * 1103515245u + 12345u;
+        uint32_t a = (seed >> 8) % vertices;
+        seed = seed * 1103515245u + 12345u;
+        uint32_t b = (seed >> 8) % vertices;
+        edge.from = static_cast<uint32_t>(uint64_t(a) * b / vertices);
+        edge.to = b;
+    }
+    return edges;
+}
+
+}  // namespace
+
+TEST(GraphTest, EmptyGraph) {
+    Graph graph;
+    EXPECT_EQ(graph.vertexCount(), 0);
+    EXPECT_EQ(graph.edgeCount(), 0);
+}
+
+TEST(GraphTest, BuildsRowsInEdgeOrder) {
+    Graph graph = sample_graph();
+    EXPECT_EQ(graph.vertexCount(), 6);
+    EXPECT_EQ(graph.edgeCount(), 5);
+    EXPECT_EQ(as_vector(graph.neighbors(0)), std::vector<uint32_t>({ 1, 2 }));
+    EXPECT_EQ(as_vector(graph.neighbors(3)), std::vector<uint32_t>({ 4 }));
+    EXPECT_TRUE(graph.neighbors(5).empty());
+    EXPECT_EQ(graph.degree(0), 2);
+    EXPECT_EQ(graph.rowOffsets(), std::vector<size_t>({ 0, 2, 3, 4, 5, 5, 5 }));
+}
+
+TEST(GraphTest, InvalidVertices) {
+    std::vector<Graph::Edge> edges = { { 0, 3 } };
+    EXPECT_THROW(Graph(3, edges), std::out_of_range);
+    Graph graph = sample_graph();
+    EXPECT_THROW(graph.neighbors(6), std::out_of_range);
+    EXPECT_THROW(graph.degree(6), std::out_of_range);
+}
+
+TEST(GraphTest, Transpose) {
+    Graph reverse = sample_graph().transpose();
+    EXPECT_EQ(reverse.edgeCount(), 5);
+    EXPECT_TRUE(reverse.neighbors(0).empty());
+    EXPECT_EQ(as_vector(reverse.neighbors(3)), std::vector<uint32_t>({ 1, 2 }));
+    EXPECT_EQ(as_vector(reverse.neighbors(4)), std::vector<uint32_t>({ 3 }));
+}
+
+TEST(GraphSearchTest, BfsOrderAndDistances) {
+    Graph graph = sample_graph();
+    EXPECT_EQ(bfs_order(graph, 0), std::vector<uint32_t>({ 0, 1, 2, 3, 4 }));
+    EXPECT_EQ(bfs_distances(graph, 0),
+              std::vector<uint32_t>({ 0, 1, 1, 2, 3, UNREACHED }));
+    EXPECT_EQ(bfs_order(graph, 5), std::vector<uint32_t>({ 5 }));
+}
+
+TEST(GraphSearchTest, DfsOrder) {
+    Graph graph = sample_graph();
+    EXPECT_EQ(dfs_order(graph, 0), std::vector<uint32_t>({ 0, 1, 3, 4, 2 }));
+    EXPECT_THROW(dfs_order(graph, 6), std::out_of_range);
+}
+
+TEST(GraphSearchTest, SharedVisitedSetCountsComponents) {
+    std::vector<Graph::Edge> edges = { { 0, 1 }, { 1, 0 }, { 2, 3 }, { 3, 2 } };
+    Graph graph(5, edges);
+    VisitedSet visited(graph.vertexCount());
+    size_t components = 0;
+    for (uint32_t v = 0; v < graph.vertexCount(); ++v) {
+        components += breadth_first_search(graph, v, visited, [](uint32_t, uint32_t) {}) > 0;
+    }
+    EXPECT_EQ(components, 3);
+}
+
+TEST(GraphSearchTest, MatchesRecursiveReferenceOnRandomGraph) {
+    const uint32_t VERTICES = 2000;
+    std::vector<Graph::Edge> edges;
+    std::vector<std::vector<uint32_t>> adjacency(VERTICES);
+    unsigned seed = 7;
+    for (int i = 0; i < 6000; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        uint32_t from = (seed >> 8) % VERTICES;
+        seed = seed * 1103515245u + 12345u;
+        uint32_t to = (seed >> 8) % VERTICES;
+        edges.push_back(Graph::Edge{ from, to });
+        adjacency[from].push_back(to);
+    }
+    Graph graph(VERTICES, edges);
+
+    std::vector<bool> seen(VERTICES, false);
+    std::vector<uint32_t> expected;
+    dfs_reference(adjacency, 0, seen, expected);
+    EXPECT_EQ(dfs_order(graph, 0), expected);
+
+    std::vector<uint32_t> bfs = bfs_order(graph, 0);
+    std::vector<uint32_t> distances = bfs_distances(graph, 0);
+    std::sort(bfs.begin(), bfs.end());
+    std::sort(expected.begin(), expected.end());
+    EXPECT_EQ(bfs, expected);
+    for (const Graph::Edge& edge : edges) {
+        if (distances[edge.from] != UNREACHED) {
+            EXPECT_LE(distances[edge.to], distances[edge.from] + 1);
+        }
+    }
+}
+
+TEST(ParallelBfsTest, MatchesSerialDistances) {
+    const uint32_t VERTICES = 5000;
+    std::vector<Graph::Edge> edges = skewed_edges(VERTICES, 60000, 3);
+    Graph graph(VERTICES, edges);
+    Graph reverse = graph.transpose();
+    for (uint32_t source : { 0u, 17u, 4999u }) {
+        std::vector<uint32_t> expected = bfs_distances(graph, source);
+        for (unsigned threads : { 1u, 3u, 8u }) {
+            EXPECT_EQ(bfs_distances_parallel(graph, reverse, source, threads), expected);
+        }
+    }
+}
+
+TEST(ParallelBfsTest, UndirectedGraphIsItsOwnReverse) {
+    const uint32_t VERTICES = 3000;
+    std::vector<Graph::Edge> edges = skewed_edges(VERTICES, 20000, 9);
+    size_t count = edges.size();
+    for (size_t i = 0; i < count; ++i) {
+        edges.push_back(Graph::Edge{ edges[i].to, edges[i].from });
+    }
+    Graph graph(VERTICES, edges);
+    EXPECT_EQ(bfs_distances_parallel(graph, graph, 5, 4), bfs_distances(graph, 5));
+}
+
+TEST(ParallelBfsTest, SmallAndInvalidInputs) {
+    Graph graph = sample_graph();
+    EXPECT_EQ(bfs_distances_parallel(graph, 0, 2), bfs_distances(graph, 0));
+    EXPECT_EQ(bfs_distances_parallel(graph, 5, 2), bfs_distances(graph, 5));
+    EXPECT_THROW(bfs_distances_parallel(graph, 6), std::out_of_range);
+    Graph other(6, std::vector<Graph::Edge>());
+    EXPECT_THROW(bfs_distances_parallel(graph, other, 0), std::invalid_argument);
+}
@@ -0,0 +1,210 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "hash_map.h"
+#include "expect_error.h"
+
+namespace {
+
+// No default constructor, move-only.
+struct Handle {
+    std::unique_ptr<int> value;
+    explicit Handle(int v) : value(new int(v)) {}
+};
+
+// Every key lands in the same home slot.
+struct CollidingHash {
+    size_t operator()(int) const { return 0; }
+};
+
+}  // namespace
+
+TEST(FlatHashMapTest, InsertFindErase) {
+    FlatHashMap<int, int> map;
+    EXPECT_TRUE(map.empty());
+    EXPECT_TRUE(map.insert(std::make_pair(1, 10)).second);
+    EXPECT_FALSE(map.insert(std::make_pair(1, 20)).second);
+    map[2] = 30;
+
+    EXPECT_EQ(map.size(), 2);
+    EXPECT_EQ(map.at(1), 10);
+    EXPECT_EQ(map[2], 30);
+    EXPECT_TRUE(map.contains(1));
+    EXPECT_EQ(map.count(3), 0);
+    EXPECT_TRUE(map.find(3) == map.end());
+    EXPECT_THROW(map.at(3), std::out_of_range);
+
+    EXPECT_EQ(map.erase(1), 1);
+    EXPECT_EQ(map.erase(1), 0);
+    EXPECT_FALSE(map.contains(1));
+    EXPECT_EQ(map.size(), 1);
+}
+
+TEST(FlatHashMapTest, InsertOrAssign) {
+    FlatHashMap<std::string, int> map;
+    EXPECT_TRUE(map.insert_or_assign("a", 1).second);
+    EXPECT_FALSE(map.insert_or_assign("a", 2).second);
+    EXPECT_EQ(map.at("a"), 2);
+}
+
+TEST(FlatHashMapTest, MatchesUnorderedMapUnderRandomOperations) {
+    FlatHashMap<uint64_t, uint64_t> map;
+    std::unordered_map<uint64_t, uint64_t> expected;
+    std::mt19937_64 random(1);
+    for (int step = 0; step < 200000; ++step) {
+        uint64_t key = random() % 5000;
+        switch (random() % 3) {
+        case 0:
+            map[key] = step;
+            expected[key] = step;
+            break;
+        case 1:
+            EXPECT_EQ(map.erase(key), expected.erase(key));
+            break;
+        default:
+            EXPECT_EQ(map.contains(key), expected.count(key) == 1);
+            break;
+        }
+        ASSERT_EQ(map.size(), expected.size());
+    }
+    size_t visited = 0;
+    for (const auto& entry : map) {
+        EXPECT_EQ(entry.second, expected.at(entry.first));
+        ++visited;
+    }
+    EXPECT_EQ(visited, expected.size());
+}
+
+TEST(FlatHashMapTest, ReserveAvoidsRehash) {
+    FlatHashMap<int, int> map;
+    map.reserve(1000);
+    size_t slots = map.capacity();
+    EXPECT_GE(slots * 7 / 8, 1000);
+    for (int i = 0; i < 1000; ++i) {
+        map[i] = i;
+    }
+    EXPECT_EQ(map.capacity(), slots);
+    EXPECT_LE(map.load_factor(), 0.875);
+}
+
+TEST(FlatHashMapTest, NonDefaultConstructibleMoveOnlyValues) {
+    FlatHashMap<int, Handle> map;
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_TRUE(map.try_emplace(i, i * 2).second);
+    }
+    EXPECT_FALSE(map.try_emplace(5, 0).second);
+    EXPECT_EQ(*map.at(5).value, 10);
+    map.erase(5);
+    EXPECT_EQ(*map.at(99).value, 198);
+
+    FlatHashMap<int, Handle> moved(std::move(map));
+    EXPECT_EQ(moved.size(), 99);
+    EXPECT_TRUE(map.empty());
+}
+
+TEST(FlatHashMapTest, HeterogeneousStringLookup) {
+    FlatHashMap<std::string, int, StringHash, StringEqual> map;
+    map["alpha"] = 1;
+    map[std::string("beta")] = 2;
+
+    const char* key = "alpha";
+    EXPECT_EQ(map.find(key)->second, 1);
+    EXPECT_TRUE(map.contains(StringView("beta-suffix", 4)));
+    EXPECT_FALSE(map.contains("gamma"));
+    EXPECT_EQ(map.erase("beta"), 1);
+    EXPECT_EQ(map.size(), 1);
+}
+
+TEST(FlatHashMapTest, CopyAndAssign) {
+    FlatHashMap<std::string, std::string> map;
+    for (int i = 0; i < 50; ++i) {
+        map[std::to_string(i)] = std::string(i, 'x');
+    }
+    FlatHashMap<std::string, std::string> copy(map);
+    map.clear();
+    EXPECT_EQ(copy.size(), 50);
+    EXPECT_EQ(copy.at("7"), "xxxxxxx");
+
+    map = copy;
+    EXPECT_EQ(map.size(), 50);
+    map["new"] = "value";
+    EXPECT_EQ(copy.count("new"), 0);
+}
+
+TEST(FlatHashMapTest, ClusteredKeysSurviveErase) {
+    FlatHashMap<int, int, CollidingHash> map;
+    for (int i = 0; i < 200; ++i) {
+        map[i] = i;
+    }
+    for (int i = 0; i < 200; i += 3) {
+        map.erase(i);
+    }
+    for (int i = 0; i < 200; ++i) {
+        EXPECT_EQ(map.contains(i), i % 3 != 0);
+    }
+}
+
+#if ASD_EXCEPTIONS
+
+namespace {
+
+// A copy throws once copiesUntilFailure counts down to zero. The move may
+// throw too, so a rehash has to copy it.
+struct FragileValue {
+    static int copiesUntilFailure;
+    std::string value;
+
+    explicit FragileValue(int v) : value(std::to_string(v)) {}
+    FragileValue(const FragileValue& other) : value(other.value) {
+        if (copiesUntilFailure > 0 && --copiesUntilFailure == 0) {
+            throw std::runtime_error("copy failed");
+        }
+    }
+    FragileValue(FragileValue&& other) noexcept(false) : value(std::move(other.value)) {}
+    FragileValue& operator=(const FragileValue&) = default;
+    FragileValue& operator=(FragileValue&&) = default;
+};
+
+int FragileValue::copiesUntilFailure = 0;
+
+}  // namespace
+
+TEST(FlatHashMapTest, ThrowingRehashLeavesMapUnchanged) {
+    FlatHashMap<int, FragileValue> map;
+    for (int i = 0; i < 14; ++i) {   // 7/8 of the first 16 slots
+        map.try_emplace(i, i);
+    }
+    ASSERT_EQ(map.capacity(), 16);
+
+    FragileValue::copiesUntilFailure = 5;   // fails partway through the rehash
+    EXPECT_THROW(map.try_emplace(14, 14), std::runtime_error);
+    FragileValue::copiesUntilFailure = 0;
+    EXPECT_EQ(map.size(), 14);
+    EXPECT_EQ(map.capacity(), 16);
+    EXPECT_FALSE(map.contains(14));
+    for (int i = 0; i < 14; ++i) {
+        EXPECT_EQ(map.at(i).value, std::to_string(i));
+    }
+
+    EXPECT_TRUE(map.try_emplace(14, 14).second);
+    EXPECT_EQ(map.size(), 15);
+    EXPECT_EQ(map.at(3).value, "3");
+}
+
+#endif
+
+TEST(FlatHashSetTest, InsertContainsErase) {
+    FlatHashSet<std::string, StringHash, StringEqual> set;
+    EXPECT_TRUE(set.insert("x").second);
+    EXPECT_FALSE(set.insert(std::string("x")).second);
+    EXPECT_TRUE(set.insert("y").second);
+    EXPECT_TRUE(set.contains("x"));
+    EXPECT_EQ(*set.find("y"), "y");
+    EXPECT_EQ(set.erase("x"), 1);
+    EXPECT_FALSE(set.contains("x"));
+    EXPECT_EQ(set.size(), 1);
+}
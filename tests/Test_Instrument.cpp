@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include "list.h"
+#include "queue.h"
+#include "stack.h"
+
+#if defined(ASD_INSTRUMENT)
+
+TEST(InstrumentTest, QueueCountsResizesAndPeaks) {
+    Queue<int> queue;
+    for (int i = 0; i < 100; ++i) {
+        queue.push(i);
+    }
+    for (int i = 0; i < 60; ++i) {
+        queue.pop();
+    }
+    ContainerStats stats = queue.stats();
+    EXPECT_EQ(stats.type, "Queue");
+    EXPECT_EQ(stats.elementSize, sizeof(int));
+    EXPECT_EQ(stats.operations, 160);
+    EXPECT_EQ(stats.resizes, 4);   // 10 -> 20 -> 40 -> 80 -> 160
+    EXPECT_EQ(stats.allocations, 5);
+    EXPECT_EQ(stats.bytesAllocated, (10 + 20 + 40 + 80 + 160) * sizeof(int));
+    EXPECT_EQ(stats.size, 40);
+    EXPECT_EQ(stats.peakSize, 100);
+    EXPECT_EQ(stats.capacity, 160);
+    EXPECT_EQ(stats.peakCapacity, 160);
+}
+
+TEST(InstrumentTest, ListAndStackCounters) {
+    List<double> list;
+    for (int i = 0; i < 10; ++i) {
+        list.push_back(i);
+    }
+    list.pop_front();
+    list.erase(++list.begin());
+    ContainerStats listStats = list.stats();
+    EXPECT_EQ(listStats.type, "List");
+    EXPECT_EQ(listStats.allocations, 10);
+    EXPECT_EQ(listStats.operations, 12);
+    EXPECT_EQ(listStats.size, 8);
+    EXPECT_EQ(listStats.peakSize, 10);
+
+    ArrayStack<int, 32> stack;
+    stack.push(1);
+    stack.push(2);
+    stack.pop();
+    ContainerStats stackStats = stack.stats();
+    EXPECT_EQ(stackStats.type, "ArrayStack");
+    EXPECT_EQ(stackStats.allocations, 0);
+    EXPECT_EQ(stackStats.operations, 3);
+    EXPECT_EQ(stackStats.size, 1);
+    EXPECT_EQ(stackStats.peakSize, 2);
+    EXPECT_EQ(stackStats.capacity, 32);
+}
+
+TEST(InstrumentTest, CopiesStartFresh) {
+    Queue<int> queue;
+    queue.push(1);
+    queue.push(2);
+    Queue<int> copy(queue);
+    EXPECT_EQ(copy.stats().operations, 2);   // the pushes that built the copy
+    EXPECT_EQ(copy.stats().size, 2);
+    copy.pop();
+    EXPECT_EQ(queue.stats().operations, 2);
+}
+
+TEST(InstrumentTest, RegistryDumpsLiveContainers) {
+    size_t before = ContainerRegistry::liveCount();
+    std::string json;
+    {
+        Queue<int> queue;
+        queue.setStatsLabel("ingest \"backlog\"");
+        queue.push(7);
+        List<int> list;
+        EXPECT_EQ(ContainerRegistry::liveCount(), before + 2);
+        json = ContainerRegistry::json();
+    }
+    EXPECT_EQ(ContainerRegistry::liveCount(), before);
+    EXPECT_NE(json.find("{\"containers\": ["), std::string::npos);
+    EXPECT_NE(json.find("\"label\": \"ingest \\\"backlog\\\"\""), std::string::npos);
+    EXPECT_NE(json.find("\"type\": \"List\""), std::string::npos);
+    EXPECT_NE(json.find("\"peak_size\": 1"), std::string::npos);
+}
+
+#else
+
+TEST(InstrumentTest, OffByDefault) {
+    Queue<int> queue;
+    queue.push(1);
+    queue.setStatsLabel("unused");
+    EXPECT_EQ(queue.stats().operations, 0);
+    EXPECT_EQ(queue.stats().type, "");
+    EXPECT_EQ(ContainerRegistry::liveCount(), 0);
+    EXPECT_EQ(ContainerRegistry::json(), "{\"containers\": []}\n");
+    // No probe member: the containers keep their uninstrumented layout.
+    EXPECT_EQ(sizeof(ArrayStack<int, 4>), 5 * sizeof(int));
+}
+
+#endif
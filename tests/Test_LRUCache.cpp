@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "lru_cache.h"
+#include "expect_error.h"
+
+TEST(LRUCacheTest, GetAndPut) {
+    LRUCache<int, std::string> cache(2);
+    std::string value;
+    EXPECT_FALSE(cache.get(1, value));
+
+    cache.put(1, "one");
+    cache.put(2, "two");
+    EXPECT_TRUE(cache.get(1, value));
+    EXPECT_EQ(value, "one");
+    EXPECT_EQ(cache.size(), 2);
+    EXPECT_EQ(cache.hits(), 1);
+    EXPECT_EQ(cache.misses(), 1);
+}
+
+TEST(LRUCacheTest, EvictsLeastRecentlyUsed) {
+    std::vector<std::pair<int, int>> evicted;
+    LRUCache<int, int> cache(3, [&evicted](const int& key, const int& value) {
+        evicted.push_back(std::make_pair(key, value));
+    });
+    cache.put(1, 10);
+    cache.put(2, 20);
+    cache.put(3, 30);
+    int value = 0;
+    cache.get(1, value);
+    cache.put(4, 40);
+
+    ASSERT_EQ(evicted.size(), 1);
+    EXPECT_EQ(evicted[0], std::make_pair(2, 20));
+    EXPECT_FALSE(cache.contains(2));
+    EXPECT_TRUE(cache.contains(1));
+    EXPECT_EQ(cache.evictions(), 1);
+
+    // Updating an entry also makes it most recent.
+    cache.put(3, 31);
+    cache.put(5, 50);
+    EXPECT_EQ(evicted.back(), std::make_pair(1, 10));
+    EXPECT_TRUE(cache.get(3, value));
+    EXPECT_EQ(value, 31);
+}
+
+TEST(LRUCacheTest, EraseClearAndStats) {
+    LRUCache<std::string, int> cache(4);
+    cache.put("a", 1);
+    cache.put("b", 2);
+    EXPECT_TRUE(cache.erase("a"));
+    EXPECT_FALSE(cache.erase("a"));
+    EXPECT_EQ(cache.size(), 1);
+
+    int value = 0;
+    cache.get("b", value);
+    cache.get("c", value);
+    cache.resetStats();
+    EXPECT_EQ(cache.hits(), 0);
+    EXPECT_EQ(cache.misses(), 0);
+
+    cache.clear();
+    EXPECT_EQ(cache.size(), 0);
+    EXPECT_FALSE(cache.contains("b"));
+}
+
+TEST(LRUCacheTest, ZeroCapacityThrows) {
+    EXPECT_THROW((LRUCache<int, int>(0)), std::invalid_argument);
+    EXPECT_THROW((ShardedLRUCache<int, int>(0)), std::invalid_argument);
+}
+
+TEST(LRUCacheTest, StaysWithinCapacity) {
+    LRUCache<int, int> cache(100);
+    for (int i = 0; i < 10000; ++i) {
+        cache.put(i % 250, i);
+        ASSERT_LE(cache.size(), 100);
+    }
+    int value = 0;
+    EXPECT_TRUE(cache.get(9999 % 250, value));
+    EXPECT_EQ(value, 9999);
+}
+
+#if ASD_EXCEPTIONS
+
+namespace {
+
+// Throws from the callsUntilFailure-th call from now; 0 means never.
+struct FlakyHash {
+    static int callsUntilFailure;
+
+    size_t operator()(int key) const {
+        if (callsUntilFailure > 0 && --callsUntilFailure == 0) {
+            throw std::runtime_error("hash failed");
+        }
+        return std::hash<int>()(key);
+    }
+};
+
+int FlakyHash::callsUntilFailure = 0;
+
+}  // namespace
+
+TEST(LRUCacheTest, FailedInsertLeavesCacheConsistent) {
+    LRUCache<int, std::string, FlakyHash> cache(2);
+    cache.put(1, "one");
+    cache.put(2, "two");
+
+    FlakyHash::callsUntilFailure = 2;   // put's lookup passes, the index insert throws
+    EXPECT_THROW(cache.put(3, "three"), std::runtime_error);
+    EXPECT_EQ(cache.size(), 2);
+    EXPECT_FALSE(cache.contains(3));
+
+    // Evictions still find every node in the index.
+    cache.put(4, "four");
+    cache.put(5, "five");
+    std::string value;
+    EXPECT_FALSE(cache.get(1, value));
+    EXPECT_FALSE(cache.get(2, value));
+    EXPECT_TRUE(cache.get(5, value));
+    EXPECT_EQ(cache.size(), 2);
+}
+
+#endif
+
+TEST(ShardedLRUCacheTest, ConcurrentAccess) {
+    ShardedLRUCache<int, int> cache(1000, 8);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&cache, t]() {
+            for (int i = 0; i < 20000; ++i) {
+                int key = (i * 7 + t) % 3000;
+                int value = 0;
+                if (cache.get(key, value)) {
+                    EXPECT_EQ(value, key * 2);
+                }
+                else {
+                    cache.put(key, key * 2);
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    EXPECT_LE(cache.size(), 1000);
+    EXPECT_EQ(cache.hits() + cache.misses(), 80000);
+    EXPECT_EQ(cache.shardCount(), 8);
+}
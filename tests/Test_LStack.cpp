@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include "LStack.h"
+#include "expect_error.h"
 #include <string>
 #include <vector>
 
@@ -62,6 +63,19 @@ TEST(StackTest, TopEmptyStack) {
     EXPECT_THROW(constStack.top(), std::underflow_error);
 }
 
+TEST(StackTest, TryPushAndTryPop) {
+    Stack<std::string> stack;
+    EXPECT_TRUE(stack.try_push("a"));
+    EXPECT_TRUE(stack.try_push(std::string("b")));
+
+    std::string out;
+    EXPECT_TRUE(stack.try_pop(out));
+    EXPECT_EQ(out, "b");
+    stack.pop_unchecked();
+    EXPECT_TRUE(stack.empty());
+    EXPECT_FALSE(stack.try_pop(out));
+}
+
 TEST(StackTest, CopyConstructor) {
     Stack<int> original{ 1, 2, 3 };
     Stack<int> copy(original);
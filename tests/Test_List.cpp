@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "list.h"
+
+namespace {
+
+std::vector<int> contents(List<int>& list) {
+    std::vector<int> result;
+    for (List<int>::Iterator it = list.begin(); it != list.end(); ++it) {
+        result.push_back(*it);
+    }
+    return result;
+}
+
+List<int>::Iterator at(List<int>& list, int steps) {
+    List<int>::Iterator it = list.begin();
+    while (steps-- > 0) {
+        ++it;
+    }
+    return it;
+}
+
+}  // namespace
+
+TEST(ListTest, InsertAndErase) {
+    List<int> list;
+    list.push_back(1);
+    list.push_back(3);
+    list.insert(at(list, 1), 2);
+    EXPECT_EQ(contents(list), std::vector<int>({ 1, 2, 3 }));
+    list.erase(at(list, 1));
+    EXPECT_EQ(contents(list), std::vector<int>({ 1, 3 }));
+}
+
+TEST(ListTest, TryPopFromEitherEnd) {
+    List<int> list;
+    for (int i = 1; i <= 4; ++i) {
+        list.push_back(i);
+    }
+    int out = 0;
+    EXPECT_TRUE(list.try_pop_front(out));
+    EXPECT_EQ(out, 1);
+    EXPECT_TRUE(list.try_pop_back(out));
+    EXPECT_EQ(out, 4);
+    list.pop_front_unchecked();
+    list.pop_back_unchecked();
+    EXPECT_TRUE(list.empty());
+    EXPECT_FALSE(list.try_pop_front(out));
+    EXPECT_FALSE(list.try_pop_back(out));
+    EXPECT_EQ(out, 4);
+}
+
+TEST(ListTest, MoveToFrontRelinksNode) {
+    List<int> list;
+    for (int i = 1; i <= 4; ++i) {
+        list.push_back(i);
+    }
+    List<int>::Iterator third = at(list, 2);
+    int* address = &*third;
+
+    list.move_to_front(third);
+    EXPECT_EQ(contents(list), std::vector<int>({ 3, 1, 2, 4 }));
+    EXPECT_EQ(&list.front(), address);
+
+    list.move_to_front(at(list, 3));
+    EXPECT_EQ(contents(list), std::vector<int>({ 4, 3, 1, 2 }));
+    EXPECT_EQ(list.back(), 2);
+
+    list.move_to_front(list.begin());
+    list.move_to_front(list.end());
+    EXPECT_EQ(contents(list), std::vector<int>({ 4, 3, 1, 2 }));
+    EXPECT_EQ(list.size(), 4);
+
+    // Backward links stay consistent after relinking the tail.
+    list.pop_back();
+    list.pop_back();
+    EXPECT_EQ(list.back(), 3);
+}
@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include "mapped_file.h"
+#include "expect_error.h"
+
+namespace {
+
+const char* PATH = "mapped_file_test.tmp";
+
+void write_file(const std::string& content) {
+    std::ofstream out(PATH, std::ios::binary);
+    out << content;
+}
+
+}  // namespace
+
+TEST(MappedFileTest, MapsWholeFile) {
+    write_file("hello, mapped world");
+    {
+        MappedFile file(PATH);
+        EXPECT_EQ(file.size(), 19);
+        const char* view = file.map(0, 19);
+        ASSERT_NE(view, nullptr);
+        EXPECT_EQ(std::string(view, 19), "hello, mapped world");
+    }
+    std::remove(PATH);
+}
+
+TEST(MappedFileTest, MapsUnalignedWindow) {
+    std::string content(3 * MappedFile::granularity(), 'a');
+    content[MappedFile::granularity() + 5] = 'X';
+    write_file(content);
+    {
+        MappedFile file(PATH);
+        const char* view = file.map(MappedFile::granularity() + 5, 4);
+        ASSERT_NE(view, nullptr);
+        EXPECT_EQ(std::string(view, 4), "Xaaa");
+    }
+    std::remove(PATH);
+}
+
+TEST(MappedFileTest, EmptyRangeReturnsNull) {
+    write_file("abc");
+    {
+        MappedFile file(PATH);
+        EXPECT_EQ(file.map(3, 10), nullptr);
+        EXPECT_EQ(file.map(0, 0), nullptr);
+    }
+    std::remove(PATH);
+}
+
+TEST(MappedFileTest, MoveTransfersOwnership) {
+    write_file("abc");
+    {
+        MappedFile file(PATH);
+        MappedFile moved(std::move(file));
+        EXPECT_EQ(moved.size(), 3);
+        EXPECT_EQ(file.size(), 0);
+        EXPECT_EQ(std::string(moved.map(0, 3), 3), "abc");
+    }
+    std::remove(PATH);
+}
+
+TEST(MappedFileTest, MissingFileThrows) {
+    EXPECT_THROW(MappedFile("no/such/file.bin"), std::runtime_error);
+}
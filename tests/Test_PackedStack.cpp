@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include "packed_stack.h"
+#include "expect_error.h"
+
+TEST(PackedStackTest, DefaultConstructor) {
+    PackedStack<2> stack;
+    EXPECT_TRUE(stack.isEmpty());
+    EXPECT_EQ(stack.size(), 0);
+}
+
+TEST(PackedStackTest, PushAndPop) {
+    PackedStack<2> stack;
+
+    stack.push(0);
+    stack.push(1);
+    stack.push(2);
+
+    EXPECT_EQ(stack.size(), 3);
+    EXPECT_EQ(stack.top(), 2);
+    EXPECT_EQ(stack.pop(), 2);
+    EXPECT_EQ(stack.pop(), 1);
+    EXPECT_EQ(stack.pop(), 0);
+    EXPECT_TRUE(stack.isEmpty());
+}
+
+TEST(PackedStackTest, CodesAreMasked) {
+    PackedStack<2> stack;
+    stack.push(7);
+    EXPECT_EQ(stack.pop(), 3);
+}
+
+TEST(PackedStackTest, PopThrowsWhenEmpty) {
+    PackedStack<2> stack;
+    EXPECT_THROW(stack.pop(), std::underflow_error);
+    EXPECT_THROW(stack.top(), std::underflow_error);
+}
+
+TEST(PackedStackTest, CrossesWordBoundaries) {
+    PackedStack<2> stack;
+    const int COUNT = 1000;
+
+    for (int i = 0; i < COUNT; ++i) {
+        stack.push(i % 3);
+    }
+    EXPECT_EQ(stack.size(), COUNT);
+
+    for (int i = COUNT - 1; i >= 0; --i) {
+        EXPECT_EQ(stack.pop(), static_cast<unsigned>(i % 3));
+    }
+    EXPECT_TRUE(stack.isEmpty());
+}
+
+TEST(PackedStackTest, RefillAfterPartialPop) {
+    PackedStack<2> stack;
+
+    for (int i = 0; i < 70; ++i) {
+        stack.push(1);
+    }
+    for (int i = 0; i < 40; ++i) {
+        stack.pop();
+    }
+    for (int i = 0; i < 10; ++i) {
+        stack.push(2);
+    }
+
+    EXPECT_EQ(stack.size(), 40);
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(stack.pop(), 2);
+    }
+    for (int i = 0; i < 30; ++i) {
+        EXPECT_EQ(stack.pop(), 1);
+    }
+}
+
+TEST(PackedStackTest, CopyAndMove) {
+    PackedStack<2> original;
+    for (int i = 0; i < 100; ++i) {
+        original.push(i % 4);
+    }
+
+    PackedStack<2> copy(original);
+    EXPECT_EQ(copy.size(), 100);
+
+    PackedStack<2> moved(std::move(original));
+    EXPECT_TRUE(original.isEmpty());
+
+    for (int i = 99; i >= 0; --i) {
+        EXPECT_EQ(copy.pop(), static_cast<unsigned>(i % 4));
+        EXPECT_EQ(moved.pop(), static_cast<unsigned>(i % 4));
+    }
+}
+
+TEST(PackedStackTest, ClearAndReserve) {
+    PackedStack<2> stack;
+    stack.reserve(1000);
+    EXPECT_GE(stack.capacity(), 1000);
+
+    stack.push(1);
+    stack.clear();
+    EXPECT_TRUE(stack.isEmpty());
+}
+
+TEST(PackedStackTest, WiderCodes) {
+    PackedStack<8> stack;
+    for (int i = 0; i < 256; ++i) {
+        stack.push(i);
+    }
+    for (int i = 255; i >= 0; --i) {
+        EXPECT_EQ(stack.pop(), static_cast<unsigned>(i));
+    }
+}
+
+TEST(PackedStackTest, AppendKeepsOrder) {
+    for (int below = 0; below < 70; below += 13) {
+        for (int above = 0; above < 140; above += 31) {
+            PackedStack<2> bottom, top;
+            for (int i = 0; i < below; ++i) {
+                bottom.push(i % 3);
+            }
+            for (int i = 0; i < above; ++i) {
+                top.push((i + 1) % 4);
+            }
+
+            bottom.append(top);
+            ASSERT_EQ(bottom.size(), static_cast<size_t>(below + above));
+            for (int i = above - 1; i >= 0; --i) {
+                ASSERT_EQ(bottom.pop(), static_cast<unsigned>((i + 1) % 4));
+            }
+            for (int i = below - 1; i >= 0; --i) {
+                ASSERT_EQ(bottom.pop(), static_cast<unsigned>(i % 3));
+            }
+        }
+    }
+}
@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include "queue.h" 
+#include "expect_error.h"
 #include <string>
 
 TEST(QueueTest, DefaultConstructor) {
@@ -68,6 +69,23 @@ TEST(QueueTest, EmptyQueueExceptions) {
     EXPECT_THROW(const_queue.back(), std::runtime_error);
 }
 
+TEST(QueueTest, TryPushAndTryPop) {
+    Queue<std::string> queue;
+    for (int i = 0; i < 15; ++i) {
+        EXPECT_TRUE(queue.try_push(std::to_string(i)));
+    }
+
+    std::string out;
+    EXPECT_TRUE(queue.try_pop(out));
+    EXPECT_EQ(out, "0");
+    queue.pop_unchecked();
+    EXPECT_EQ(queue.front(), "2");
+    while (queue.try_pop(out)) {
+    }
+    EXPECT_EQ(out, "14");
+    EXPECT_TRUE(queue.empty());
+}
+
 TEST(QueueTest, CopyConstructor) {
     Queue<int> original;
     original.push(1);
@@ -215,6 +233,103 @@ TEST(QueueTest, StressTest) {
     EXPECT_TRUE(queue.empty());
 }
 
+TEST(QueueTest, PushFrontAndPopBack) {
+    Queue<int> queue;
+
+    queue.push(2);
+    queue.push_front(1);
+    queue.push(3);
+    queue.push_front(0);
+
+    EXPECT_EQ(queue.size(), 4);
+    EXPECT_EQ(queue.front(), 0);
+    EXPECT_EQ(queue.back(), 3);
+
+    queue.pop_back();
+    EXPECT_EQ(queue.back(), 2);
+    queue.pop();
+    EXPECT_EQ(queue.front(), 1);
+    queue.pop_back();
+    EXPECT_EQ(queue.front(), 1);
+    EXPECT_EQ(queue.back(), 1);
+    queue.pop_back();
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(QueueTest, PopBackEmptyQueueThrows) {
+    Queue<int> queue;
+    EXPECT_THROW(queue.pop_back(), std::runtime_error);
+}
+
+TEST(QueueTest, PushFrontResize) {
+    Queue<int> queue;
+    for (int i = 0; i < 25; ++i) {
+        queue.push_front(i);
+    }
+
+    EXPECT_EQ(queue.size(), 25);
+    for (int i = 24; i >= 0; --i) {
+        EXPECT_EQ(queue.front(), i);
+        queue.pop();
+    }
+}
+
+TEST(QueueTest, DequeWraparound) {
+    Queue<int> queue;
+    for (int round = 0; round < 100; ++round) {
+        queue.push_front(round);
+        queue.push(-round);
+        if (round % 3 == 0) {
+            queue.pop_back();
+            queue.pop();
+        }
+    }
+    while (queue.size() > 1) {
+        EXPECT_GE(queue.front(), 0);
+        EXPECT_LE(queue.back(), 0);
+        queue.pop();
+        queue.pop_back();
+    }
+}
+
+TEST(QueueTest, SearchAcrossWraparound) {
+    Queue<float> queue;
+    for (int i = 0; i < 60; ++i) {
+        queue.push(static_cast<float>(i));
+    }
+    for (int i = 0; i < 50; ++i) {
+        queue.pop();
+        queue.push(static_cast<float>(i % 5));
+    }
+    ASSERT_NE(queue.secondSpan().size, 0);   // 50..59, then 0 1 2 3 4 repeated
+
+    EXPECT_EQ(queue.find(55.0f), 5);
+    EXPECT_EQ(queue.find(3.0f), 13);
+    EXPECT_EQ(queue.find(60.0f), Queue<float>::NPOS);
+    EXPECT_EQ(queue.count(4.0f), 10);
+    EXPECT_EQ(queue.minElement(), 0.0f);
+    EXPECT_EQ(&queue.minElement(), queue.firstSpan().data + 10);   // the earlier of the tied zeros
+    EXPECT_EQ(queue.maxElement(), 59.0f);
+}
+
+TEST(QueueTest, EqualityIgnoresBufferLayout) {
+    Queue<int> straight;
+    Queue<int> wrapped;
+    for (int i = 0; i < 40; ++i) {
+        straight.push(i);
+        wrapped.push(-1);
+    }
+    for (int i = 0; i < 40; ++i) {
+        wrapped.pop();
+        wrapped.push(i);
+    }
+    EXPECT_TRUE(straight == wrapped);
+    wrapped.pop_back();
+    wrapped.push(0);
+    EXPECT_TRUE(straight != wrapped);
+    EXPECT_TRUE(Queue<int>() == Queue<int>());
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "rcu_list.h"
+#include "expect_error.h"
+
+namespace {
+
+std::vector<int> elements(const RcuList<int>& list) {
+    std::vector<int> result;
+    list.for_each([&result](int value) { result.push_back(value); });
+    return result;
+}
+
+// Both halves always hold the same number; a torn or freed entry breaks that.
+struct Setting {
+    long long version;
+    long long check;
+
+    bool operator==(const Setting& other) const {
+        return version == other.version && check == other.check;
+    }
+};
+
+struct Counted {
+    static std::atomic<int> alive;
+    int value;
+
+    explicit Counted(int value) : value(value) { ++alive; }
+    Counted(const Counted& other) : value(other.value) { ++alive; }
+    ~Counted() { --alive; }
+    bool operator==(const Counted& other) const { return value == other.value; }
+};
+
+std::atomic<int> Counted::alive(0);
+
+}  // namespace
+
+TEST(RcuListTest, PushRemoveReplace) {
+    RcuList<int> list;
+    EXPECT_TRUE(list.empty());
+    list.push_back(2);
+    list.push_back(3);
+    list.push_front(1);
+    EXPECT_EQ(elements(list), std::vector<int>({ 1, 2, 3 }));
+    EXPECT_EQ(list.size(), 3);
+
+    EXPECT_EQ(list.remove(3), 1);
+    list.push_back(4);   // tail moved back to 2 when 3 left
+    EXPECT_EQ(elements(list), std::vector<int>({ 1, 2, 4 }));
+
+    EXPECT_EQ(list.replace_if([](int value) { return value % 2 == 0; }, 7), 2);
+    list.push_back(8);
+    EXPECT_EQ(elements(list), std::vector<int>({ 1, 7, 7, 8 }));
+    EXPECT_TRUE(list.contains(8));
+    EXPECT_FALSE(list.contains(2));
+
+    int found = 0;
+    EXPECT_TRUE(list.find_if([](int value) { return value > 7; }, found));
+    EXPECT_EQ(found, 8);
+
+    list.clear();
+    EXPECT_TRUE(list.empty());
+    EXPECT_EQ(list.size(), 0);
+    list.push_back(9);
+    EXPECT_EQ(elements(list), std::vector<int>({ 9 }));
+}
+
+TEST(RcuListTest, IteratorsUnderGuard) {
+    RcuList<std::string> list;
+    list.push_back("a");
+    list.push_back("b");
+    EpochManager::ReadGuard guard;
+    std::string joined;
+    for (const std::string& value : list) {
+        joined += value;
+    }
+    EXPECT_EQ(joined, "ab");
+}
+
+TEST(RcuListTest, RemovedNodesWaitForReaders) {
+    RcuList<Counted> list;
+    list.push_back(Counted(1));
+    list.push_back(Counted(2));
+    EpochManager::synchronize();
+    EXPECT_EQ(Counted::alive, 2);
+
+    {
+        EpochManager::ReadGuard guard;
+        auto it = list.begin();
+        list.remove(Counted(1));
+        EXPECT_THROW(EpochManager::synchronize(), std::logic_error);
+        for (int i = 0; i < 10; ++i) {
+            EpochManager::tryAdvance();
+        }
+        // Still reachable from the node this reader stands on.
+        EXPECT_EQ(it->value, 1);
+        ++it;
+        EXPECT_EQ(it->value, 2);
+        EXPECT_EQ(Counted::alive, 2);
+    }
+    EpochManager::synchronize();
+    EXPECT_EQ(Counted::alive, 1);
+    EXPECT_EQ(EpochManager::pending(), 0);
+}
+
+TEST(RcuListTest, GuardsNest) {
+    RcuList<Counted> list;
+    list.push_back(Counted(1));
+    EpochManager::synchronize();
+    {
+        EpochManager::ReadGuard outer;
+        {
+            EpochManager::ReadGuard inner;
+        }
+        list.clear();
+        EpochManager::tryAdvance();
+        EpochManager::tryAdvance();
+        EpochManager::tryAdvance();
+        EXPECT_EQ(Counted::alive, 1);
+    }
+    EpochManager::synchronize();
+    EXPECT_EQ(Counted::alive, 0);
+}
+
+TEST(RcuListTest, ReadersDuringUpdates) {
+    RcuList<Setting> list;
+    for (long long i = 0; i < 16; ++i) {
+        Setting setting = { i, i };
+        list.push_back(setting);
+    }
+    std::atomic<bool> done(false);
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&]() {
+            while (!done) {
+                size_t seen = 0;
+                list.for_each([&seen](const Setting& setting) {
+                    EXPECT_EQ(setting.version, setting.check);
+                    ++seen;
+                });
+                // One writer keeps the count between 15 and 17.
+                EXPECT_GE(seen, 15);
+                EXPECT_LE(seen, 17);
+            }
+        });
+    }
+
+    for (long long round = 16; round < 20000; ++round) {
+        Setting fresh = { round, round };
+        long long target = round % 16;
+        list.replace_if([target](const Setting& setting) { return setting.version % 16 == target; }, fresh);
+        if (round % 3 == 0) {
+            list.push_back({ -1, -1 });
+            list.remove_if([](const Setting& setting) { return setting.version == -1; });
+        }
+    }
+    done = true;
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+    EXPECT_EQ(list.size(), 16);
+    EpochManager::synchronize();
+}
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+#include "simd_search.h"
+
+namespace {
+
+const SearchKernel KERNELS[] = { SearchKernel::SCALAR, SearchKernel::SSE2, SearchKernel::AVX2 };
+
+// Every supported kernel must agree with the plain loops, tails included.
+template<typename T>
+void expect_kernels_match_scalar(T low, T high) {
+    std::mt19937 random(42);
+    std::uniform_int_distribution<long long> value(static_cast<long long>(low), static_cast<long long>(high));
+    for (size_t count = 1; count < 200; count += 7) {
+        std::vector<T> data(count);
+        for (T& item : data) {
+            item = static_cast<T>(value(random));
+        }
+        std::vector<T> copy = data;
+        copy[random() % count] = static_cast<T>(copy[0] + 1);
+        T needle = data[random() % count];
+        T missing = static_cast<T>(high + 1);
+
+        for (SearchKernel kernel : KERNELS) {
+            if (!search_kernel_supported(kernel)) {
+                continue;
+            }
+            const SearchKernels<T>* k = search_kernels<T>(kernel);
+            ASSERT_NE(k, nullptr);
+            EXPECT_EQ(k->find(data.data(), count, needle), scalar_find(data.data(), count, needle));
+            EXPECT_EQ(k->find(data.data(), count, missing), count);
+            EXPECT_EQ(k->findLast(data.data(), count, needle), scalar_find_last(data.data(), count, needle));
+            EXPECT_EQ(k->count(data.data(), count, needle), scalar_count(data.data(), count, needle));
+            EXPECT_EQ(k->minIndex(data.data(), count), scalar_min_index(data.data(), count));
+            EXPECT_EQ(k->maxIndex(data.data(), count), scalar_max_index(data.data(), count));
+            EXPECT_EQ(k->mismatch(data.data(), copy.data(), count), scalar_mismatch(data.data(), copy.data(), count));
+        }
+    }
+}
+
+}  // namespace
+
+TEST(SimdSearchTest, ByteKernelsMatchScalar) {
+    expect_kernels_match_scalar<char>(-100, 100);
+    expect_kernels_match_scalar<signed char>(-128, 126);
+    expect_kernels_match_scalar<unsigned char>(0, 254);
+}
+
+TEST(SimdSearchTest, WordKernelsMatchScalar) {
+    expect_kernels_match_scalar<int>(-1000, 1000);
+    expect_kernels_match_scalar<int>(std::numeric_limits<int>::min(), std::numeric_limits<int>::max() - 1);
+    expect_kernels_match_scalar<unsigned>(0, std::numeric_limits<unsigned>::max() - 1);
+}
+
+TEST(SimdSearchTest, FloatingKernelsMatchScalar) {
+    expect_kernels_match_scalar<float>(-50, 50);
+    expect_kernels_match_scalar<double>(-50, 50);
+}
+
+TEST(SimdSearchTest, NanMatchesNothingAndOnlyLeadsWhenFirst) {
+    std::vector<float> data(100, 1.0f);
+    data[10] = std::nanf("");
+    data[70] = -3.0f;
+    data[80] = 9.0f;
+    for (SearchKernel kernel : KERNELS) {
+        if (!search_kernel_supported(kernel)) {
+            continue;
+        }
+        const SearchKernels<float>* k = search_kernels<float>(kernel);
+        EXPECT_EQ(k->find(data.data(), data.size(), data[10]), data.size());
+        EXPECT_EQ(k->minIndex(data.data(), data.size()), 70);
+        EXPECT_EQ(k->maxIndex(data.data(), data.size()), 80);
+
+        std::vector<float> leading = data;
+        leading[0] = std::nanf("");
+        EXPECT_EQ(k->minIndex(leading.data(), leading.size()), 0);
+        EXPECT_EQ(k->mismatch(leading.data(), leading.data(), leading.size()), 0);
+    }
+}
@@ -0,0 +1,234 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "epoch.h"
+#include "skip_list.h"
+
+TEST(SkipListTest, InsertFindErase) {
+    ConcurrentSkipListMap<int, std::string> map;
+    EXPECT_TRUE(map.empty());
+    EXPECT_TRUE(map.insert(5, "five"));
+    EXPECT_TRUE(map.insert(1, "one"));
+    EXPECT_FALSE(map.insert(5, "again"));
+
+    std::string value;
+    EXPECT_TRUE(map.find(5, value));
+    EXPECT_EQ(value, "five");
+    EXPECT_FALSE(map.find(3, value));
+    EXPECT_EQ(map.size(), 2);
+
+    EXPECT_TRUE(map.erase(5));
+    EXPECT_FALSE(map.erase(5));
+    EXPECT_FALSE(map.contains(5));
+    EXPECT_TRUE(map.insert(5, "back"));
+    EXPECT_TRUE(map.find(5, value));
+    EXPECT_EQ(value, "back");
+}
+
+TEST(SkipListTest, OrderedIterationAndLowerBound) {
+    ConcurrentSkipListMap<int, int> map;
+    for (int i = 0; i < 1000; ++i) {
+        map.insert((i * 37) % 1000 * 2, i);
+    }
+    int expected = 0;
+    for (const auto& entry : map) {
+        EXPECT_EQ(entry.first, expected);
+        expected += 2;
+    }
+    EXPECT_EQ(expected, 2000);
+
+    EXPECT_EQ(map.lower_bound(501)->first, 502);
+    EXPECT_EQ(map.lower_bound(502)->first, 502);
+    EXPECT_EQ(map.lower_bound(-5)->first, 0);
+    EXPECT_TRUE(map.lower_bound(1999) == map.end());
+
+    map.erase(502);
+    EXPECT_EQ(map.lower_bound(501)->first, 504);
+}
+
+TEST(SkipListTest, CustomComparator) {
+    ConcurrentSkipListMap<int, int, std::greater<int>> map;
+    map.insert(1, 1);
+    map.insert(3, 3);
+    map.insert(2, 2);
+    std::vector<int> keys;
+    for (const auto& entry : map) {
+        keys.push_back(entry.first);
+    }
+    EXPECT_EQ(keys, std::vector<int>({ 3, 2, 1 }));
+}
+
+#if ASD_EXCEPTIONS
+
+namespace {
+
+// A value whose copy throws while failCopies is set.
+struct FragileValue {
+    static bool failCopies;
+    int value;
+
+    FragileValue(int value = 0) : value(value) {}
+    FragileValue(const FragileValue& other) : value(other.value) {
+        if (failCopies) {
+            throw std::runtime_error("copy failed");
+        }
+    }
+    FragileValue& operator=(const FragileValue&) = default;
+};
+
+bool FragileValue::failCopies = false;
+
+}  // namespace
+
+TEST(SkipListTest, ThrowingInsertLeavesNoLocksHeld) {
+    ConcurrentSkipListMap<int, FragileValue> map;
+    map.insert(1, FragileValue(10));
+    map.insert(3, FragileValue(30));
+
+    FragileValue::failCopies = true;
+    EXPECT_THROW(map.insert(2, FragileValue(20)), std::runtime_error);
+    FragileValue::failCopies = false;
+    EXPECT_FALSE(map.contains(2));
+
+    // These lock the same predecessors the failed insert did.
+    EXPECT_TRUE(map.insert(2, FragileValue(20)));
+    EXPECT_TRUE(map.erase(3));
+    EXPECT_TRUE(map.erase(1));
+    EXPECT_EQ(map.size(), 1);
+}
+
+#endif
+
+TEST(SkipListTest, ConcurrentInsertErase) {
+    ConcurrentSkipListMap<int, int> map;
+    const int THREADS = 4;
+    const int PER_THREAD = 5000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&map, t]() {
+            for (int i = 0; i < PER_THREAD; ++i) {
+                EXPECT_TRUE(map.insert(i * THREADS + t, t));
+            }
+            // Each thread erases its odd keys again.
+            for (int i = 1; i < PER_THREAD; i += 2) {
+                EXPECT_TRUE(map.erase(i * THREADS + t));
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(map.size(), THREADS * PER_THREAD / 2);
+    int previous = -1;
+    size_t seen = 0;
+    for (const auto& entry : map) {
+        EXPECT_GT(entry.first, previous);
+        EXPECT_EQ((entry.first / THREADS) % 2, 0);
+        EXPECT_EQ(entry.second, entry.first % THREADS);
+        previous = entry.first;
+        ++seen;
+    }
+    EXPECT_EQ(seen, map.size());
+    map.collect();
+    EXPECT_TRUE(map.contains(0));
+}
+
+TEST(SkipListTest, ContendedSameKeys) {
+    ConcurrentSkipListMap<int, int> map;
+    std::atomic<int> inserted(0);
+    std::atomic<int> erased(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < 20000; ++i) {
+                int key = i % 64;
+                if (i % 2 == 0) {
+                    inserted += map.insert(key, key);
+                }
+                else {
+                    erased += map.erase(key);
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(static_cast<size_t>(inserted - erased), map.size());
+}
+
+TEST(SkipListTest, ScansStaySortedDuringUpdates) {
+    ConcurrentSkipListMap<int, int> map;
+    // Even keys are never touched; odd keys churn.
+    for (int i = 0; i < 2000; i += 2) {
+        map.insert(i, i);
+    }
+    std::atomic<bool> done(false);
+    std::thread writer([&]() {
+        for (int round = 0; round < 20; ++round) {
+            for (int i = 1; i < 2000; i += 2) {
+                map.insert(i, i);
+            }
+            for (int i = 1; i < 2000; i += 2) {
+                map.erase(i);
+            }
+        }
+        done = true;
+    });
+    while (!done) {
+        EpochManager::ReadGuard guard;   // the writer frees what it erases
+        int previous = -1;
+        int evens = 0;
+        for (auto it = map.lower_bound(0); it != map.end(); ++it) {
+            ASSERT_GT(it->first, previous);
+            ASSERT_EQ(it->second, it->first);
+            evens += it->first % 2 == 0;
+            previous = it->first;
+        }
+        ASSERT_EQ(evens, 1000);
+    }
+    writer.join();
+}
+
+namespace {
+
+// Counts live values, to see when erased nodes are freed.
+struct CountedValue {
+    static std::atomic<int> live;
+    int value;
+
+    CountedValue(int value = 0) : value(value) { ++live; }
+    CountedValue(const CountedValue& other) : value(other.value) { ++live; }
+    ~CountedValue() { --live; }
+    CountedValue& operator=(const CountedValue&) = default;
+};
+
+std::atomic<int> CountedValue::live(0);
+
+}  // namespace
+
+TEST(SkipListTest, ErasedNodesAreFreedDuringConcurrentUse) {
+    ConcurrentSkipListMap<int, CountedValue> map;
+    const int ROUNDS = 20000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 2; ++t) {
+        threads.emplace_back([&map, t]() {
+            for (int i = 0; i < ROUNDS; ++i) {
+                int key = (i % 256) * 2 + t;
+                map.insert(key, CountedValue(i));
+                map.erase(key);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    // Without reclamation all 2 * ROUNDS erased values would still be live.
+    EXPECT_LT(CountedValue::live.load(), 2000);
+    map.collect();
+    EXPECT_EQ(CountedValue::live.load(), static_cast<int>(map.size()));
+}
@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+#include "sliding_window.h"
+#include "expect_error.h"
+
+namespace {
+
+std::vector<int> random_values(size_t n, unsigned seed) {
+    std::vector<int> values(n);
+    for (size_t i = 0; i < n; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        values[i] = static_cast<int>((seed >> 16) % 100);
+    }
+    return values;
+}
+
+}  // namespace
+
+TEST(SlidingWindowTest, MinAndMax) {
+    int data[] = { 4, 2, 12, 3, 8, 1, 7 };
+    int out[5];
+
+    EXPECT_EQ(sliding_window_min(data, 7, 3, out), 5);
+    EXPECT_EQ(std::vector<int>(out, out + 5), std::vector<int>({ 2, 2, 3, 1, 1 }));
+
+    EXPECT_EQ(sliding_window_max(data, 7, 3, out), 5);
+    EXPECT_EQ(std::vector<int>(out, out + 5), std::vector<int>({ 12, 12, 12, 8, 8 }));
+}
+
+TEST(SlidingWindowTest, WindowLargerThanInput) {
+    int data[] = { 1, 2 };
+    int out[1];
+    EXPECT_EQ(sliding_window_min(data, 2, 3, out), 0);
+}
+
+TEST(SlidingWindowTest, ZeroWindowThrows) {
+    int data[] = { 1 };
+    int out[1];
+    EXPECT_THROW(sliding_window_min(data, 1, 0, out), std::invalid_argument);
+    EXPECT_THROW(SlidingWindowMin<int>(0), std::invalid_argument);
+}
+
+TEST(SlidingWindowTest, MatchesNaiveRescan) {
+    for (size_t k : { 1, 2, 5, 64, 300 }) {
+        std::vector<int> data = random_values(1000, static_cast<unsigned>(k));
+        std::vector<int> mins(data.size()), maxs(data.size());
+        size_t count = sliding_window_min(data.data(), data.size(), k, mins.data());
+        sliding_window_max(data.data(), data.size(), k, maxs.data());
+
+        ASSERT_EQ(count, data.size() - k + 1);
+        for (size_t i = 0; i < count; ++i) {
+            ASSERT_EQ(mins[i], *std::min_element(data.begin() + i, data.begin() + i + k));
+            ASSERT_EQ(maxs[i], *std::max_element(data.begin() + i, data.begin() + i + k));
+        }
+    }
+}
+
+TEST(SlidingWindowTest, StreamingWindow) {
+    std::vector<int> data = random_values(500, 3);
+    SlidingWindowMin<int> minimum(10);
+    SlidingWindowMax<int> maximum(10);
+
+    for (size_t i = 0; i < data.size(); ++i) {
+        minimum.push(data[i]);
+        maximum.push(data[i]);
+        size_t begin = i + 1 > 10 ? i + 1 - 10 : 0;
+        EXPECT_EQ(minimum.value(), *std::min_element(data.begin() + begin, data.begin() + i + 1));
+        EXPECT_EQ(maximum.value(), *std::max_element(data.begin() + begin, data.begin() + i + 1));
+        EXPECT_EQ(minimum.full(), i + 1 >= 10);
+        EXPECT_EQ(minimum.size(), i + 1 - begin);
+    }
+}
+
+TEST(SlidingWindowTest, StreamingEmptyAndClear) {
+    SlidingWindowMax<double> window(4);
+    EXPECT_THROW(window.value(), std::runtime_error);
+    window.push(1.5);
+    EXPECT_DOUBLE_EQ(window.value(), 1.5);
+    window.clear();
+    EXPECT_EQ(window.samples(), 0);
+    EXPECT_THROW(window.value(), std::runtime_error);
+}
@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+#include "snapshot.h"
+#include "expect_error.h"
+
+namespace {
+
+const char* PATH = "snapshot_test.tmp";
+
+struct Point {
+    int32_t x;
+    int32_t y;
+    double weight;
+};
+
+void flip_byte(uint64_t offset) {
+    std::fstream file(PATH, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekg(offset);
+    char byte = 0;
+    file.read(&byte, 1);
+    byte ^= 0x40;
+    file.seekp(offset);
+    file.write(&byte, 1);
+}
+
+}  // namespace
+
+TEST(SnapshotTest, QueueRoundTripAcrossWrap) {
+    Queue<int> queue;
+    for (int i = 0; i < 8; ++i) {
+        queue.push(i);
+    }
+    for (int i = 0; i < 5; ++i) {
+        queue.pop();
+    }
+    for (int i = 8; i < 14; ++i) {
+        queue.push(i);   // wraps around the 10-slot buffer
+    }
+    ASSERT_GT(queue.secondSpan().size, 0);
+    save_snapshot(PATH, queue);
+
+    Queue<int> loaded;
+    load_snapshot(PATH, loaded);
+    ASSERT_EQ(loaded.size(), 9);
+    for (int i = 5; i < 14; ++i) {
+        EXPECT_EQ(loaded.front(), i);
+        loaded.pop();
+    }
+    loaded.push(99);
+    EXPECT_EQ(loaded.back(), 99);
+    std::remove(PATH);
+}
+
+TEST(SnapshotTest, ViewIsZeroCopyAndAligned) {
+    std::vector<Point> points;
+    for (int i = 0; i < 1000; ++i) {
+        points.push_back({ i, -i, i * 0.5 });
+    }
+    save_snapshot(PATH, points.data(), points.size());
+    {
+        SnapshotView<Point> view(PATH);
+        ASSERT_EQ(view.size(), 1000);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(view.data()) % PAYLOAD_ALIGNMENT, 0);
+        EXPECT_EQ(view[999].y, -999);
+        EXPECT_EQ(view[10].weight, 5.0);
+        size_t n = 0;
+        for (const Point& point : view) {
+            EXPECT_EQ(point.x, static_cast<int32_t>(n++));
+        }
+    }
+    std::remove(PATH);
+}
+
+TEST(SnapshotTest, StackAndListRoundTrip) {
+    ArrayStack<double, 64> stack;
+    for (int i = 0; i < 40; ++i) {
+        stack.push(i * 1.5);
+    }
+    save_snapshot(PATH, stack);
+    ArrayStack<double, 64> loadedStack;
+    load_snapshot(PATH, loadedStack);
+    EXPECT_TRUE(loadedStack == stack);
+    EXPECT_EQ(loadedStack.top(), 39 * 1.5);
+
+    ArrayStack<double, 16> small;
+    EXPECT_THROW(load_snapshot(PATH, small), std::overflow_error);
+
+    List<int64_t> list;
+    for (int64_t i = 0; i < 10000; ++i) {
+        list.push_back(i * i);
+    }
+    save_snapshot(PATH, list);
+    List<int64_t> loadedList;
+    loadedList.push_back(-1);
+    load_snapshot(PATH, loadedList);
+    ASSERT_EQ(loadedList.size(), 10000);
+    int64_t i = 0;
+    for (auto it = loadedList.begin(); it != loadedList.end(); ++it, ++i) {
+        EXPECT_EQ(*it, i * i);
+    }
+    std::remove(PATH);
+}
+
+TEST(SnapshotTest, EmptySnapshot) {
+    Queue<int> queue;
+    save_snapshot(PATH, queue);
+    Queue<int> loaded;
+    loaded.push(1);
+    load_snapshot(PATH, loaded);
+    EXPECT_TRUE(loaded.empty());
+    std::remove(PATH);
+}
+
+TEST(SnapshotTest, RejectsBadFiles) {
+    std::vector<uint32_t> values(500, 7);
+    save_snapshot(PATH, values.data(), values.size());
+    EXPECT_THROW(SnapshotView<uint64_t> wrongType(PATH), std::runtime_error);
+
+    flip_byte(64 + 100);
+    EXPECT_THROW(SnapshotView<uint32_t> corrupted(PATH), std::runtime_error);
+    EXPECT_NO_THROW(SnapshotView<uint32_t> unchecked(PATH, false));
+
+    {
+        std::ofstream out(PATH, std::ios::binary);
+        out << "not a snapshot at all, just some text that is long enough";
+        out << "to cover the header and then some more bytes";
+    }
+    EXPECT_THROW(SnapshotView<uint32_t> text(PATH), std::runtime_error);
+
+    {
+        // finish() never ran.
+        SnapshotWriter writer(PATH, sizeof(uint32_t), alignof(uint32_t));
+        writer.append(values.data(), values.size());
+    }
+    EXPECT_THROW(SnapshotView<uint32_t> unfinished(PATH), std::runtime_error);
+
+    save_snapshot(PATH, values.data(), values.size());
+    std::vector<char> bytes;
+    {
+        std::ifstream in(PATH, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    {
+        std::ofstream out(PATH, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), bytes.size() - 4);
+    }
+    EXPECT_THROW(SnapshotView<uint32_t> truncated(PATH), std::runtime_error);
+    std::remove(PATH);
+}
+
+TEST(SnapshotTest, ChecksumIgnoresChunking) {
+    std::vector<unsigned char> bytes(1000);
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        bytes[i] = static_cast<unsigned char>(i * 31 + 7);
+    }
+    SnapshotChecksum whole;
+    whole.update(bytes.data(), bytes.size());
+    SnapshotChecksum pieces;
+    size_t offset = 0;
+    for (size_t step = 1; offset < bytes.size(); ++step) {
+        size_t take = step < bytes.size() - offset ? step : bytes.size() - offset;
+        pieces.update(bytes.data() + offset, take);
+        offset += take;
+    }
+    EXPECT_EQ(whole.value(), pieces.value());
+
+    bytes[999] ^= 1;
+    SnapshotChecksum changed;
+    changed.update(bytes.data(), bytes.size());
+    EXPECT_NE(whole.value(), changed.value());
+}
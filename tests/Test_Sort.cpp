@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+#include "sort.h"
+
+namespace {
+
+enum class Distribution { UNIFORM, SORTED, REVERSED, DUPLICATES };
+
+const Distribution ALL_DISTRIBUTIONS[] = {
+    Distribution::UNIFORM, Distribution::SORTED, Distribution::REVERSED, Distribution::DUPLICATES
+};
+
+template<typename T>
+std::vector<T> make_keys(size_t n, Distribution distribution, unsigned seed) {
+    std::mt19937_64 random(seed);
+    std::vector<T> keys(n);
+    for (T& key : keys) {
+        uint64_t bits = random();
+        key = static_cast<T>(distribution == Distribution::DUPLICATES ? bits % 7 : bits);
+    }
+    if (distribution == Distribution::SORTED) {
+        std::sort(keys.begin(), keys.end());
+    }
+    else if (distribution == Distribution::REVERSED) {
+        std::sort(keys.begin(), keys.end(), std::greater<T>());
+    }
+    return keys;
+}
+
+std::vector<std::string> make_strings(size_t n, unsigned seed) {
+    std::mt19937 random(seed);
+    const std::string prefixes[] = { "", "a", "ab", "shared/long/prefix/", "\xff\xfe" };
+    std::vector<std::string> strings(n);
+    for (std::string& s : strings) {
+        s = prefixes[random() % 5];
+        size_t length = random() % 12;
+        for (size_t i = 0; i < length; ++i) {
+            s += static_cast<char>('a' + random() % 4 + (random() % 50 == 0 ? 150 : 0));
+        }
+    }
+    return strings;
+}
+
+template<typename T>
+void expect_radix_matches_std(unsigned seed) {
+    for (Distribution distribution : ALL_DISTRIBUTIONS) {
+        for (size_t n : { 0, 1, 15, 1000, 70000 }) {
+            std::vector<T> keys = make_keys<T>(n, distribution, seed);
+            std::vector<T> expected = keys;
+            std::sort(expected.begin(), expected.end());
+            radix_sort(keys.data(), keys.size());
+            ASSERT_EQ(keys, expected);
+        }
+    }
+}
+
+}  // namespace
+
+TEST(SortTest, InsertionSort) {
+    std::vector<int> keys = { 5, 2, 9, 1, 5, 6 };
+    insertion_sort(keys.data(), keys.data() + keys.size(), std::less<int>());
+    EXPECT_EQ(keys, std::vector<int>({ 1, 2, 5, 5, 6, 9 }));
+}
+
+TEST(SortTest, IntroSortMatchesStdSort) {
+    for (Distribution distribution : ALL_DISTRIBUTIONS) {
+        for (size_t n : { 0, 1, 2, 17, 1000, 100000 }) {
+            std::vector<int> keys = make_keys<int>(n, distribution, 1);
+            std::vector<int> expected = keys;
+            std::sort(expected.begin(), expected.end());
+            intro_sort(keys.data(), keys.data() + keys.size());
+            ASSERT_EQ(keys, expected);
+        }
+    }
+}
+
+TEST(SortTest, IntroSortCustomComparator) {
+    std::vector<double> keys = make_keys<double>(5000, Distribution::UNIFORM, 2);
+    std::vector<double> expected = keys;
+    std::sort(expected.begin(), expected.end(), std::greater<double>());
+    intro_sort(keys.data(), keys.data() + keys.size(), std::greater<double>());
+    EXPECT_EQ(keys, expected);
+}
+
+TEST(SortTest, IntroSortSurvivesMedianOfThreeKiller) {
+    // Organ pipe: ascending then descending, bad for naive median-of-three.
+    std::vector<int> keys(200000);
+    for (size_t i = 0; i < keys.size(); ++i) {
+        keys[i] = static_cast<int>(i < keys.size() / 2 ? i : keys.size() - i);
+    }
+    std::vector<int> expected = keys;
+    std::sort(expected.begin(), expected.end());
+    intro_sort(keys.data(), keys.data() + keys.size());
+    EXPECT_EQ(keys, expected);
+}
+
+TEST(SortTest, RadixSortIntegers) {
+    expect_radix_matches_std<uint32_t>(3);
+    expect_radix_matches_std<uint64_t>(4);
+    expect_radix_matches_std<int32_t>(5);
+    expect_radix_matches_std<int64_t>(6);
+}
+
+TEST(SortTest, RadixSortSignedExtremes) {
+    std::vector<int64_t> keys = { 0, INT64_MIN, -1, INT64_MAX, 1, -2 };
+    radix_sort(keys.data(), keys.size());
+    EXPECT_EQ(keys, std::vector<int64_t>({ INT64_MIN, -2, -1, 0, 1, INT64_MAX }));
+}
+
+TEST(SortTest, RadixSortStrings) {
+    for (size_t n : { 0, 1, 31, 5000, 50000 }) {
+        std::vector<std::string> strings = make_strings(n, static_cast<unsigned>(n));
+        std::vector<std::string> expected = strings;
+        std::sort(expected.begin(), expected.end(),
+                  [](const std::string& a, const std::string& b) {
+                      return std::lexicographical_compare(
+                          a.begin(), a.end(), b.begin(), b.end(),
+                          [](char x, char y) { return static_cast<unsigned char>(x) < static_cast<unsigned char>(y); });
+                  });
+        radix_sort(strings.data(), strings.size());
+        ASSERT_EQ(strings, expected);
+    }
+}
+
+TEST(SortTest, RadixSortLongCommonPrefix) {
+    std::vector<std::string> strings;
+    for (int i = 0; i < 100; ++i) {
+        strings.push_back(std::string(5000, 'x') + std::to_string(i % 10));
+    }
+    std::vector<std::string> expected = strings;
+    std::sort(expected.begin(), expected.end());
+    radix_sort(strings.data(), strings.size());
+    EXPECT_EQ(strings, expected);
+}
+
+TEST(SortTest, ParallelMergeSort) {
+    for (Distribution distribution : ALL_DISTRIBUTIONS) {
+        for (unsigned threads : { 1u, 2u, 3u, 8u }) {
+            std::vector<int64_t> keys = make_keys<int64_t>(300000, distribution, threads);
+            std::vector<int64_t> expected = keys;
+            std::sort(expected.begin(), expected.end());
+            parallel_merge_sort(keys.data(), keys.data() + keys.size(), threads);
+            ASSERT_EQ(keys, expected);
+        }
+    }
+}
+
+TEST(SortTest, ParallelMergeSortStringsWithComparator) {
+    std::vector<std::string> strings = make_strings(100000, 9);
+    std::vector<std::string> expected = strings;
+    std::sort(expected.begin(), expected.end(), std::greater<std::string>());
+    parallel_merge_sort(strings.data(), strings.data() + strings.size(), 5, std::greater<std::string>());
+    EXPECT_EQ(strings, expected);
+}
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <stdexcept>
+#include "spilling_queue.h"
+#include "expect_error.h"
+
+namespace {
+
+const size_t SEGMENT = 64;
+const size_t BUDGET = 4 * SEGMENT * sizeof(uint64_t);
+
+}  // namespace
+
+TEST(SpillingQueueTest, FifoThroughSpilledSegments) {
+    SpillingQueue<uint64_t> queue(".", SEGMENT, BUDGET);
+    EXPECT_TRUE(queue.empty());
+    EXPECT_THROW(queue.front(), std::runtime_error);
+    EXPECT_THROW(queue.pop(), std::runtime_error);
+
+    const uint64_t N = 100 * SEGMENT + 17;
+    for (uint64_t i = 0; i < N; ++i) {
+        queue.push(i);
+        EXPECT_EQ(queue.front(), 0);
+        EXPECT_EQ(queue.back(), i);
+    }
+    EXPECT_EQ(queue.size(), N);
+    EXPECT_GT(queue.stats().segmentsSpilled, 90);
+    EXPECT_GT(queue.stats().segmentsOnDisk, 90);
+    EXPECT_LE(queue.stats().peakResidentBytes, BUDGET);
+
+    for (uint64_t i = 0; i < N; ++i) {
+        ASSERT_EQ(queue.front(), i);
+        queue.pop();
+    }
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(queue.stats().segmentsLoaded, queue.stats().segmentsSpilled);
+    EXPECT_EQ(queue.stats().bytesLoaded, queue.stats().bytesSpilled);
+    EXPECT_EQ(queue.stats().segmentsOnDisk, 0);
+    EXPECT_LE(queue.stats().peakResidentBytes, BUDGET);
+}
+
+TEST(SpillingQueueTest, InterleavedPushAndPop) {
+    SpillingQueue<int32_t> queue(".", 16, 3 * 16 * sizeof(int32_t));
+    int32_t pushed = 0;
+    int32_t popped = 0;
+    for (int round = 0; round < 200; ++round) {
+        int pushes = (round * 7) % 50;
+        int pops = (round * 11) % 45;
+        for (int i = 0; i < pushes; ++i) {
+            queue.push(pushed++);
+        }
+        for (int i = 0; i < pops && !queue.empty(); ++i) {
+            ASSERT_EQ(queue.front(), popped++);
+            queue.pop();
+        }
+        ASSERT_EQ(queue.size(), static_cast<size_t>(pushed - popped));
+        if (!queue.empty()) {
+            ASSERT_EQ(queue.back(), pushed - 1);
+        }
+    }
+    while (!queue.empty()) {
+        ASSERT_EQ(queue.front(), popped++);
+        queue.pop();
+    }
+    EXPECT_EQ(popped, pushed);
+    EXPECT_GT(queue.stats().segmentsSpilled, 0);
+}
+
+TEST(SpillingQueueTest, StaysInMemoryWithinBudget) {
+    SpillingQueue<uint64_t> queue(".", SEGMENT, 100 * SEGMENT * sizeof(uint64_t));
+    for (uint64_t i = 0; i < 50 * SEGMENT; ++i) {
+        queue.push(i);
+    }
+    EXPECT_EQ(queue.stats().segmentsSpilled, 0);
+    EXPECT_EQ(queue.front(), 0);
+}
+
+TEST(SpillingQueueTest, ClearDropsEverything) {
+    SpillingQueue<uint64_t> queue(".", SEGMENT, BUDGET);
+    for (uint64_t i = 0; i < 20 * SEGMENT; ++i) {
+        queue.push(i);
+    }
+    queue.pop();
+    queue.clear();
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(queue.stats().segmentsOnDisk, 0);
+    queue.push(42);
+    EXPECT_EQ(queue.front(), 42);
+    EXPECT_EQ(queue.back(), 42);
+}
+
+TEST(SpillingQueueTest, FailedSpillLeavesQueueUsable) {
+    // The directory does not exist, so every spill fails.
+    SpillingQueue<int32_t> queue("no-such-spill-directory", 4, 2 * 4 * sizeof(int32_t));
+    for (int32_t i = 1; i <= 5; ++i) {
+        queue.push(i);   // head holds 1, the tail 2..5
+    }
+    EXPECT_THROW(queue.push(6), std::runtime_error);
+    EXPECT_THROW(queue.push(6), std::runtime_error);   // retried, not overrun
+    EXPECT_EQ(queue.size(), 5);
+    EXPECT_EQ(queue.back(), 5);
+
+    for (int32_t i = 1; i <= 5; ++i) {
+        ASSERT_EQ(queue.front(), i);
+        queue.pop();
+    }
+    EXPECT_TRUE(queue.empty());
+    queue.push(7);
+    EXPECT_EQ(queue.front(), 7);
+}
+
+TEST(SpillingQueueTest, RejectsTinyBudget) {
+    EXPECT_THROW(SpillingQueue<uint64_t>(".", SEGMENT, SEGMENT * sizeof(uint64_t)), std::invalid_argument);
+    EXPECT_THROW(SpillingQueue<uint64_t>(".", 0, BUDGET), std::invalid_argument);
+}
@@ -2,6 +2,7 @@
 #include <stdexcept>
 #include <string>
 #include "Stack.h"
+#include "expect_error.h"
 
 TEST(ArrayStackTest, DefaultConstructor) {
     ArrayStack<int> stack;
@@ -99,6 +100,22 @@ TEST(ArrayStackTest, PushThrowsWhenFull) {
     EXPECT_THROW(stack.push(3), std::overflow_error);
 }
 
+TEST(ArrayStackTest, TryPushAndTryPop) {
+    ArrayStack<std::string, 2> stack;
+    std::string moved = "b";
+    EXPECT_TRUE(stack.try_push("a"));
+    EXPECT_TRUE(stack.try_push(std::move(moved)));
+    EXPECT_FALSE(stack.try_push("c"));
+    EXPECT_EQ(stack.size(), 2);
+
+    std::string out;
+    EXPECT_TRUE(stack.try_pop(out));
+    EXPECT_EQ(out, "b");
+    EXPECT_EQ(stack.pop_unchecked(), "a");
+    EXPECT_FALSE(stack.try_pop(out));
+    EXPECT_EQ(out, "b");
+}
+
 
 TEST(ArrayStackTest, AtMethod) {
     ArrayStack<int> stack = { 10, 20, 30 };
@@ -179,6 +196,20 @@ TEST(ArrayStackTest, Find) {
     EXPECT_EQ(stack.find(5), -1);
 }
 
+TEST(ArrayStackTest, SearchesLongStack) {
+    ArrayStack<int, 1000> stack;
+    for (int i = 0; i < 1000; ++i) {
+        stack.push(i % 100);
+    }
+
+    EXPECT_EQ(stack.find(99), 0);
+    EXPECT_EQ(stack.find(0), 99);
+    EXPECT_EQ(stack.find(100), -1);
+    EXPECT_EQ(stack.count(7), 10);
+    EXPECT_EQ(&stack.minElement(), &stack[999]);
+    EXPECT_EQ(&stack.maxElement(), &stack[900]);
+}
+
 
 TEST(ArrayStackTest, MinElement) {
     ArrayStack<int> stack = { 5, 2, 8, 1, 9 };
@@ -192,6 +223,16 @@ TEST(ArrayStackTest, MaxElement) {
     EXPECT_EQ(stack.maxElement(), 9);
 }
 
+TEST(ArrayStackTest, MinMaxLeaveContentsAlone) {
+    ArrayStack<int> stack = { 5, 2, 8, 1, 9 };
+    ArrayStack<int> copy = stack;
+
+    stack.minElement();
+    stack.maxElement();
+    EXPECT_TRUE(stack == copy);
+    EXPECT_EQ(stack.at(4), 5);
+}
+
 TEST(ArrayStackTest, MinElementThrowsWhenEmpty) {
     ArrayStack<int> stack;
     EXPECT_THROW(stack.minElement(), std::underflow_error);
@@ -311,3 +352,36 @@ TEST(ArrayStackTest, MoveSemantics) {
     EXPECT_TRUE(str.empty());
     EXPECT_EQ(stack.top(), "test");
 }
+
+#if defined(ASD_CONSTEXPR_ARRAY_STACK)
+
+namespace {
+
+// Pushes 1..n, pops the top one back off and sums what is left.
+constexpr int sum_after_pop(int n) {
+    ArrayStack<int, 16> stack(ZeroFilled{});
+    for (int i = 1; i <= n; ++i) {
+        stack.push(i);
+    }
+    ArrayStack<int, 16> copy(ZeroFilled{});
+    copy = stack;
+    copy.pop();
+    int sum = 0;
+    while (!copy.isEmpty()) {
+        sum += copy.pop();
+    }
+    return sum;
+}
+
+constexpr ArrayStack<char, 4> LETTERS(ZeroFilled{}, { 'a', 'b', 'c' });
+
+}  // namespace
+
+TEST(ArrayStackTest, UsableInConstantExpressions) {
+    static_assert(sum_after_pop(5) == 10, "1 + 2 + 3 + 4");
+    static_assert(LETTERS.size() == 3 && LETTERS.top() == 'c', "top is the last pushed");
+    static_assert(LETTERS.at(2) == 'a' && !LETTERS.isFull(), "at() counts from the top");
+    EXPECT_EQ(sum_after_pop(5), 10);
+}
+
+#endif
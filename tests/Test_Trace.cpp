@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+#include "replay.h"
+#include "trace.h"
+#include "expect_error.h"
+
+namespace {
+
+const char* PATH = "trace_test.tmp";
+
+bool same(const std::vector<TraceRecord>& a, const std::vector<TraceRecord>& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].op != b[i].op || a[i].position != b[i].position || a[i].payload != b[i].payload) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void write_text(const char* contents) {
+    std::ofstream out(PATH, std::ios::binary | std::ios::trunc);
+    out << contents;
+}
+
+}  // namespace
+
+TEST(TraceTest, TextAndBinaryRoundTrip) {
+    std::vector<TraceRecord> trace = {
+        { TraceOp::PUSH, 0, 16 }, { TraceOp::PUSH, 0, 300000 }, { TraceOp::FRONT, 0, 0 },
+        { TraceOp::INSERT, 1, 7 }, { TraceOp::ERASE, 2, 0 }, { TraceOp::SORT, 0, 0 },
+        { TraceOp::POP, 0, 0 }
+    };
+    write_trace_text(PATH, trace);
+    EXPECT_TRUE(same(read_trace(PATH), trace));
+    write_trace_binary(PATH, trace);
+    EXPECT_TRUE(same(read_trace(PATH), trace));
+    std::remove(PATH);
+}
+
+TEST(TraceTest, TextAllowsCommentsAndRejectsGarbage) {
+    write_text("# warm-up\npush 8\n\n  pop   # drain\n");
+    std::vector<TraceRecord> trace = read_trace(PATH);
+    ASSERT_EQ(trace.size(), 2);
+    EXPECT_EQ(trace[0].payload, 8);
+    EXPECT_EQ(trace[1].op, TraceOp::POP);
+
+    write_text("push 8\nshuffle\n");
+    EXPECT_THROW(read_trace(PATH), std::runtime_error);
+    write_text("insert 3\n");   // payload missing
+    EXPECT_THROW(read_trace(PATH), std::runtime_error);
+    write_text("pop 1\n");
+    EXPECT_THROW(read_trace(PATH), std::runtime_error);
+    std::remove(PATH);
+    EXPECT_THROW(read_trace(PATH), std::runtime_error);
+}
+
+TEST(TraceTest, GeneratorIsDeterministicAndNeverUnderflows) {
+    const TracePattern patterns[] = { TracePattern::STEADY, TracePattern::BURST, TracePattern::RANDOM_EDIT };
+    for (TracePattern pattern : patterns) {
+        TraceProfile profile = { pattern, PayloadDistribution::EXPONENTIAL, 20000, 32, 7 };
+        std::vector<TraceRecord> trace = generate_trace(profile);
+        ASSERT_EQ(trace.size(), 20000);
+        EXPECT_TRUE(same(trace, generate_trace(profile)));
+        profile.seed = 8;
+        EXPECT_FALSE(same(trace, generate_trace(profile)));
+
+        size_t size = 0;
+        for (const TraceRecord& record : trace) {
+            if (record.op == TraceOp::PUSH || record.op == TraceOp::INSERT) {
+                EXPECT_GE(record.payload, 1);
+                EXPECT_LE(record.payload, 64 * 32);
+                EXPECT_LE(record.position, size);
+                ++size;
+            }
+            else {
+                ASSERT_GT(size, 0);
+                if (record.op == TraceOp::ERASE) {
+                    EXPECT_LT(record.position, size);
+                }
+                if (record.op == TraceOp::POP || record.op == TraceOp::ERASE) {
+                    --size;
+                }
+            }
+        }
+    }
+}
+
+TEST(TraceTest, PercentilesUseNearestRank) {
+    std::vector<uint32_t> samples;
+    for (uint32_t i = 1000; i >= 1; --i) {
+        samples.push_back(i);
+    }
+    LatencySummary summary = summarize_latencies(samples);
+    EXPECT_EQ(summary.count, 1000);
+    EXPECT_EQ(summary.p50, 500);
+    EXPECT_EQ(summary.p99, 990);
+    EXPECT_EQ(summary.p999, 999);
+    EXPECT_EQ(summary.max, 1000);
+
+    std::vector<uint32_t> empty;
+    EXPECT_EQ(summarize_latencies(empty).p99, 0);
+}
+
+TEST(TraceTest, ReplayCountsSkippedOperations) {
+    std::vector<TraceRecord> trace = {
+        { TraceOp::POP, 0, 0 }, { TraceOp::PUSH, 0, 4 }, { TraceOp::INSERT, 0, 4 },
+        { TraceOp::SORT, 0, 0 }, { TraceOp::FRONT, 0, 0 }, { TraceOp::ERASE, 5, 0 },
+        { TraceOp::POP, 0, 0 }, { TraceOp::POP, 0, 0 }
+    };
+    ReplayResult queue = replay_trace(trace, "queue");
+    EXPECT_EQ(queue.operations, 3);   // push, front, one pop
+    EXPECT_EQ(queue.skipped, 5);
+    EXPECT_EQ(queue.perOp[static_cast<size_t>(TraceOp::POP)].count, 1);
+
+    for (const char* name : { "list", "std-list", "std-deque", "std-vector" }) {
+        ReplayResult result = replay_trace(trace, name);
+        EXPECT_EQ(result.operations, 6) << name;   // all but the pops on an empty container
+        EXPECT_EQ(result.overall.count, 6) << name;
+        EXPECT_GT(result.peakRssBytes, 0) << name;
+    }
+    EXPECT_THROW(replay_trace(trace, "heap"), std::invalid_argument);
+}
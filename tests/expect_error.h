@@ -0,0 +1,22 @@
+#ifndef EXPECT_ERROR_H
+#define EXPECT_ERROR_H
+
+#include <gtest/gtest.h>
+#include "error_policy.h"
+
+// Built without exceptions (BNO_EXCEPTIONS) the libraries abort where they
+// would throw, so the throw expectations turn into death tests.
+#if !ASD_EXCEPTIONS
+#undef EXPECT_THROW
+#undef EXPECT_ANY_THROW
+#undef EXPECT_NO_THROW
+#undef ASSERT_ANY_THROW
+#undef ASSERT_NO_THROW
+#define EXPECT_THROW(statement, exception) EXPECT_DEATH(statement, "")
+#define EXPECT_ANY_THROW(statement) EXPECT_DEATH(statement, "")
+#define EXPECT_NO_THROW(statement) do { statement; } while (false)
+#define ASSERT_ANY_THROW(statement) ASSERT_DEATH(statement, "")
+#define ASSERT_NO_THROW(statement) do { statement; } while (false)
+#endif
+
+#endif
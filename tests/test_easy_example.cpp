@@ -1,7 +1,12 @@
 // Copyright 2024 Marina Usova
 
 #include <gtest/gtest.h>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
 #include "../lib_easy_example/easy_example.h"
+#include "expect_error.h"
 
 #define EPSILON 0.000001
 
@@ -48,3 +53,75 @@ TEST(TestEasyExampleLib, throw_when_try_div_by_zero) {
   // Act & Assert
   ASSERT_ANY_THROW(division(x, y));
 }
+
+TEST(TestEasyExampleLib, batch_matches_division_on_every_kernel) {
+  // Arrange: 203 pairs, so the last block is partial.
+  std::vector<int> a, b;
+  for (int i = 0; i < 203; ++i) {
+    a.push_back(i * 7919 - 800000);
+    b.push_back(i % 50 == 3 ? 0 : i * 31 - 3000);
+  }
+
+  for (DivisionKernel kernel : { DivisionKernel::SCALAR, DivisionKernel::SSE2,
+                                 DivisionKernel::AVX2, DivisionKernel::AUTO }) {
+    if (!division_kernel_supported(kernel)) {
+      continue;
+    }
+    // Act
+    std::vector<float> out(a.size());
+    std::vector<uint64_t> errors(4, ~uint64_t(0));
+    size_t zeros = division_batch(a.data(), b.data(), out.data(), a.size(), errors.data(), kernel);
+
+    // Assert
+    EXPECT_EQ(zeros, 4u);
+    for (size_t i = 0; i < a.size(); ++i) {
+      bool flagged = (errors[i / 64] >> (i % 64)) & 1;
+      if (b[i] == 0) {
+        EXPECT_TRUE(std::isnan(out[i]));
+        EXPECT_TRUE(flagged);
+      }
+      else {
+        EXPECT_EQ(out[i], division(a[i], b[i]));
+        EXPECT_FALSE(flagged);
+      }
+    }
+  }
+}
+
+TEST(TestEasyExampleLib, batch_does_not_need_an_error_mask) {
+  // Arrange
+  int a[3] = { 1, 2, 3 };
+  int b[3] = { 0, 4, 0 };
+  float out[3];
+
+  // Act & Assert
+  EXPECT_EQ(division_batch(a, b, out, 3), 2u);
+  EXPECT_NEAR(out[1], 0.5, EPSILON);
+  EXPECT_EQ(division_batch(a, b, out, 0), 0u);
+}
+
+TEST(TestEasyExampleLib, parallel_batch_matches_single_thread) {
+  // Arrange: enough pairs for four threads, with an uneven tail.
+  size_t n = DIVISION_MIN_PER_THREAD * 4 + 77;
+  std::vector<int> a(n), b(n);
+  for (size_t i = 0; i < n; ++i) {
+    a[i] = static_cast<int>(i);
+    b[i] = static_cast<int>(i % 1000) - 500;
+  }
+  std::vector<float> expected(n), actual(n);
+  std::vector<uint64_t> expectedErrors((n + 63) / 64), actualErrors((n + 63) / 64);
+
+  // Act
+  size_t expectedZeros = division_batch(a.data(), b.data(), expected.data(), n, expectedErrors.data());
+  size_t actualZeros = division_batch_parallel(a.data(), b.data(), actual.data(), n,
+                                               actualErrors.data(), 4);
+
+  // Assert
+  EXPECT_EQ(actualZeros, expectedZeros);
+  EXPECT_EQ(actualErrors, expectedErrors);
+  for (size_t i = 0; i < n; ++i) {
+    if (b[i] != 0) {
+      ASSERT_EQ(actual[i], expected[i]);
+    }
+  }
+}